@@ -2,3 +2,7 @@ cd eth_in
 source build.tcl
 cd ../eth_out
 source build.tcl
+cd ../tx_dma
+source build.tcl
+cd ../rx_dma
+source build.tcl
@@ -0,0 +1,127 @@
+# Block design hierarchies that move the payload streams of eth_in and eth_out
+# into a clock domain of their own. The cores stay on the clock of the PHY,
+# 50 MHz for RMII and 125 MHz for GMII, behind asynchronous FIFOs the user
+# logic may run at any clock, e.g. 200 MHz. The core converts between the
+# symbols of the PHY and words itself, so the width of the user logic is
+# picked by the variant of the IP (see the build.tcl of each core):
+# eth_in_4byte and eth_out_4byte for a 32 bit datapath, eth_in_8byte and
+# eth_out_8byte for a 64 bit one.
+#
+# Source this in Vivado once the IPs are built into ../../ip and add the
+# hierarchies to a block design, e.g.
+#   source cdc.tcl
+#   create_hier_cell_eth_in_cdc / eth_in eth_in_8byte
+#   create_hier_cell_eth_out_cdc / eth_out eth_out_8byte
+# Each hierarchy takes phy_clk and phy_resetn for the core and user_clk for the
+# streams of the user logic. The FIFOs are reset from their write side, so the
+# one of eth_out also takes user_resetn. All other ports of the core are passed
+# on unchanged and stay in the domain of the PHY. cdc_check.tcl builds block
+# designs of the hierarchies and validates them.
+
+# Depth of the asynchronous FIFOs in words
+set cdc_fifo_depth 32
+
+# Creates the hierarchy nameHier in parentCell around the IP ip_name. The
+# streams of user_streams cross into the user domain, to the core if to_core
+# is set and from it otherwise. Streams the variant of the core lacks are
+# left out.
+proc create_hier_cell_eth_cdc {parentCell nameHier ip_name user_streams
+                               to_core} {
+  global cdc_fifo_depth
+
+  set parentObj [get_bd_cells $parentCell]
+  if {$parentObj eq "" || [get_property TYPE $parentObj] ne "hier"} {
+    puts "ERROR: $parentCell is no hierarchical cell"
+    return
+  }
+  set oldCurInst [current_bd_instance .]
+  current_bd_instance $parentObj
+  current_bd_instance [create_bd_cell -type hier $nameHier]
+
+  create_bd_pin -dir I -type clk phy_clk
+  create_bd_pin -dir I -type rst phy_resetn
+  create_bd_pin -dir I -type clk user_clk
+  if {$to_core} {
+    create_bd_pin -dir I -type rst user_resetn
+  }
+
+  set core [create_bd_cell -type ip -vlnv ME:eth:$ip_name:1.0.0 core]
+
+  # The core is reset at high level (see config_rtl in build.tcl)
+  set phy_reset [create_bd_cell -type ip \
+                     -vlnv xilinx.com:ip:util_vector_logic:2.0 phy_reset]
+  set_property -dict [list CONFIG.C_OPERATION {not} CONFIG.C_SIZE {1}] \
+      $phy_reset
+  connect_bd_net [get_bd_pins phy_resetn] [get_bd_pins phy_reset/Op1]
+  connect_bd_net [get_bd_pins phy_reset/Res] [get_bd_pins core/ap_rst]
+  connect_bd_net [get_bd_pins phy_clk] [get_bd_pins core/ap_clk]
+
+  foreach stream $user_streams {
+    if {[get_bd_intf_pins -quiet core/$stream] eq ""} {
+      continue
+    }
+    set fifo [create_bd_cell -type ip \
+                  -vlnv xilinx.com:ip:axis_data_fifo:2.0 ${stream}_fifo]
+    set_property -dict [list CONFIG.IS_ACLK_ASYNC {1} \
+                            CONFIG.FIFO_DEPTH $cdc_fifo_depth] $fifo
+    if {$to_core} {
+      create_bd_intf_pin -mode Slave \
+          -vlnv xilinx.com:interface:axis_rtl:1.0 $stream
+      connect_bd_intf_net [get_bd_intf_pins $stream] \
+          [get_bd_intf_pins $fifo/S_AXIS]
+      connect_bd_intf_net [get_bd_intf_pins $fifo/M_AXIS] \
+          [get_bd_intf_pins core/$stream]
+      connect_bd_net [get_bd_pins user_clk] [get_bd_pins $fifo/s_axis_aclk]
+      connect_bd_net [get_bd_pins user_resetn] \
+          [get_bd_pins $fifo/s_axis_aresetn]
+      connect_bd_net [get_bd_pins phy_clk] [get_bd_pins $fifo/m_axis_aclk]
+    } else {
+      create_bd_intf_pin -mode Master \
+          -vlnv xilinx.com:interface:axis_rtl:1.0 $stream
+      connect_bd_intf_net [get_bd_intf_pins core/$stream] \
+          [get_bd_intf_pins $fifo/S_AXIS]
+      connect_bd_intf_net [get_bd_intf_pins $fifo/M_AXIS] \
+          [get_bd_intf_pins $stream]
+      connect_bd_net [get_bd_pins phy_clk] [get_bd_pins $fifo/s_axis_aclk]
+      connect_bd_net [get_bd_pins phy_resetn] \
+          [get_bd_pins $fifo/s_axis_aresetn]
+      connect_bd_net [get_bd_pins user_clk] [get_bd_pins $fifo/m_axis_aclk]
+    }
+  }
+
+  foreach pin [get_bd_intf_pins -of_objects $core] {
+    set name [get_property NAME $pin]
+    if {[lsearch -exact $user_streams $name] < 0} {
+      create_bd_intf_pin -mode [get_property MODE $pin] \
+          -vlnv [get_property VLNV $pin] $name
+      connect_bd_intf_net [get_bd_intf_pins $name] $pin
+    }
+  }
+  foreach pin [get_bd_pins -of_objects $core] {
+    set name [get_property NAME $pin]
+    if {[lsearch -exact {ap_clk ap_rst} $name] < 0} {
+      set left [get_property LEFT $pin]
+      if {$left eq ""} {
+        create_bd_pin -dir [get_property DIR $pin] $name
+      } else {
+        create_bd_pin -dir [get_property DIR $pin] -from $left \
+            -to [get_property RIGHT $pin] $name
+      }
+      connect_bd_net [get_bd_pins $name] $pin
+    }
+  }
+
+  current_bd_instance $oldCurInst
+}
+
+# eth_in with data_out in the user domain
+proc create_hier_cell_eth_in_cdc {parentCell nameHier ip_name} {
+  create_hier_cell_eth_cdc $parentCell $nameHier $ip_name {data_out} 0
+}
+
+# eth_out with data_in and, for the cut-through variants, desc_in in the user
+# domain
+proc create_hier_cell_eth_out_cdc {parentCell nameHier ip_name} {
+  create_hier_cell_eth_cdc $parentCell $nameHier $ip_name \
+      {data_in desc_in} 1
+}
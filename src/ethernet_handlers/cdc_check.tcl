@@ -0,0 +1,89 @@
+# Checks the hierarchies of cdc.tcl. For each pair of IP variants below it
+# builds a block design of eth_in and eth_out behind their FIFOs and validates
+# it. eth_in hands its ARP packets and echo requests to eth_out as in a
+# complete design. All other ports of the hierarchies become ports of the
+# design, each in the clock domain of its hierarchy pin.
+#
+# Run this in Vivado from this directory once the IPs are built into ../ip
+# (see build.tcl), e.g.
+#   vivado -mode batch -source cdc_check.tcl
+# The run fails at the first design that does not validate.
+
+# eth_in and eth_out variant of each design and the clock of their PHY in Hz
+set cdc_check_pairs {
+  eth_in eth_out 50000000
+  eth_in_cut_through eth_out_cut_through 50000000
+  eth_in_8byte eth_out_8byte 50000000
+  eth_in_gmii eth_out_gmii 125000000
+}
+
+# Clock of the user logic in Hz
+set cdc_check_user_clk_hz 200000000
+
+# Streams of the hierarchies in the user domain
+set cdc_check_user_streams {data_out data_in desc_in}
+
+create_project -in_memory -part xc7a100tcsg324-1
+set_property ip_repo_paths ../ip [current_project]
+update_ip_catalog
+source cdc.tcl
+
+foreach {in_ip out_ip phy_clk_hz} $cdc_check_pairs {
+  create_bd_design cdc_check_$in_ip
+  create_hier_cell_eth_in_cdc / eth_in $in_ip
+  create_hier_cell_eth_out_cdc / eth_out $out_ip
+
+  create_bd_port -dir I -type clk -freq_hz $phy_clk_hz phy_clk
+  create_bd_port -dir I -type clk -freq_hz $cdc_check_user_clk_hz user_clk
+  create_bd_port -dir I -type rst phy_resetn
+  create_bd_port -dir I -type rst user_resetn
+  set_property CONFIG.POLARITY ACTIVE_LOW \
+      [get_bd_ports {phy_resetn user_resetn}]
+  foreach hier {eth_in eth_out} {
+    connect_bd_net [get_bd_ports phy_clk] [get_bd_pins $hier/phy_clk]
+    connect_bd_net [get_bd_ports phy_resetn] [get_bd_pins $hier/phy_resetn]
+    connect_bd_net [get_bd_ports user_clk] [get_bd_pins $hier/user_clk]
+  }
+  connect_bd_net [get_bd_ports user_resetn] [get_bd_pins eth_out/user_resetn]
+
+  connect_bd_intf_net [get_bd_intf_pins eth_in/arp_out] \
+      [get_bd_intf_pins eth_out/arp_in]
+  connect_bd_intf_net [get_bd_intf_pins eth_in/icmp_out] \
+      [get_bd_intf_pins eth_out/icmp_in]
+
+  set phy_busif {}
+  set user_busif {}
+  foreach hier {eth_in eth_out} {
+    foreach pin [get_bd_intf_pins -of_objects [get_bd_cells $hier]] {
+      set name [get_property NAME $pin]
+      if {[lsearch -exact {arp_out arp_in icmp_out icmp_in} $name] >= 0} {
+        continue
+      }
+      # The port takes over the protocol and widths of the core
+      make_bd_intf_pins_external $pin
+      set port [get_bd_intf_ports -of_objects \
+                    [get_bd_intf_nets -of_objects $pin]]
+      if {[lsearch -exact $cdc_check_user_streams $name] >= 0} {
+        set_property CONFIG.FREQ_HZ $cdc_check_user_clk_hz $port
+        lappend user_busif [get_property NAME $port]
+      } else {
+        set_property CONFIG.FREQ_HZ $phy_clk_hz $port
+        lappend phy_busif [get_property NAME $port]
+      }
+    }
+    foreach pin [get_bd_pins -of_objects [get_bd_cells $hier]] {
+      set name [get_property NAME $pin]
+      if {[lsearch -exact {phy_clk phy_resetn user_clk user_resetn} \
+               $name] < 0} {
+        make_bd_pins_external $pin
+      }
+    }
+  }
+  set_property CONFIG.ASSOCIATED_BUSIF [join $phy_busif :] \
+      [get_bd_ports phy_clk]
+  set_property CONFIG.ASSOCIATED_BUSIF [join $user_busif :] \
+      [get_bd_ports user_clk]
+
+  validate_bd_design
+  close_bd_design [current_bd_design]
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ARPPacketHandler.hpp"
+
+void ARPPacketHandler::handle(const Optional<byte_word> &word) {
+#pragma HLS INLINE
+
+  if (word.is_none() || this->cnt == ARP_PKT_BYTE_SIZE) {
+    return;
+  }
+
+  ap_uint<8> data = word.some.data;
+  if (this->cnt < 6) {
+    this->arp_pkt_header = (this->arp_pkt_header << 8) | data;
+  } else if (this->cnt < 8) {
+    this->arp_pkt_operation = (this->arp_pkt_operation << 8) | data;
+  } else if (this->cnt < 14) {
+    this->arp_pkt_sender_mac_addr = (this->arp_pkt_sender_mac_addr << 8) | data;
+  } else if (this->cnt < 18) {
+    this->arp_pkt_sender_ip_addr = (this->arp_pkt_sender_ip_addr << 8) | data;
+  } else if (this->cnt >= 24) {
+    // The target MAC address is not of interest
+    this->arp_pkt_target_ip_addr = (this->arp_pkt_target_ip_addr << 8) | data;
+  }
+  this->cnt++;
+}
+
+ap_uint<1> ARPPacketHandler::received() const {
+#pragma HLS INLINE
+
+  return this->cnt == ARP_PKT_BYTE_SIZE &&
+         this->arp_pkt_header == ARP_IPV4_OVER_ETHERNET &&
+         (this->arp_pkt_operation == ARP_REQUEST ||
+          this->arp_pkt_operation == ARP_REPLY);
+}
+
+ARPEvent ARPPacketHandler::get_event() const {
+#pragma HLS INLINE
+
+  return {this->arp_pkt_operation,
+          this->arp_pkt_sender_mac_addr,
+          this->arp_pkt_sender_ip_addr,
+          this->arp_pkt_target_ip_addr,
+          {0, 0}};
+}
+
+void ARPPacketHandler::reset() { this->cnt = 0; }
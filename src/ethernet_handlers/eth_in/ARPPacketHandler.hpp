@@ -27,31 +27,33 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef ETH_PACKET_WORD_GENERATOR
-#define ETH_PACKET_WORD_GENERATOR
+#ifndef ARP_PACKET_HANDLER_HPP
+#define ARP_PACKET_HANDLER_HPP
 #pragma once
 
-#include "../utils/Addresses.hpp"
+#include "../utils/ARPEvent.hpp"
+#include "../utils/Optional.hpp"
 #include "../utils/axis_word.hpp"
 #include "../utils/protocols.hpp"
-#include "IPPacketWordGenerator.hpp"
-#include "Meta.hpp"
-#include "counted.hpp"
 #include <ap_int.h>
-#include <hls_stream.h>
 
-class ETHPacketWordGenerator {
+// Collects the fields of an ARP packet. The fields are shifted in byte by
+// byte, the padding behind the packet is ignored.
+class ARPPacketHandler {
 public:
-  ETHPacketWordGenerator() : word_cnt(0) {}
-  axis_word get_next_word(const Addresses &loc,
-                          const Meta &meta,
-                          hls::stream<axis_word> &buffer);
+  ARPPacketHandler() : cnt(0) {}
+  void handle(const Optional<byte_word> &word);
+  ap_uint<1> received() const;
+  ARPEvent get_event() const;
   void reset();
 
 private:
-  ap_uint<5> word_cnt;
-  ap_uint<16> frm_protocol;
-  IPPacketWordGenerator ipPacketWordGenerator;
+  ap_uint<5> cnt;
+  ap_uint<48> arp_pkt_header;
+  ap_uint<16> arp_pkt_operation;
+  ap_uint<48> arp_pkt_sender_mac_addr;
+  ap_uint<32> arp_pkt_sender_ip_addr;
+  ap_uint<32> arp_pkt_target_ip_addr;
 };
 
 #endif
@@ -35,17 +35,23 @@ AxisWordGenerator::next(const Optional<ap_uint<8> > &data,
 #pragma HLS INLINE
 
   Optional<axis_word> ret;
-  if (this->data_valid) {
-    this->data_valid = false;
-    ret = {Some, {this->data, !crsdv, 0}};
+  if (this->byte_cnt == DATAPATH_BYTES || (!crsdv && this->byte_cnt != 0)) {
+    this->word.last = !crsdv;
+    ret = {Some, this->word};
+    this->byte_cnt = 0;
   } else {
-    ret = NOTHING;
+    ret = NO_WORD;
   }
   if (data.is_some()) {
-    this->data = data.some;
-    this->data_valid = true;
+    if (this->byte_cnt == 0) {
+      this->word.data = 0;
+      this->word.keep = 0;
+    }
+    this->word.set_byte(this->byte_cnt, data.some);
+    this->word.keep[this->byte_cnt] = 1;
+    this->byte_cnt++;
   }
   return ret;
 }
 
-void AxisWordGenerator::reset() { this->data_valid = false; }
+void AxisWordGenerator::reset() { this->byte_cnt = 0; }
@@ -35,16 +35,19 @@
 #include "../utils/axis_word.hpp"
 #include <ap_int.h>
 
+// Packs the received bytes into words of DATAPATH_BYTES bytes. A word is
+// passed on one cycle after its last byte arrived, when it is known whether
+// the frame ended with it.
 class AxisWordGenerator {
 public:
-  AxisWordGenerator() : data_valid(false) {}
+  AxisWordGenerator() : byte_cnt(0) {}
   Optional<axis_word> next(const Optional<ap_uint<8> > &data,
                            const ap_uint<2> &crsdv);
   void reset();
 
 private:
-  ap_uint<8> data;
-  ap_uint<1> data_valid;
+  axis_word word;
+  ap_uint<bit_width<DATAPATH_BYTES>::value> byte_cnt;
 };
 
 #endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "DataAligner.hpp"
+
+ap_uint<DATAPATH_BYTES>
+get_keep(const ap_uint<bit_width<DATAPATH_BYTES>::value> &num_bytes) {
+#pragma HLS INLINE
+
+  ap_uint<DATAPATH_BYTES + 1> ret = 1;
+  ret <<= num_bytes;
+  return ret - 1;
+}
+
+Optional<axis_word> DataAligner::align(const Optional<axis_word> &payload,
+                                       ap_uint<1> &frame_end,
+                                       ap_uint<1> &bad_data) {
+#pragma HLS INLINE
+
+  if (this->rest_pending) {
+    // The payload of the next frame has to pass its headers first, so
+    // nothing else can arrive in this cycle.
+    axis_word ret_word(this->rest.data,
+                       get_keep(this->rest_cnt),
+                       true,
+                       this->rest.user);
+    if (this->rest_frame_end) {
+      frame_end = true;
+      bad_data = this->rest_bad_data;
+    }
+    this->rest.data = 0;
+    this->rest_cnt = 0;
+    this->rest_pending = false;
+    return {Some, ret_word};
+  }
+
+  ap_uint<bit_width<DATAPATH_BYTES>::value> first_lane = 0;
+  ap_uint<bit_width<DATAPATH_BYTES>::value> num_bytes = 0;
+  if (payload.is_some()) {
+    for (int i = DATAPATH_BYTES - 1; i >= 0; i--) {
+#pragma HLS UNROLL
+      if (payload.some.keep[i]) {
+        first_lane = i;
+      }
+    }
+    num_bytes = payload.some.num_bytes();
+    this->rest.user = payload.some.user;
+  }
+
+  ap_uint<16 * DATAPATH_BYTES> joined = payload.some.data >> (8 * first_lane);
+  if (payload.is_none()) {
+    joined = 0;
+  }
+  joined <<= 8 * this->rest_cnt;
+  joined |= this->rest.data;
+  ap_uint<bit_width<2 * DATAPATH_BYTES>::value> total =
+      this->rest_cnt + num_bytes;
+  ap_uint<1> end = frame_end || (payload.is_some() && payload.some.last);
+
+  if (total >= DATAPATH_BYTES) {
+    axis_word ret_word(joined(8 * DATAPATH_BYTES - 1, 0),
+                       get_keep(DATAPATH_BYTES),
+                       end && total == DATAPATH_BYTES,
+                       this->rest.user);
+    this->rest.data = joined >> (8 * DATAPATH_BYTES);
+    this->rest_cnt = total - DATAPATH_BYTES;
+    if (end && total != DATAPATH_BYTES) {
+      this->rest_pending = true;
+      this->rest_frame_end = frame_end;
+      this->rest_bad_data = bad_data;
+      frame_end = false;
+    }
+    return {Some, ret_word};
+  }
+
+  this->rest.data = joined(8 * DATAPATH_BYTES - 1, 0);
+  this->rest_cnt = total;
+  if (end && total != 0) {
+    axis_word ret_word(this->rest.data,
+                       get_keep(total),
+                       true,
+                       this->rest.user);
+    this->rest.data = 0;
+    this->rest_cnt = 0;
+    return {Some, ret_word};
+  }
+  return NO_WORD;
+}
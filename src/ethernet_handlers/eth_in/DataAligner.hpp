@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DATA_ALIGNER_HPP
+#define DATA_ALIGNER_HPP
+#pragma once
+
+#include "../utils/Optional.hpp"
+#include "../utils/axis_word.hpp"
+#include <ap_int.h>
+
+// Moves the payload bytes, which keep the lanes they were received in, to the
+// front of the words, so that only the last word of a payload is partially
+// filled. If the remaining bytes do not fit into the last word, they follow
+// one cycle later and a frame_end arriving with them is delayed as well.
+class DataAligner {
+public:
+  DataAligner() : rest_cnt(0), rest_pending(false) {}
+  Optional<axis_word> align(const Optional<axis_word> &payload,
+                            ap_uint<1> &frame_end,
+                            ap_uint<1> &bad_data);
+
+private:
+  axis_word rest;
+  ap_uint<bit_width<DATAPATH_BYTES>::value> rest_cnt;
+  ap_uint<1> rest_pending;
+  ap_uint<1> rest_frame_end;
+  ap_uint<1> rest_bad_data;
+};
+
+#endif
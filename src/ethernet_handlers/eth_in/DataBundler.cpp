@@ -29,17 +29,18 @@
 
 #include "DataBundler.hpp"
 
-Optional<ap_uint<8> > DataBundler::bundle(const ap_uint<2> &rxd) {
+Optional<ap_uint<8> > DataBundler::bundle(const phy_data &rxd) {
 #pragma HLS INLINE
 
-  this->data(2 * pair_cnt + 1, 2 * pair_cnt) = rxd;
-  if (this->pair_cnt == 3) {
-    this->pair_cnt++;
+  this->data(PHY_DATA_WIDTH * symbol_cnt + PHY_DATA_WIDTH - 1,
+             PHY_DATA_WIDTH * symbol_cnt) = rxd;
+  if (this->symbol_cnt == PHY_CYCLES_PER_BYTE - 1) {
+    this->symbol_cnt = 0;
     return {Some, this->data};
   }
 
-  this->pair_cnt++;
+  this->symbol_cnt++;
   return {None, 0};
 }
 
-void DataBundler::reset() { this->pair_cnt = 0; }
+void DataBundler::reset() { this->symbol_cnt = 0; }
@@ -32,17 +32,19 @@
 #pragma once
 
 #include "../utils/Optional.hpp"
+#include "../utils/phy.hpp"
 #include <ap_int.h>
 
+// Assembles the symbols of rxd into bytes, least significant bits first
 class DataBundler {
 public:
-  DataBundler() : pair_cnt(0) {}
-  Optional<ap_uint<8> > bundle(const ap_uint<2> &rxd);
+  DataBundler() : symbol_cnt(0) {}
+  Optional<ap_uint<8> > bundle(const phy_data &rxd);
   void reset();
 
 private:
   ap_uint<8> data;
-  ap_uint<2> pair_cnt;
+  ap_uint<2> symbol_cnt;
 };
 
 #endif
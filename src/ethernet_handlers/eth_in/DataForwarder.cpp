@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "DataForwarder.hpp"
+
+void DataForwarder::handle(const Optional<axis_word> &payload,
+                           const ap_uint<1> &frame_end,
+                           const ap_uint<1> &bad_data,
+                           hls::stream<axis_word> &data_out) {
+#pragma HLS INLINE
+
+  Optional<axis_word> out = NO_WORD;
+  if (this->tail_pending) {
+    // The frame ended together with a new word in the previous cycle, so its
+    // last word could not be written yet.
+    out = {Some, this->held};
+    this->held_valid = false;
+    this->tail_pending = false;
+  } else if (payload.is_some()) {
+    if (this->held_valid) {
+      out = {Some, this->held};
+    }
+    this->held = payload.some;
+    this->held_valid = true;
+  }
+
+  if (frame_end && this->held_valid && !this->tail_pending) {
+    // A frame that stops before the announced end of its payload is bad as
+    // well, the held word gets terminated anyway.
+    this->held.user[USER_ERROR_BIT] = bad_data || !this->held.last;
+    this->held.last = true;
+    if (out.is_some()) {
+      this->tail_pending = true;
+    } else {
+      out = {Some, this->held};
+      this->held_valid = false;
+    }
+  }
+
+  if (out.is_some()) {
+    data_out.write(out.some);
+  }
+}
@@ -27,36 +27,31 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef UDP_PACKET_WORD_GENERATOR
-#define UDP_PACKET_WORD_GENERATOR
+#ifndef DATA_FORWARDER_HPP
+#define DATA_FORWARDER_HPP
 #pragma once
 
-#include "../utils/Addresses.hpp"
+#include "../utils/Optional.hpp"
 #include "../utils/axis_word.hpp"
-#include "../utils/checksums/Checksum.hpp"
-#include "Meta.hpp"
-#include "PayloadWordGenerator.hpp"
 #include <ap_int.h>
 #include <hls_stream.h>
 
-const int MIN_UDP_PAYLOAD_BYTE_SIZE = 18;
-const int UDP_PKT_HEADER_BYTE_SIZE = 8;
-
-class UDPPacketWordGenerator {
+// Cut-through counterpart of FrameBuffer. Payload words are passed on as soon
+// as they are parsed. The most recent word is held back until the next one
+// arrives, so that the word ending the frame can carry the verdict of the
+// frame checks in its user field.
+class DataForwarder {
 public:
-  UDPPacketWordGenerator()
-      : word_cnt(0), payloadWordGenerator(MIN_UDP_PAYLOAD_BYTE_SIZE) {}
-  axis_word get_next_word(const Addresses &loc,
-                          const Meta &meta,
-                          hls::stream<axis_word> &buffer);
-  void reset();
+  DataForwarder() : held_valid(false), tail_pending(false) {}
+  void handle(const Optional<axis_word> &payload,
+              const ap_uint<1> &frame_end,
+              const ap_uint<1> &bad_data,
+              hls::stream<axis_word> &data_out);
 
 private:
-  ap_uint<5> word_cnt;
-  ap_uint<16> udp_pkt_length;
-  Checksum udp_checksum1;
-  Checksum udp_checksum2;
-  PayloadWordGenerator payloadWordGenerator;
+  axis_word held;
+  ap_uint<1> held_valid;
+  ap_uint<1> tail_pending;
 };
 
 #endif
@@ -29,7 +29,7 @@
 
 #include "DataSpotter.hpp"
 
-void DataSpotter::next(const ap_uint<2> &rxd, const ap_uint<1> &crsdv) {
+void DataSpotter::next(const phy_data &rxd, const ap_uint<1> &crsdv) {
   this->state_before = this->state;
   if (!crsdv) {
     this->state = PREAMBLE_CHECK;
@@ -37,9 +37,9 @@ void DataSpotter::next(const ap_uint<2> &rxd, const ap_uint<1> &crsdv) {
   } else {
     switch (this->state) {
     case PREAMBLE_CHECK:
-      if (rxd == 1 && this->cnt < 31) {
+      if (rxd == PREAMBLE_SYMBOL && this->cnt < PREAMBLE_SYMBOLS - 1) {
         this->cnt++;
-      } else if (rxd == 3 && this->cnt == 31) {
+      } else if (rxd == SFD_SYMBOL && this->cnt >= MIN_PREAMBLE_SYMBOLS) {
         this->state = PREAMBLE_END;
       }
       break;
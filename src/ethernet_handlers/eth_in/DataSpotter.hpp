@@ -31,12 +31,14 @@
 #define DATA_SPOTTER_HPP
 #pragma once
 
+#include "../utils/phy.hpp"
 #include <ap_int.h>
 
+// Spots the start frame delimiter after the preamble, symbol by symbol.
 class DataSpotter {
 public:
   DataSpotter() : cnt(0), valid_data(false), state(PREAMBLE_CHECK) {}
-  void next(const ap_uint<2> &rxd, const ap_uint<1> &crsdv);
+  void next(const phy_data &rxd, const ap_uint<1> &crsdv);
   ap_uint<1> spotted();
   ap_uint<1> spotted_before();
 
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "EchoBuffer.hpp"
+
+void EchoBuffer::write(const Optional<axis_word> &payload) {
+#pragma HLS INLINE
+
+  if (payload.is_none()) {
+    return;
+  }
+
+  if (this->committed || this->wr_ptr == ICMP_ECHO_WORDS) {
+    this->overflow = true;
+    return;
+  }
+  this->src = payload.some.get_addresses();
+  this->vlan = payload.some.get_vlan();
+  this->words[this->wr_ptr] = buffer_word(payload.some);
+  this->wr_ptr++;
+}
+
+void EchoBuffer::end_frame(const ap_uint<1> &bad_data) {
+#pragma HLS INLINE
+
+  if (!this->committed) {
+    if (this->wr_ptr != 0 && !bad_data && !this->overflow) {
+      this->committed = true;
+      this->rd_ptr = 0;
+    } else {
+      this->wr_ptr = 0;
+    }
+  }
+  this->overflow = false;
+}
+
+void EchoBuffer::read(hls::stream<axis_word> &icmp_out) {
+#pragma HLS INLINE
+
+  if (this->committed && !icmp_out.full()) {
+    buffer_word word = this->words[this->rd_ptr];
+    this->rd_ptr++;
+    ap_uint<AXIS_USER_WIDTH> user = axis_word::to_user(this->src);
+    axis_word::set_vlan(user, this->vlan);
+    icmp_out.write(word.with_user(user));
+    if (word.last) {
+      this->committed = false;
+      this->wr_ptr = 0;
+    }
+  }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ECHO_BUFFER_HPP
+#define ECHO_BUFFER_HPP
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/Optional.hpp"
+#include "../utils/VLANTag.hpp"
+#include "../utils/axis_word.hpp"
+#include "../utils/bit_width.hpp"
+#include "../utils/buffer_word.hpp"
+#include "../utils/icmp_echo.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+const int ICMP_ECHO_WORDS =
+    (ICMP_ECHO_BYTES + DATAPATH_BYTES - 1) / DATAPATH_BYTES;
+
+// Holds one echo request until its frame passed all checks and it has been
+// handed on to eth_out, along with the VLAN tag the reply is sent with.
+// Requests arriving meanwhile and requests larger than ICMP_ECHO_BYTES are not
+// answered.
+class EchoBuffer {
+public:
+  EchoBuffer() : wr_ptr(0), rd_ptr(0), overflow(false), committed(false) {}
+  void write(const Optional<axis_word> &payload);
+  void end_frame(const ap_uint<1> &bad_data);
+  void read(hls::stream<axis_word> &icmp_out);
+
+private:
+  buffer_word words[ICMP_ECHO_WORDS];
+  ap_uint<bit_width<ICMP_ECHO_WORDS>::value> wr_ptr;
+  ap_uint<bit_width<ICMP_ECHO_WORDS>::value> rd_ptr;
+  Addresses src;
+  VLANTag vlan;
+  ap_uint<1> overflow;
+  ap_uint<1> committed;
+};
+
+#endif
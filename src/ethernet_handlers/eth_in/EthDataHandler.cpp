@@ -29,11 +29,70 @@
 
 #include "EthDataHandler.hpp"
 
+ap_uint<1> vlan_allowed(const vlan_table &vlans, const VLANTag &vlan) {
+#pragma HLS INLINE
+
+  if (!vlan.tagged || vlan.vid() == 0) {
+    return true;
+  }
+  ap_uint<1> found = false;
+  for (int i = 0; i < NUM_VLANS; i++) {
+#pragma HLS UNROLL
+    ap_uint<12> entry = vlans(16 * i + 11, 16 * i);
+    if (entry != 0 && entry == vlan.vid()) {
+      found = true;
+    }
+  }
+  return found;
+}
+
 Optional<axis_word> EthDataHandler::get_payload(const Optional<axis_word> &word,
                                                 const Addresses &loc,
+                                                const port_table &udp_ports,
+                                                const vlan_table &vlans,
                                                 ap_uint<1> &bad_data) {
 #pragma HLS INLINE
 
+  if (word.is_none()) {
+    return NO_WORD;
+  }
+
+  // The bytes run through the protocol handlers one lane after another and
+  // keep their lane, so header fields may span several words.
+  axis_word ret_word(0, 0, false, 0);
+  for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+    if (word.some.keep[i]) {
+      ap_uint<1> last_lane = word.some.last && (word.some.keep >> (i + 1)) == 0;
+      Optional<byte_word> lane = {Some,
+                                  {word.some.get_byte(i), last_lane, 0}};
+      Optional<byte_word> payload =
+          this->get_payload_byte(lane, loc, udp_ports, vlans);
+      if (payload.is_some()) {
+        ret_word.set_byte(i, payload.some.data);
+        ret_word.keep[i] = 1;
+        ret_word.last = ret_word.last || payload.some.last;
+        ret_word.user = payload.some.user;
+      }
+    }
+  }
+
+  if (ret_word.keep == 0) {
+    return NO_WORD;
+  }
+
+  // The payload checksum takes all payload bytes of a word at once
+  this->ipPacketHandler.check_payload(ret_word, bad_data);
+  return {Some, ret_word};
+}
+
+Optional<byte_word>
+EthDataHandler::get_payload_byte(const Optional<byte_word> &word,
+                                 const Addresses &loc,
+                                 const port_table &udp_ports,
+                                 const vlan_table &vlans) {
+#pragma HLS INLINE
+
   if (word.is_none()) {
     return NOTHING;
   }
@@ -106,26 +165,110 @@ Optional<axis_word> EthDataHandler::get_payload(const Optional<axis_word> &word,
     break;
   case 13:
     frm_protocol(7, 0) = word.some.data;
-    this->cnt = 14;
+    // The EtherType of a tagged frame follows its TCI
+    frm_vlan.tagged = frm_protocol == VLAN;
+    frm_vlan.tci = 0;
+    this->cnt = frm_vlan.tagged ? 14 : 18;
+    return NOTHING;
+    break;
+  case 14:
+    frm_vlan.tci(15, 8) = word.some.data;
+    this->cnt = 15;
+    return NOTHING;
+    break;
+  case 15:
+    frm_vlan.tci(7, 0) = word.some.data;
+    this->cnt = 16;
+    return NOTHING;
+    break;
+  case 16:
+    frm_protocol(15, 8) = word.some.data;
+    this->cnt = 17;
+    return NOTHING;
+    break;
+  case 17:
+    frm_protocol(7, 0) = word.some.data;
+    this->cnt = 18;
     return NOTHING;
     break;
   default:
-    if (loc.mac_addr != frm_dst_addr) {
+    if (!vlan_allowed(vlans, frm_vlan)) {
+      this->drop = VLAN_MISMATCH;
       return NOTHING;
     }
-    word.some.user(47, 0) = frm_src_addr;
+    Optional<byte_word> ip_word = word;
+    ip_word.some.user(47, 0) = frm_src_addr;
+    byte_word::set_vlan(ip_word.some.user, frm_vlan);
     switch (frm_protocol) {
     case IPv4:
-      return this->ipPacketHandler.get_payload(word, loc, bad_data);
+      if (loc.mac_addr != frm_dst_addr) {
+        this->drop = MAC_MISMATCH;
+        return NOTHING;
+      }
+      return this->ipPacketHandler.get_payload(ip_word, loc, udp_ports);
+      break;
+    case ARP:
+      // Requests are broadcast
+      if (loc.mac_addr == frm_dst_addr || frm_dst_addr == BROADCAST_MAC_ADDR) {
+        this->arpPacketHandler.handle(word);
+      } else {
+        this->drop = MAC_MISMATCH;
+      }
+      return NOTHING;
       break;
     default:
+      this->drop = UNSUPPORTED;
       return NOTHING;
     }
     break;
   }
 }
 
+ap_uint<1> EthDataHandler::echo_requested() const {
+#pragma HLS INLINE
+
+  return this->frm_protocol == IPv4 && this->ipPacketHandler.echo_requested();
+}
+
+ap_uint<1> EthDataHandler::fragment_received() const {
+#pragma HLS INLINE
+
+  return this->frm_protocol == IPv4 &&
+         this->ipPacketHandler.fragment_received();
+}
+
+FragmentInfo EthDataHandler::get_fragment_info() const {
+#pragma HLS INLINE
+
+  return this->ipPacketHandler.get_fragment_info();
+}
+
+ap_uint<1> EthDataHandler::arp_received() const {
+#pragma HLS INLINE
+
+  return this->frm_protocol == ARP && this->arpPacketHandler.received();
+}
+
+ARPEvent EthDataHandler::get_arp_event() const {
+#pragma HLS INLINE
+
+  ARPEvent event = this->arpPacketHandler.get_event();
+  event.vlan = this->frm_vlan;
+  return event;
+}
+
+drop_reason EthDataHandler::get_drop_reason() const {
+#pragma HLS INLINE
+
+  if (this->drop == NOT_DROPPED && this->frm_protocol == IPv4) {
+    return this->ipPacketHandler.get_drop_reason();
+  }
+  return this->drop;
+}
+
 void EthDataHandler::reset() {
   this->ipPacketHandler.reset();
+  this->arpPacketHandler.reset();
   this->cnt = 0;
+  this->drop = NOT_DROPPED;
 }
@@ -31,27 +31,55 @@
 #define ETH_DATA_HANDLER_HPP
 #pragma once
 
+#include "../utils/ARPEvent.hpp"
 #include "../utils/Addresses.hpp"
 #include "../utils/Optional.hpp"
+#include "../utils/VLANTag.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/port_table.hpp"
 #include "../utils/protocols.hpp"
+#include "../utils/vlan_table.hpp"
+#include "ARPPacketHandler.hpp"
+#include "FragmentInfo.hpp"
 #include "IPPacketHandler.hpp"
+#include "drop_reason.hpp"
 #include <ap_int.h>
 
+ap_uint<1> vlan_allowed(const vlan_table &vlans, const VLANTag &vlan);
+
+// Takes the Ethernet header off the frame. The 802.1Q tag of a tagged frame is
+// removed as well and reported in the user field of its payload. Tagged frames
+// of VLANs missing in vlans are dropped. Why a frame was dropped is kept until
+// the next reset.
 class EthDataHandler {
 public:
-  EthDataHandler() : cnt(0) {}
+  EthDataHandler() : cnt(0), drop(NOT_DROPPED) {}
   Optional<axis_word> get_payload(const Optional<axis_word> &word,
                                   const Addresses &loc,
+                                  const port_table &udp_ports,
+                                  const vlan_table &vlans,
                                   ap_uint<1> &bad_data);
+  ap_uint<1> echo_requested() const;
+  ap_uint<1> fragment_received() const;
+  FragmentInfo get_fragment_info() const;
+  ap_uint<1> arp_received() const;
+  ARPEvent get_arp_event() const;
+  drop_reason get_drop_reason() const;
   void reset();
 
 private:
+  Optional<byte_word> get_payload_byte(const Optional<byte_word> &word,
+                                       const Addresses &loc,
+                                       const port_table &udp_ports,
+                                       const vlan_table &vlans);
   IPPacketHandler ipPacketHandler;
-  ap_uint<4> cnt;
+  ARPPacketHandler arpPacketHandler;
+  ap_uint<5> cnt;
   ap_uint<48> frm_dst_addr;
   ap_uint<48> frm_src_addr;
   ap_uint<16> frm_protocol;
+  VLANTag frm_vlan;
+  drop_reason drop;
 };
 
 #endif
@@ -34,38 +34,54 @@ FCSValidator::validate(const Optional<axis_word> &word, ap_uint<1> &bad_data) {
 #pragma HLS INLINE
 
   if (word.is_none()) {
-    return NOTHING;
+    return NO_WORD;
   }
 
-  ap_uint<8> next_data = this->stage3;
-  this->stage3 = this->stage2;
-  this->stage2 = this->stage1;
-  this->stage1 = this->stage0;
-  this->stage0 = word.some.data;
+  this->fcs.add<DATAPATH_BYTES>(word.some.data, word.some.keep);
 
-  if (this->shift_cnt < 4) {
-    this->shift_cnt++;
-    return NOTHING;
+  // Every byte leaves in the lane of the byte that arrived four bytes after
+  // it, so the frame check sequence is cut off at the end of the frame.
+  axis_word ret_word(0, 0, word.some.last, 0);
+  for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+    if (word.some.keep[i]) {
+      ap_uint<8> next_data = this->stage3;
+      this->stage3 = this->stage2;
+      this->stage2 = this->stage1;
+      this->stage1 = this->stage0;
+      this->stage0 = word.some.get_byte(i);
+
+      if (this->shift_cnt < 4) {
+        this->shift_cnt++;
+      } else {
+        ret_word.set_byte(i, next_data);
+        ret_word.keep[i] = 1;
+      }
+    }
+  }
+
+  if (ret_word.keep == 0) {
+    return NO_WORD;
   }
 
   if (word.some.last && !this->is_good()) {
+    this->fcs_error = true;
     bad_data = true;
   }
-  axis_word ret_word = {next_data, word.some.last, 0};
   return {Some, ret_word};
 }
 
-void FCSValidator::add_to_fcs(const Optional<ap_uint<8> > &data) {
+// The frame check sequence of the frame did not match
+ap_uint<1> FCSValidator::failed() const {
 #pragma HLS INLINE
 
-  if (data.is_some()) {
-    this->fcs.add(data.some);
-  }
+  return this->fcs_error;
 }
 
 void FCSValidator::reset() {
   this->shift_cnt = 0;
   this->fcs.reset();
+  this->fcs_error = false;
 }
 
 ap_uint<1> FCSValidator::is_good() {
@@ -38,10 +38,10 @@
 
 class FCSValidator {
 public:
-  FCSValidator() : shift_cnt(0) {}
+  FCSValidator() : shift_cnt(0), fcs_error(false) {}
   Optional<axis_word> validate(const Optional<axis_word> &word,
                                ap_uint<1> &bad_data);
-  void add_to_fcs(const Optional<ap_uint<8> > &data);
+  ap_uint<1> failed() const;
   void reset();
 
 private:
@@ -52,6 +52,7 @@ private:
   ap_uint<8> stage2;
   ap_uint<8> stage3;
   CRC32 fcs;
+  ap_uint<1> fcs_error;
 };
 
 #endif
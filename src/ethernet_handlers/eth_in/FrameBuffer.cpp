@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FrameBuffer.hpp"
+
+template <int W> ap_uint<W> next_index(const ap_uint<W> &index, int size) {
+#pragma HLS INLINE
+
+  return index == size - 1 ? ap_uint<W>(0) : ap_uint<W>(index + 1);
+}
+
+void FrameBuffer::write(const Optional<axis_word> &payload) {
+#pragma HLS INLINE
+
+  if (payload.is_none()) {
+    return;
+  }
+
+  this->frame_src = payload.some.get_addresses();
+  this->frame_queue_id = payload.some.user(USER_QUEUE_HIGH, USER_QUEUE_LOW);
+  this->frame_vlan = payload.some.get_vlan();
+  this->frame_length += payload.some.num_bytes();
+  if (next_index(this->word_wr_ptr, RX_BUFFER_WORDS) == this->word_rd_ptr) {
+    this->overflow = true;
+  }
+  if (!this->overflow) {
+    this->words[this->word_wr_ptr] = buffer_word(payload.some);
+    this->word_wr_ptr = next_index(this->word_wr_ptr, RX_BUFFER_WORDS);
+  }
+}
+
+// Returns whether a good frame was dropped for lack of room
+ap_uint<1> FrameBuffer::end_frame(const ap_uint<1> &bad_data) {
+#pragma HLS INLINE
+
+  if (this->frame_length == 0) {
+    return false;
+  }
+
+  ap_uint<1> info_full =
+      next_index(this->info_wr_ptr, RX_BUFFER_FRAMES) == this->info_rd_ptr;
+  ap_uint<1> no_room = !bad_data && (this->overflow || info_full);
+  if (bad_data || this->overflow || info_full) {
+    this->word_wr_ptr = this->word_commit_ptr;
+    if (no_room) {
+      this->dropped_frames++;
+    }
+  } else {
+    this->infos[this->info_wr_ptr] = {this->frame_src,
+                                      this->frame_queue_id,
+                                      this->frame_vlan,
+                                      this->frame_length};
+    this->info_wr_ptr = next_index(this->info_wr_ptr, RX_BUFFER_FRAMES);
+    this->word_commit_ptr = this->word_wr_ptr;
+  }
+  this->frame_length = 0;
+  this->overflow = false;
+  return no_room;
+}
+
+void FrameBuffer::read(hls::stream<axis_word> &data_out) {
+#pragma HLS INLINE
+
+  if (!this->reading && this->info_rd_ptr != this->info_wr_ptr) {
+    this->info = this->infos[this->info_rd_ptr];
+    this->info_rd_ptr = next_index(this->info_rd_ptr, RX_BUFFER_FRAMES);
+    this->reading = true;
+  }
+  if (this->reading && !data_out.full()) {
+    buffer_word word = this->words[this->word_rd_ptr];
+    this->word_rd_ptr = next_index(this->word_rd_ptr, RX_BUFFER_WORDS);
+    ap_uint<AXIS_USER_WIDTH> user = axis_word::to_user(this->info.src);
+    user(USER_QUEUE_HIGH, USER_QUEUE_LOW) = this->info.queue_id;
+    axis_word::set_vlan(user, this->info.vlan);
+    data_out.write(word.with_user(user));
+    this->reading = !word.last;
+  }
+}
+
+// A frame is being read
+ap_uint<1> FrameBuffer::busy() const {
+#pragma HLS INLINE
+
+  return this->reading;
+}
+
+ap_uint<32> FrameBuffer::get_dropped_frames() const {
+  return this->dropped_frames;
+}
+
+// Words taken by the frames committed and the frame being written
+ap_uint<16> FrameBuffer::get_used_words() const {
+#pragma HLS INLINE
+
+  if (this->word_wr_ptr >= this->word_rd_ptr) {
+    return this->word_wr_ptr - this->word_rd_ptr;
+  }
+  return RX_BUFFER_WORDS - this->word_rd_ptr + this->word_wr_ptr;
+}
+
+// Frames committed and not yet read
+ap_uint<16> FrameBuffer::get_used_frames() const {
+#pragma HLS INLINE
+
+  if (this->info_wr_ptr >= this->info_rd_ptr) {
+    return this->info_wr_ptr - this->info_rd_ptr;
+  }
+  return RX_BUFFER_FRAMES - this->info_rd_ptr + this->info_wr_ptr;
+}
+
+// The frame being written did not fit
+ap_uint<1> FrameBuffer::words_full() const {
+#pragma HLS INLINE
+
+  return this->overflow;
+}
+
+ap_uint<1> FrameBuffer::frames_full() const {
+#pragma HLS INLINE
+
+  return next_index(this->info_wr_ptr, RX_BUFFER_FRAMES) == this->info_rd_ptr;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FRAME_BUFFER_HPP
+#define FRAME_BUFFER_HPP
+#pragma once
+
+#include "../utils/Optional.hpp"
+#include "../utils/axis_word.hpp"
+#include "../utils/bit_width.hpp"
+#include "../utils/buffer_word.hpp"
+#include "../utils/frame_size.hpp"
+#include "FrameInfo.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Capacity of the receive buffer in payload bytes and in frames. Jumbo frames
+// get room for two of them.
+#ifndef RX_BUFFER_BYTES
+#if MAX_FRAME_BYTES > 2048
+#define RX_BUFFER_BYTES 20480
+#else
+#define RX_BUFFER_BYTES 4096
+#endif
+#endif
+#ifndef RX_BUFFER_FRAMES
+#define RX_BUFFER_FRAMES 64
+#endif
+
+const int RX_BUFFER_WORDS = RX_BUFFER_BYTES / DATAPATH_BYTES;
+
+// Ring buffer of received payload. The words of a frame are written behind
+// the last committed frame and only become visible to the reader once the
+// frame passed all checks. A bad frame is rolled back and never costs a read
+// cycle. A frame that does not fit anymore is dropped as a whole and counted.
+class FrameBuffer {
+public:
+  FrameBuffer()
+      : word_wr_ptr(0), word_commit_ptr(0), word_rd_ptr(0), info_wr_ptr(0),
+        info_rd_ptr(0), frame_length(0), overflow(false), reading(false),
+        dropped_frames(0) {}
+  void write(const Optional<axis_word> &payload);
+  ap_uint<1> end_frame(const ap_uint<1> &bad_data);
+  void read(hls::stream<axis_word> &data_out);
+  ap_uint<1> busy() const;
+  ap_uint<32> get_dropped_frames() const;
+  ap_uint<16> get_used_words() const;
+  ap_uint<16> get_used_frames() const;
+  ap_uint<1> words_full() const;
+  ap_uint<1> frames_full() const;
+
+private:
+  buffer_word words[RX_BUFFER_WORDS];
+  FrameInfo infos[RX_BUFFER_FRAMES];
+  ap_uint<bit_width<RX_BUFFER_WORDS - 1>::value> word_wr_ptr;
+  ap_uint<bit_width<RX_BUFFER_WORDS - 1>::value> word_commit_ptr;
+  ap_uint<bit_width<RX_BUFFER_WORDS - 1>::value> word_rd_ptr;
+  ap_uint<bit_width<RX_BUFFER_FRAMES - 1>::value> info_wr_ptr;
+  ap_uint<bit_width<RX_BUFFER_FRAMES - 1>::value> info_rd_ptr;
+  Addresses frame_src;
+  ap_uint<QUEUE_ID_WIDTH> frame_queue_id;
+  VLANTag frame_vlan;
+  ap_uint<FRAME_LENGTH_WIDTH> frame_length;
+  ap_uint<1> overflow;
+  ap_uint<1> reading;
+  FrameInfo info;
+  ap_uint<32> dropped_frames;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HANDLED_WORD_HPP
+#define HANDLED_WORD_HPP
+#pragma once
+
+#include "../utils/ARPEvent.hpp"
+#include "../utils/Optional.hpp"
+#include "../utils/axis_word.hpp"
+#include "FragmentInfo.hpp"
+#include "drop_reason.hpp"
+#include <ap_int.h>
+
+// Word of a received frame after the protocol handlers, holding the payload
+// they left of it, if any. The payload belongs to an echo request or to a
+// fragment if the flags say so. The fields from last on describe the frame
+// and only hold for sure at its last word.
+struct HandledWord {
+  Optional<axis_word> payload;
+  ap_uint<1> echo_request;
+  ap_uint<1> fragment;
+  FragmentInfo fragment_info;
+  ap_uint<1> last;
+  ap_uint<1> bad_data;
+  ap_uint<1> phy_error;
+  ap_uint<1> fcs_error;
+  drop_reason reason;
+  ap_uint<16> frame_bytes;
+  ap_uint<1> arp_received;
+  ARPEvent arp_event;
+};
+
+#endif
@@ -27,70 +27,77 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "ETHPacketWordGenerator.hpp"
+#include "ICMPPacketHandler.hpp"
 
-axis_word ETHPacketWordGenerator::get_next_word(
-    const Addresses &loc, const Meta &meta, hls::stream<axis_word> &buffer) {
+Optional<byte_word>
+ICMPPacketHandler::get_payload(const Optional<byte_word> &word,
+                               const ap_uint<16> &icmp_pkt_length) {
 #pragma HLS INLINE
 
-  switch (word_cnt) {
+  if (word.is_none()) {
+    return NOTHING;
+  }
+
+  switch (this->cnt) {
   case 0:
-    frm_protocol = IPv4;
-    return counted(meta.dst_mac_addr(47, 40), word_cnt);
+    this->icmp_pkt_type_and_code(15, 8) = word.some.data;
+    this->cnt = 1;
+    return NOTHING;
     break;
   case 1:
-    return counted(meta.dst_mac_addr(39, 32), word_cnt);
+    this->icmp_pkt_type_and_code(7, 0) = word.some.data;
+    this->icmp_checksum.add(this->icmp_pkt_type_and_code);
+    this->cnt = 2;
+    return NOTHING;
     break;
   case 2:
-    return counted(meta.dst_mac_addr(31, 24), word_cnt);
+    this->icmp_pkt_checksum(15, 8) = word.some.data;
+    this->cnt = 3;
+    return NOTHING;
     break;
   case 3:
-    return counted(meta.dst_mac_addr(23, 16), word_cnt);
-    break;
-  case 4:
-    return counted(meta.dst_mac_addr(15, 8), word_cnt);
-    break;
-  case 5:
-    return counted(meta.dst_mac_addr(7, 0), word_cnt);
-    break;
-  case 6:
-    return counted(loc.mac_addr(47, 40), word_cnt);
-    break;
-  case 7:
-    return counted(loc.mac_addr(39, 32), word_cnt);
-    break;
-  case 8:
-    return counted(loc.mac_addr(31, 24), word_cnt);
-    break;
-  case 9:
-    return counted(loc.mac_addr(23, 16), word_cnt);
-    break;
-  case 10:
-    return counted(loc.mac_addr(15, 8), word_cnt);
-    break;
-  case 11:
-    return counted(loc.mac_addr(7, 0), word_cnt);
-    break;
-  case 12:
-    return counted(frm_protocol(15, 8), word_cnt);
-    break;
-  case 13:
-    return counted(frm_protocol(7, 0), word_cnt);
+    this->icmp_pkt_checksum(7, 0) = word.some.data;
+    this->icmp_checksum.add(this->icmp_pkt_checksum);
+    this->cnt = 4;
+    return NOTHING;
     break;
   default:
-    switch (frm_protocol) {
-    case IPv4:
-      return ipPacketWordGenerator.get_next_word(loc, meta, buffer);
-      break;
-    default:
-      return {true, 0, 0};
-      break;
+    if (this->icmp_pkt_type_and_code != (ICMP_ECHO_REQUEST << 8)) {
+      this->drop = UNSUPPORTED;
+      return NOTHING;
     }
+
+    // Ethernet padding follows short messages
+    if (this->cnt >= icmp_pkt_length) {
+      return NOTHING;
+    }
+
+    ap_uint<1> is_last_word = this->cnt == (icmp_pkt_length - 1);
+    this->cnt++;
+    byte_word ret_word = {word.some.data, is_last_word, word.some.user};
+    return {Some, ret_word};
     break;
   }
 }
 
-void ETHPacketWordGenerator::reset() {
-  word_cnt = 0;
-  ipPacketWordGenerator.reset();
+void ICMPPacketHandler::check_payload(const axis_word &payload,
+                                      ap_uint<1> &bad_data) {
+#pragma HLS INLINE
+
+  this->icmp_checksum.add<DATAPATH_BYTES>(payload.data, payload.keep);
+  if (payload.last && this->icmp_checksum != 0) {
+    bad_data = true;
+  }
+}
+
+drop_reason ICMPPacketHandler::get_drop_reason() const {
+#pragma HLS INLINE
+
+  return this->drop;
+}
+
+void ICMPPacketHandler::reset() {
+  this->icmp_checksum.reset();
+  this->cnt = 0;
+  this->drop = NOT_DROPPED;
 }
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ICMP_PACKET_HANDLER_HPP
+#define ICMP_PACKET_HANDLER_HPP
+#pragma once
+
+#include "../utils/Optional.hpp"
+#include "../utils/axis_word.hpp"
+#include "../utils/checksums/Checksum.hpp"
+#include "../utils/protocols.hpp"
+#include "drop_reason.hpp"
+#include <ap_int.h>
+
+// Passes on the echo requests, from the identifier on. The answer echoes
+// these bytes unchanged, so type, code and checksum are only checked.
+class ICMPPacketHandler {
+public:
+  ICMPPacketHandler() : cnt(0), drop(NOT_DROPPED) {}
+  Optional<byte_word> get_payload(const Optional<byte_word> &word,
+                                  const ap_uint<16> &icmp_pkt_length);
+  void check_payload(const axis_word &payload, ap_uint<1> &bad_data);
+  drop_reason get_drop_reason() const;
+  void reset();
+
+private:
+  Checksum icmp_checksum;
+  ap_uint<16> cnt;
+  ap_uint<16> icmp_pkt_type_and_code;
+  ap_uint<16> icmp_pkt_checksum;
+  drop_reason drop;
+};
+
+#endif
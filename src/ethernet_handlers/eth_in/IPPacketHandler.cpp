@@ -29,10 +29,10 @@
 
 #include "IPPacketHandler.hpp"
 
-Optional<axis_word>
-IPPacketHandler::get_payload(const Optional<axis_word> &word,
+Optional<byte_word>
+IPPacketHandler::get_payload(const Optional<byte_word> &word,
                              const Addresses &loc,
-                             ap_uint<1> &bad_data) {
+                             const port_table &udp_ports) {
 #pragma HLS INLINE
 
   if (word.is_none()) {
@@ -50,26 +50,32 @@ IPPacketHandler::get_payload(const Optional<axis_word> &word,
     return NOTHING;
     break;
   case 2:
+    this->ip_pkt_length(15, 8) = word.some.data;
     this->cnt = 3;
     return NOTHING;
     break;
   case 3:
+    this->ip_pkt_length(7, 0) = word.some.data;
     this->cnt = 4;
     return NOTHING;
     break;
   case 4:
+    this->ip_pkt_id(15, 8) = word.some.data;
     this->cnt = 5;
     return NOTHING;
     break;
   case 5:
+    this->ip_pkt_id(7, 0) = word.some.data;
     this->cnt = 6;
     return NOTHING;
     break;
   case 6:
+    this->ip_pkt_flags_offset(15, 8) = word.some.data;
     this->cnt = 7;
     return NOTHING;
     break;
   case 7:
+    this->ip_pkt_flags_offset(7, 0) = word.some.data;
     this->cnt = 8;
     return NOTHING;
     break;
@@ -132,25 +138,129 @@ IPPacketHandler::get_payload(const Optional<axis_word> &word,
     break;
   default:
     if (loc.ip_addr != ip_pkt_dst_ip_addr) {
+      this->drop = IP_MISMATCH;
       return NOTHING;
     }
-    if (this->cnt >= this->ip_pkt_ihl * 4) {
-      word.some.user(79, 48) = this->ip_pkt_src_ip_addr;
-      switch (this->ip_pkt_protocol) {
-      case UDP:
-        return this->udpPacketHandler.get_payload(
-            word, loc, this->ip_pkt_src_ip_addr, bad_data);
-        break;
-      default:
-        return NOTHING;
-      }
+    // Header options are skipped
+    if (this->cnt < this->ip_pkt_ihl * 4) {
+      this->cnt++;
+      return NOTHING;
+    }
+    word.some.user(79, 48) = this->ip_pkt_src_ip_addr;
+    // Fragments only make sense once reassembled
+    if (this->fragmented()) {
+      return this->get_fragment_payload(word);
+    }
+    switch (this->ip_pkt_protocol) {
+    case UDP:
+      return this->udpPacketHandler.get_payload(
+          word, loc, udp_ports, this->ip_pkt_src_ip_addr);
+      break;
+    case ICMP:
+      return this->icmpPacketHandler.get_payload(
+          word, this->ip_pkt_length - this->ip_pkt_ihl * 4);
+      break;
+    default:
+      this->drop = UNSUPPORTED;
+      return NOTHING;
     }
+    break;
+  }
+}
+
+// Passes on all bytes of a UDP fragment, which start with the UDP header if
+// the offset is 0
+Optional<byte_word>
+IPPacketHandler::get_fragment_payload(const Optional<byte_word> &word) {
+#pragma HLS INLINE
+
+  ap_uint<16> fragment_length = this->ip_pkt_length - this->ip_pkt_ihl * 4;
+  if (this->ip_pkt_protocol != UDP) {
+    this->drop = UNSUPPORTED;
+    return NOTHING;
+  }
+  if (this->fragment_cnt >= fragment_length) {
     return NOTHING;
+  }
+
+  ap_uint<1> is_last_word = this->fragment_cnt == fragment_length - 1;
+  this->fragment_cnt++;
+  byte_word ret_word = {word.some.data, is_last_word, word.some.user};
+  return {Some, ret_word};
+}
+
+void IPPacketHandler::check_payload(const axis_word &payload,
+                                    ap_uint<1> &bad_data) {
+#pragma HLS INLINE
+
+  // The checksum of a fragmented datagram is checked after reassembly
+  if (this->fragmented()) {
+    return;
+  }
+
+  switch (this->ip_pkt_protocol) {
+  case UDP:
+    this->udpPacketHandler.check_payload(payload, bad_data);
+    break;
+  case ICMP:
+    this->icmpPacketHandler.check_payload(payload, bad_data);
+    break;
+  default:
+    break;
+  }
+}
+
+ap_uint<1> IPPacketHandler::echo_requested() const {
+#pragma HLS INLINE
+
+  return this->ip_pkt_protocol == ICMP && !this->fragmented();
+}
+
+ap_uint<1> IPPacketHandler::fragment_received() const {
+#pragma HLS INLINE
+
+  return this->fragmented() && this->ip_pkt_protocol == UDP;
+}
+
+FragmentInfo IPPacketHandler::get_fragment_info() const {
+#pragma HLS INLINE
+
+  ap_uint<16> offset = this->ip_pkt_flags_offset & IP_FRAGMENT_OFFSET;
+  ap_uint<1> more_fragments =
+      (this->ip_pkt_flags_offset & IP_MORE_FRAGMENTS) != 0;
+  return {
+      this->ip_pkt_src_ip_addr, this->ip_pkt_id, offset * 8, more_fragments};
+}
+
+ap_uint<1> IPPacketHandler::fragmented() const {
+#pragma HLS INLINE
+
+  return (this->ip_pkt_flags_offset &
+          (IP_MORE_FRAGMENTS | IP_FRAGMENT_OFFSET)) != 0;
+}
+
+drop_reason IPPacketHandler::get_drop_reason() const {
+#pragma HLS INLINE
+
+  if (this->drop != NOT_DROPPED) {
+    return this->drop;
+  }
+  switch (this->ip_pkt_protocol) {
+  case UDP:
+    return this->udpPacketHandler.get_drop_reason();
+    break;
+  case ICMP:
+    return this->icmpPacketHandler.get_drop_reason();
     break;
+  default:
+    return NOT_DROPPED;
   }
 }
 
 void IPPacketHandler::reset() {
   this->udpPacketHandler.reset();
+  this->icmpPacketHandler.reset();
   this->cnt = 0;
+  this->fragment_cnt = 0;
+  this->drop = NOT_DROPPED;
 }
@@ -34,25 +34,42 @@
 #include "../utils/Addresses.hpp"
 #include "../utils/Optional.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/port_table.hpp"
 #include "../utils/protocols.hpp"
+#include "FragmentInfo.hpp"
+#include "ICMPPacketHandler.hpp"
 #include "UDPPacketHandler.hpp"
+#include "drop_reason.hpp"
 #include <ap_int.h>
 
 class IPPacketHandler {
 public:
-  IPPacketHandler() : cnt(0) {}
-  Optional<axis_word> get_payload(const Optional<axis_word> &word,
+  IPPacketHandler() : cnt(0), fragment_cnt(0), drop(NOT_DROPPED) {}
+  Optional<byte_word> get_payload(const Optional<byte_word> &word,
                                   const Addresses &loc,
-                                  ap_uint<1> &bad_data);
+                                  const port_table &udp_ports);
+  void check_payload(const axis_word &payload, ap_uint<1> &bad_data);
+  ap_uint<1> echo_requested() const;
+  ap_uint<1> fragment_received() const;
+  FragmentInfo get_fragment_info() const;
+  drop_reason get_drop_reason() const;
   void reset();
 
 private:
+  Optional<byte_word> get_fragment_payload(const Optional<byte_word> &word);
+  ap_uint<1> fragmented() const;
   UDPPacketHandler udpPacketHandler;
-  ap_uint<5> cnt;
+  ICMPPacketHandler icmpPacketHandler;
+  ap_uint<6> cnt;
   ap_uint<4> ip_pkt_ihl;
+  ap_uint<16> ip_pkt_length;
+  ap_uint<16> ip_pkt_id;
+  ap_uint<16> ip_pkt_flags_offset;
   ap_uint<8> ip_pkt_protocol;
   ap_uint<32> ip_pkt_src_ip_addr;
   ap_uint<32> ip_pkt_dst_ip_addr;
+  ap_uint<16> fragment_cnt;
+  drop_reason drop;
 };
 
 #endif
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Reassembler.hpp"
+#include "UDPPacketHandler.hpp"
+
+Reassembler::Reassembler()
+    : stage_wr_ptr(0), stage_commit_ptr(0), stage_copy_ptr(0),
+      stage_overflow(false), now(0), evict_index(0), in_fragment(false),
+      reading(false) {
+  for (int i = 0; i < REASSEMBLY_CONTEXTS; i++) {
+    this->contexts[i].used = false;
+    this->contexts[i].complete = false;
+  }
+}
+
+void Reassembler::write(const Optional<axis_word> &fragment,
+                        const FragmentInfo &info) {
+#pragma HLS INLINE
+
+  if (fragment.is_none()) {
+    return;
+  }
+
+  if (!this->in_fragment) {
+    this->start_fragment(info, fragment.some);
+  }
+  ap_uint<17> position = this->fragment_info.offset + this->fragment_length;
+  if (this->accepted && position < REASSEMBLY_BYTES) {
+    ap_uint<bit_width<REASSEMBLY_CONTEXTS * REASSEMBLY_WORDS>::value> ptr =
+        this->fragment_index * REASSEMBLY_WORDS + position / DATAPATH_BYTES;
+    stage_ptr next = next_stage_ptr(this->stage_wr_ptr);
+    if (next == this->stage_copy_ptr) {
+      this->stage_overflow = true;
+    } else {
+      this->stage[this->stage_wr_ptr] = {fragment.some.data, ptr};
+      this->stage_wr_ptr = next;
+    }
+    this->fragment_checksum.add<DATAPATH_BYTES>(fragment.some.data,
+                                                fragment.some.keep);
+    // The UDP header is kept aside for the checks at the end
+    for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+      if (fragment.some.keep[i] && position + i < UDP_HEADER_BYTES) {
+        this->udp_header = (this->udp_header << 8) | fragment.some.get_byte(i);
+      }
+    }
+  }
+  this->fragment_length += fragment.some.num_bytes();
+}
+
+// Looks up the context of the datagram. A new context is only taken once the
+// fragment turned out to be good.
+void Reassembler::start_fragment(const FragmentInfo &info,
+                                 const axis_word &first_word) {
+#pragma HLS INLINE
+
+  this->in_fragment = true;
+  this->fragment_info = info;
+  this->fragment_src_mac_addr = first_word.user(47, 0);
+  this->fragment_vlan = first_word.get_vlan();
+  this->fragment_length = 0;
+  this->fragment_checksum.reset();
+  this->stage_overflow = false;
+
+  ap_uint<1> found = false;
+  ap_uint<1> free_found = false;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS - 1>::value> index = 0;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS - 1>::value> free_index = 0;
+  for (int i = 0; i < REASSEMBLY_CONTEXTS; i++) {
+#pragma HLS UNROLL
+    const ReassemblyContext &context = this->contexts[i];
+    if (context.used && !context.complete &&
+        context.src_ip_addr == info.src_ip_addr && context.id == info.id) {
+      found = true;
+      index = i;
+    }
+    if (!context.used && !free_found) {
+      free_found = true;
+      free_index = i;
+    }
+  }
+  this->accepted = found || free_found;
+  this->new_context = !found;
+  if (found) {
+    this->fragment_index = index;
+  } else {
+    this->fragment_index = free_index;
+  }
+}
+
+void Reassembler::end_fragment(const ap_uint<1> &bad_data,
+                               const Addresses &loc,
+                               const port_table &udp_ports) {
+#pragma HLS INLINE
+
+  if (!this->in_fragment) {
+    return;
+  }
+  this->in_fragment = false;
+  // The words of a fragment dropped are rolled back
+  if (bad_data || !this->accepted || this->stage_overflow) {
+    this->stage_wr_ptr = this->stage_commit_ptr;
+    return;
+  }
+
+  ReassemblyContext context = this->contexts[this->fragment_index];
+  if (this->new_context) {
+    context.used = true;
+    context.complete = false;
+    context.header_received = false;
+    context.src_ip_addr = this->fragment_info.src_ip_addr;
+    context.id = this->fragment_info.id;
+    context.received_bytes = 0;
+    context.total_bytes = 0;
+    context.sum = 0;
+    context.start_time = this->now;
+  } else if (!context.used) {
+    // Evicted meanwhile
+    this->stage_wr_ptr = this->stage_commit_ptr;
+    return;
+  }
+
+  ap_uint<17> fragment_end = this->fragment_info.offset + this->fragment_length;
+  if (fragment_end > REASSEMBLY_BYTES) {
+    context.used = false;
+    this->contexts[this->fragment_index] = context;
+    this->stage_wr_ptr = this->stage_commit_ptr;
+    return;
+  }
+  this->stage_commit_ptr = this->stage_wr_ptr;
+
+  Checksum sum(context.sum);
+  sum.add(this->fragment_checksum.get_sum());
+  context.sum = sum.get_sum();
+  context.received_bytes += this->fragment_length;
+  if (this->fragment_info.offset == 0) {
+    context.header_received = true;
+    context.src_mac_addr = this->fragment_src_mac_addr;
+    context.vlan = this->fragment_vlan;
+    context.src_port = this->udp_header(63, 48);
+    context.dst_port = this->udp_header(47, 32);
+    context.udp_checksum = this->udp_header(15, 0);
+  }
+  if (!this->fragment_info.more_fragments) {
+    context.total_bytes = fragment_end;
+  }
+
+  if (context.total_bytes != 0 &&
+      context.received_bytes >= context.total_bytes) {
+    Checksum udp_checksum(context.sum);
+    udp_checksum.add(context.src_ip_addr(31, 16));
+    udp_checksum.add(context.src_ip_addr(15, 0));
+    udp_checksum.add(loc.ip_addr(31, 16));
+    udp_checksum.add(loc.ip_addr(15, 0));
+    udp_checksum.add(UDP);
+    udp_checksum.add(context.total_bytes);
+    ap_uint<1> port_known;
+    lookup_port(udp_ports, context.dst_port, port_known, context.queue_id);
+    ap_uint<1> checksum_ok = context.udp_checksum == 0 || udp_checksum == 0;
+    if (context.header_received && port_known && checksum_ok &&
+        context.received_bytes == context.total_bytes) {
+      context.complete = true;
+    } else {
+      context.used = false;
+    }
+  }
+  this->contexts[this->fragment_index] = context;
+}
+
+// Checks one context per cycle for its timeout
+void Reassembler::evict() {
+#pragma HLS INLINE
+
+  ReassemblyContext &context = this->contexts[this->evict_index];
+  ap_uint<32> age = this->now - context.start_time;
+  if (context.used && !context.complete && age >= REASSEMBLY_TIMEOUT_CYCLES) {
+    context.used = false;
+  }
+  this->evict_index = this->evict_index == REASSEMBLY_CONTEXTS - 1
+                          ? 0
+                          : this->evict_index + 1;
+  this->now++;
+}
+
+// Copies a word of the fragments passed from the stage to the storage
+void Reassembler::copy() {
+#pragma HLS INLINE
+
+  if (this->stage_copy_ptr != this->stage_commit_ptr) {
+    const StagedWord &word = this->stage[this->stage_copy_ptr];
+    this->storage[word.ptr] = word.data;
+    this->stage_copy_ptr = next_stage_ptr(this->stage_copy_ptr);
+  }
+}
+
+Reassembler::stage_ptr Reassembler::next_stage_ptr(const stage_ptr &ptr) {
+#pragma HLS INLINE
+
+  return ptr == REASSEMBLY_STAGE_WORDS - 1 ? stage_ptr(0) : stage_ptr(ptr + 1);
+}
+
+ap_uint<1> Reassembler::datagram_ready() const {
+#pragma HLS INLINE
+
+  if (this->stage_copy_ptr != this->stage_commit_ptr) {
+    return false;
+  }
+  ap_uint<1> ready = false;
+  for (int i = 0; i < REASSEMBLY_CONTEXTS; i++) {
+#pragma HLS UNROLL
+    if (this->contexts[i].used && this->contexts[i].complete) {
+      ready = true;
+    }
+  }
+  return ready;
+}
+
+ap_uint<1> Reassembler::busy() const {
+#pragma HLS INLINE
+
+  return this->reading;
+}
+
+void Reassembler::read(hls::stream<axis_word> &data_out) {
+#pragma HLS INLINE
+
+  if (!this->reading) {
+    for (int i = REASSEMBLY_CONTEXTS - 1; i >= 0; i--) {
+#pragma HLS UNROLL
+      if (this->contexts[i].used && this->contexts[i].complete) {
+        this->read_index = i;
+        this->reading = true;
+      }
+    }
+    if (!this->reading) {
+      return;
+    }
+    ReassemblyContext &context = this->contexts[this->read_index];
+    this->read_ptr = this->read_index * REASSEMBLY_WORDS +
+                     UDP_HEADER_BYTES / DATAPATH_BYTES;
+    this->read_remaining = context.total_bytes - UDP_HEADER_BYTES;
+    if (this->read_remaining == 0) {
+      context.used = false;
+      context.complete = false;
+      this->reading = false;
+      return;
+    }
+  }
+  if (!data_out.full()) {
+    ReassemblyContext &context = this->contexts[this->read_index];
+    ap_uint<1> last = this->read_remaining <= DATAPATH_BYTES;
+    ap_uint<DATAPATH_BYTES> keep = 0;
+    keep.b_not();
+    if (last) {
+      keep >>= DATAPATH_BYTES - this->read_remaining;
+    }
+    const Addresses src = {
+        context.src_mac_addr, context.src_ip_addr, context.src_port};
+    ap_uint<AXIS_USER_WIDTH> user = axis_word::to_user(src);
+    user(USER_QUEUE_HIGH, USER_QUEUE_LOW) = context.queue_id;
+    axis_word::set_vlan(user, context.vlan);
+    data_out.write(axis_word(this->storage[this->read_ptr], keep, last, user));
+    this->read_ptr++;
+    this->read_remaining -= DATAPATH_BYTES;
+    if (last) {
+      context.used = false;
+      context.complete = false;
+      this->reading = false;
+    }
+  }
+}
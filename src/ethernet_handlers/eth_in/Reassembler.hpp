@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef REASSEMBLER_HPP
+#define REASSEMBLER_HPP
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/Optional.hpp"
+#include "../utils/VLANTag.hpp"
+#include "../utils/axis_word.hpp"
+#include "../utils/bit_width.hpp"
+#include "../utils/checksums/Checksum.hpp"
+#include "../utils/frame_size.hpp"
+#include "../utils/phy.hpp"
+#include "../utils/port_table.hpp"
+#include "../utils/protocols.hpp"
+#include "FragmentInfo.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Number of datagrams reassembled at a time and the bytes each may take,
+// including its UDP header
+#ifndef REASSEMBLY_CONTEXTS
+#define REASSEMBLY_CONTEXTS 4
+#endif
+#ifndef REASSEMBLY_BYTES
+#define REASSEMBLY_BYTES 8192
+#endif
+
+// Cycles after its first fragment an incomplete datagram is given up, 30 s
+#ifndef REASSEMBLY_TIMEOUT_CYCLES
+#define REASSEMBLY_TIMEOUT_CYCLES (30ULL * PHY_CLOCK_HZ)
+#endif
+
+const int REASSEMBLY_WORDS = REASSEMBLY_BYTES / DATAPATH_BYTES;
+const int UDP_HEADER_BYTES = 8;
+
+// Words staged for the storage, two fragments of the largest size: one being
+// received and one being copied
+const int REASSEMBLY_STAGE_WORDS =
+    2 * (MAX_IP_PACKET_BYTES / DATAPATH_BYTES + 1);
+
+// Word of a fragment staged for the storage, with its place there
+struct StagedWord {
+  ap_uint<8 * DATAPATH_BYTES> data;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS * REASSEMBLY_WORDS>::value> ptr;
+};
+
+// State of a datagram being reassembled
+struct ReassemblyContext {
+  ap_uint<1> used;
+  ap_uint<1> complete;
+  ap_uint<1> header_received;
+  ap_uint<32> src_ip_addr;
+  ap_uint<16> id;
+  ap_uint<48> src_mac_addr;
+  VLANTag vlan;
+  ap_uint<16> src_port;
+  ap_uint<16> dst_port;
+  ap_uint<16> udp_checksum;
+  ap_uint<QUEUE_ID_WIDTH> queue_id;
+  ap_uint<bit_width<REASSEMBLY_BYTES>::value> received_bytes;
+  ap_uint<bit_width<REASSEMBLY_BYTES>::value> total_bytes; // 0 while unknown
+  ap_uint<16> sum; // Folded sum of the bytes received so far
+  ap_uint<32> start_time;
+};
+
+// Collects the fragments of UDP datagrams, one storage slot per datagram. The
+// fragments of a datagram are told apart from others by source IP address and
+// identification and may arrive in any order. Once all bytes arrived, the UDP
+// checksum matches and the port is in udp_ports, the payload is read out as
+// one piece. Since fragment offsets are multiples of 8 bytes, the checksum is
+// summed up per fragment and the sums are added in any order. Overlapping
+// fragments are only caught by the checksum. Fragments of bad frames, finding
+// no free context or exceeding REASSEMBLY_BYTES are dropped, the latter along
+// with their datagram. The words of a fragment are staged until its frame
+// passed all checks and are then copied to the storage a word per cycle, so a
+// bad frame leaves the datagrams stored alone. A datagram is only read out
+// once all words staged before are copied.
+class Reassembler {
+public:
+  Reassembler();
+  void write(const Optional<axis_word> &fragment, const FragmentInfo &info);
+  void end_fragment(const ap_uint<1> &bad_data,
+                    const Addresses &loc,
+                    const port_table &udp_ports);
+  void evict();
+  void copy();
+  ap_uint<1> datagram_ready() const;
+  ap_uint<1> busy() const;
+  void read(hls::stream<axis_word> &data_out);
+
+private:
+  void start_fragment(const FragmentInfo &info, const axis_word &first_word);
+  typedef ap_uint<bit_width<REASSEMBLY_STAGE_WORDS - 1>::value> stage_ptr;
+  static stage_ptr next_stage_ptr(const stage_ptr &ptr);
+  ap_uint<8 * DATAPATH_BYTES> storage[REASSEMBLY_CONTEXTS * REASSEMBLY_WORDS];
+  StagedWord stage[REASSEMBLY_STAGE_WORDS];
+  // Words of the fragment being received follow stage_commit_ptr, those of
+  // the fragments passed precede it
+  stage_ptr stage_wr_ptr;
+  stage_ptr stage_commit_ptr;
+  stage_ptr stage_copy_ptr;
+  ap_uint<1> stage_overflow;
+  ReassemblyContext contexts[REASSEMBLY_CONTEXTS];
+  ap_uint<32> now;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS - 1>::value> evict_index;
+  // Fragment being received
+  ap_uint<1> in_fragment;
+  ap_uint<1> accepted;
+  ap_uint<1> new_context;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS - 1>::value> fragment_index;
+  FragmentInfo fragment_info;
+  ap_uint<48> fragment_src_mac_addr;
+  VLANTag fragment_vlan;
+  ap_uint<16> fragment_length;
+  ap_uint<64> udp_header;
+  Checksum fragment_checksum;
+  // Datagram being read
+  ap_uint<1> reading;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS - 1>::value> read_index;
+  ap_uint<bit_width<REASSEMBLY_CONTEXTS * REASSEMBLY_WORDS>::value> read_ptr;
+  ap_uint<bit_width<REASSEMBLY_BYTES>::value> read_remaining;
+};
+
+#endif
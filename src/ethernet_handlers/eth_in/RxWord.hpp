@@ -27,28 +27,24 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef PAYLOAD_WORD_GENERATOR
-#define PAYLOAD_WORD_GENERATOR
+#ifndef RX_WORD_HPP
+#define RX_WORD_HPP
 #pragma once
 
 #include "../utils/axis_word.hpp"
-#include "counted.hpp"
 #include <ap_int.h>
-#include <hls_stream.h>
 
-class PayloadWordGenerator {
-public:
-  PayloadWordGenerator(const ap_uint<6> &min_payload_byte_size)
-      : word_cnt(0), state(READING_BUFFER),
-        min_payload_byte_size(min_payload_byte_size) {}
-  axis_word get_next_word(hls::stream<axis_word> &buffer);
-  void reset();
-
-private:
-  ap_uint<5> word_cnt;
-  ap_uint<6> min_payload_byte_size;
-  enum state_type { READING_BUFFER, FILLING_OUTPUT };
-  state_type state;
+// Word of a received frame on its way from one stage of eth_in to the next,
+// along with what the stages before found out about the frame so far. A word
+// with idle set carries no data but tells the following stages that the frame
+// is over.
+struct RxWord {
+  axis_word word;
+  ap_uint<1> idle;
+  ap_uint<1> bad_data;
+  ap_uint<1> phy_error;
+  ap_uint<1> fcs_error;
+  ap_uint<16> frame_bytes;
 };
 
 #endif
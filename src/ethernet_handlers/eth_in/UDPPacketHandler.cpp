@@ -29,11 +29,30 @@
 
 #include "UDPPacketHandler.hpp"
 
-Optional<axis_word>
-UDPPacketHandler::get_payload(const Optional<axis_word> &word,
+// Finds the entry of port in the table. All entries are compared at once.
+void lookup_port(const port_table &udp_ports,
+                 const ap_uint<16> &port,
+                 ap_uint<1> &found,
+                 ap_uint<QUEUE_ID_WIDTH> &queue_id) {
+#pragma HLS INLINE
+
+  found = false;
+  queue_id = 0;
+  for (int i = 0; i < NUM_UDP_PORTS; i++) {
+#pragma HLS UNROLL
+    ap_uint<16> entry = udp_ports(16 * i + 15, 16 * i);
+    if (entry != 0 && entry == port) {
+      found = true;
+      queue_id = i;
+    }
+  }
+}
+
+Optional<byte_word>
+UDPPacketHandler::get_payload(const Optional<byte_word> &word,
                               const Addresses &loc,
-                              const ap_uint<32> &src_ip_addr,
-                              ap_uint<1> &bad_data) {
+                              const port_table &udp_ports,
+                              const ap_uint<32> &src_ip_addr) {
 #pragma HLS INLINE
 
   if (word.is_none()) {
@@ -65,11 +84,13 @@ UDPPacketHandler::get_payload(const Optional<axis_word> &word,
   case 3:
     this->udp_pkt_dst_port(7, 0) = word.some.data;
     this->udp_checksum1.add(this->udp_pkt_dst_port);
+    lookup_port(
+        udp_ports, this->udp_pkt_dst_port, this->port_known, this->queue_id);
     this->cnt = 4;
     return NOTHING;
     break;
   case 4:
-    this->udp_pkt_length(15, 0) = word.some.data;
+    this->udp_pkt_length(15, 8) = word.some.data;
     this->cnt = 5;
     return NOTHING;
     break;
@@ -93,7 +114,8 @@ UDPPacketHandler::get_payload(const Optional<axis_word> &word,
     return NOTHING;
     break;
   default:
-    if (loc.udp_port != udp_pkt_dst_port) {
+    if (!this->port_known) {
+      this->drop = PORT_MISMATCH;
       return NOTHING;
     }
 
@@ -102,22 +124,36 @@ UDPPacketHandler::get_payload(const Optional<axis_word> &word,
     }
 
     ap_uint<1> is_last_word = this->cnt == (this->udp_pkt_length - 1);
-    ap_uint<96> new_user = word.some.user;
+    ap_uint<AXIS_USER_WIDTH> new_user = word.some.user;
     new_user(95, 80) = this->udp_pkt_src_port;
-    this->udp_checksum1.add_half(word.some.data);
+    new_user(USER_QUEUE_HIGH, USER_QUEUE_LOW) = this->queue_id;
     this->cnt++;
-    axis_word ret_word = {word.some.data, is_last_word, new_user};
-    ap_uint<1> bad_checksum = udp_pkt_checksum != 0 && this->udp_checksum1 != 0;
-    if (is_last_word && bad_checksum) {
-      bad_data = true;
-    }
+    byte_word ret_word = {word.some.data, is_last_word, new_user};
     return {Some, ret_word};
     break;
   }
 }
 
+void UDPPacketHandler::check_payload(const axis_word &payload,
+                                     ap_uint<1> &bad_data) {
+#pragma HLS INLINE
+
+  this->udp_checksum1.add<DATAPATH_BYTES>(payload.data, payload.keep);
+  ap_uint<1> bad_checksum = udp_pkt_checksum != 0 && this->udp_checksum1 != 0;
+  if (payload.last && bad_checksum) {
+    bad_data = true;
+  }
+}
+
+drop_reason UDPPacketHandler::get_drop_reason() const {
+#pragma HLS INLINE
+
+  return this->drop;
+}
+
 void UDPPacketHandler::reset() {
   this->udp_checksum1.reset();
   this->udp_checksum2.reset();
   this->cnt = 0;
+  this->drop = NOT_DROPPED;
 }
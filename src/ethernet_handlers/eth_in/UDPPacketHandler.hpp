@@ -34,26 +34,39 @@
 #include "../utils/Addresses.hpp"
 #include "../utils/Optional.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/port_table.hpp"
 #include "../utils/checksums/Checksum.hpp"
+#include "../utils/frame_size.hpp"
+#include "drop_reason.hpp"
 #include <ap_int.h>
 
+void lookup_port(const port_table &udp_ports,
+                 const ap_uint<16> &port,
+                 ap_uint<1> &found,
+                 ap_uint<QUEUE_ID_WIDTH> &queue_id);
+
 class UDPPacketHandler {
 public:
-  UDPPacketHandler() : cnt(0) {}
-  Optional<axis_word> get_payload(const Optional<axis_word> &word,
+  UDPPacketHandler() : cnt(0), drop(NOT_DROPPED) {}
+  Optional<byte_word> get_payload(const Optional<byte_word> &word,
                                   const Addresses &loc,
-                                  const ap_uint<32> &src_ip_addr,
-                                  ap_uint<1> &bad_data);
+                                  const port_table &udp_ports,
+                                  const ap_uint<32> &src_ip_addr);
+  void check_payload(const axis_word &payload, ap_uint<1> &bad_data);
+  drop_reason get_drop_reason() const;
   void reset();
 
 private:
   Checksum udp_checksum1;
   Checksum udp_checksum2;
-  ap_uint<11> cnt;
+  ap_uint<FRAME_LENGTH_WIDTH> cnt;
   ap_uint<16> udp_pkt_src_port;
   ap_uint<16> udp_pkt_dst_port;
   ap_uint<16> udp_pkt_length;
   ap_uint<16> udp_pkt_checksum;
+  ap_uint<1> port_known;
+  ap_uint<QUEUE_ID_WIDTH> queue_id;
+  drop_reason drop;
 };
 
 #endif
@@ -1,30 +1,87 @@
-open_project proj_eth_in -reset
-set_top eth_in
-add_files eth_in.cpp
-add_files DataBundler.cpp
-add_files AxisWordGenerator.cpp
-add_files DataGate.cpp
-add_files DataSpotter.cpp
-add_files EthDataHandler.cpp
-add_files FCSValidator.cpp
-add_files IPPacketHandler.cpp
-add_files UDPPacketHandler.cpp
-add_files ../utils/checksums/Checksum.cpp
-add_files ../utils/checksums/CRC32.cpp
-add_files ../utils/axis_word.cpp
-add_files -tb eth_in_test.cpp
-add_files -tb ../utils/test/Frame.cpp
-add_files -tb ../utils/test/ETHPacket.cpp
-add_files -tb ../utils/test/IPPacket.cpp
-add_files -tb ../utils/test/UDPPacket.cpp
-add_files -tb ../utils/test/calculate_checksum.cpp
-add_files -tb ../utils/Addresses.cpp
-open_solution "solution1"
-set_part {xc7a100tcsg324-1}
-create_clock -period 20 -name default
-set_clock_uncertainty 1
-config_rtl -module_auto_prefix -reset all -reset_level high
-csim_design
-csynth_design
-cosim_design -rtl verilog -tool xsim
-export_design -format ip_catalog -flow impl -ipname eth_in -library eth -output ../../ip/eth_in -rtl verilog -vendor ME -version 1.0.0
+set design_files {
+  eth_in.cpp
+  ARPPacketHandler.cpp
+  DataBundler.cpp
+  AxisWordGenerator.cpp
+  DataAligner.cpp
+  DataForwarder.cpp
+  DataSpotter.cpp
+  EchoBuffer.cpp
+  EthDataHandler.cpp
+  FCSValidator.cpp
+  FrameBuffer.cpp
+  ICMPPacketHandler.cpp
+  IPPacketHandler.cpp
+  Reassembler.cpp
+  UDPPacketHandler.cpp
+  ../utils/checksums/Checksum.cpp
+  ../utils/checksums/CRC32.cpp
+  ../utils/FIFOMonitor.cpp
+  ../utils/StatCounters.cpp
+  ../utils/axis_word.cpp
+}
+set tb_files {
+  eth_in_test.cpp
+  ../utils/test/ARPPacket.cpp
+  ../utils/test/Frame.cpp
+  ../utils/test/ICMPPacket.cpp
+  ../utils/test/ETHPacket.cpp
+  ../utils/test/IPPacket.cpp
+  ../utils/test/UDPPacket.cpp
+  ../utils/test/calculate_checksum.cpp
+  ../utils/ARPEvent.cpp
+  ../utils/Addresses.cpp
+}
+
+# IP name, compiler flags and clock period in ns of every variant
+set variants {
+  eth_in {} 20
+  eth_in_cut_through {-DETH_IN_CUT_THROUGH=1} 20
+  eth_in_reassembly {-DETH_IN_REASSEMBLY=1} 20
+  eth_in_4byte {-DDATAPATH_BYTES=4} 20
+  eth_in_8byte {-DDATAPATH_BYTES=8} 20
+  eth_in_jumbo {-DMAX_FRAME_BYTES=9018} 20
+  eth_in_dataflow {-DETH_IN_DATAFLOW=1} 8
+  eth_in_gmii {-DPHY_GMII=1 -DETH_IN_DATAFLOW=1} 8
+}
+
+foreach {ip_name cflags period} $variants {
+  open_project proj_$ip_name -reset
+  set_top eth_in
+  foreach file $design_files {
+    add_files $file -cflags $cflags
+  }
+  foreach file $tb_files {
+    add_files -tb $file -cflags $cflags
+  }
+  open_solution "solution1"
+  set_part {xc7a100tcsg324-1}
+  create_clock -period $period -name default
+  set_clock_uncertainty 1
+  config_rtl -module_auto_prefix -reset all -reset_level high
+  csim_design
+  csynth_design
+  cosim_design -rtl verilog -tool xsim
+  export_design -format ip_catalog -flow impl -ipname $ip_name -library eth -output ../../ip/$ip_name -rtl verilog -vendor ME -version 1.0.0
+}
+
+# Name and compiler flags of variants that are only simulated, to test limits
+# the default configuration takes too long to reach or never reaches
+set csim_variants {
+  eth_in_reassembly_limits {-DETH_IN_REASSEMBLY=1 -DREASSEMBLY_CONTEXTS=2 -DREASSEMBLY_BYTES=2048 -DREASSEMBLY_TIMEOUT_CYCLES=5000}
+  eth_in_small_buffer {-DRX_BUFFER_BYTES=1024}
+}
+
+foreach {name cflags} $csim_variants {
+  open_project proj_$name -reset
+  set_top eth_in
+  foreach file $design_files {
+    add_files $file -cflags $cflags
+  }
+  foreach file $tb_files {
+    add_files -tb $file -cflags $cflags
+  }
+  open_solution "solution1"
+  set_part {xc7a100tcsg324-1}
+  csim_design
+}
@@ -29,56 +29,434 @@
 
 #include "eth_in.hpp"
 
-void eth_in(const ap_uint<2> &rxd,
-            const ap_uint<1> &rxerr,
-            const ap_uint<1> &crsdv,
-            hls::stream<axis_word> &data_out,
-            const Addresses &loc) {
-#pragma HLS INTERFACE axis port = data_out
-#pragma HLS DISAGGREGATE variable = loc
-#pragma HLS PIPELINE II = 1
+// Bundles the symbols of rxd into words. Every word also tells whether
+// rxerr was set during its frame so far and how many bytes the frame had so
+// far. A word with idle set follows the last word of every frame.
+Optional<RxWord> receive_word(const phy_data &rxd,
+                              const ap_uint<1> &rxerr,
+                              const ap_uint<1> &crsdv) {
+#pragma HLS INLINE
 
   static DataSpotter dataSpotter;
   static DataBundler dataBundler;
   static AxisWordGenerator axisWordGenerator;
-  static FCSValidator fcsValidator;
-  static EthDataHandler ethDataHandler;
-  static DataGate dataGate;
-  static hls::stream<axis_word> data_buffer;
-#pragma HLS STREAM variable = data_buffer depth = 1500
-  static hls::stream<ap_uint<1> > valid_buffer;
-#pragma HLS STREAM variable = valid_buffer depth = 6
-  Optional<ap_uint<8> > bundled_data;
-  Optional<axis_word> data_word;
-  Optional<axis_word> validator_output;
-  Optional<axis_word> payload;
-  static ap_uint<1> bad_data = false;
-  static ap_uint<1> data_written = false;
+  static ap_uint<1> in_frame = false;
+  static ap_uint<1> phy_error = false;
+  static ap_uint<16> frame_bytes = 0;
+  Optional<RxWord> ret;
+  ret.type = None;
 
   dataSpotter.next(rxd, crsdv);
   if (dataSpotter.spotted() || dataSpotter.spotted_before()) {
+    in_frame = true;
     if (rxerr) {
-      bad_data = true;
-    }
-    bundled_data = dataBundler.bundle(rxd);
-    fcsValidator.add_to_fcs(bundled_data);
-    data_word = axisWordGenerator.next(bundled_data, crsdv);
-    validator_output = fcsValidator.validate(data_word, bad_data);
-    payload = ethDataHandler.get_payload(validator_output, loc, bad_data);
-    if (payload.is_some()) {
-      data_buffer.write(payload.some);
-      data_written = true;
+      phy_error = true;
     }
-    if (validator_output.some.last && data_written) {
-      valid_buffer.write(!bad_data);
+    Optional<ap_uint<8> > bundled_data = dataBundler.bundle(rxd);
+    Optional<axis_word> data_word = axisWordGenerator.next(bundled_data, crsdv);
+    if (data_word.is_some()) {
+      frame_bytes += data_word.some.num_bytes();
+      ret = {Some, {data_word.some, false, phy_error, phy_error, false,
+                    frame_bytes}};
     }
   } else {
     dataBundler.reset();
     axisWordGenerator.reset();
+    if (in_frame) {
+      ret = {Some, {axis_word(0, 0, false, 0), true, false, false, false, 0}};
+    }
+    in_frame = false;
+    phy_error = false;
+    frame_bytes = 0;
+  }
+  return ret;
+}
+
+// Cuts the frame check sequence off the frame and flags the last word of a
+// frame whose sequence did not match
+Optional<RxWord> check_fcs(const Optional<RxWord> &data_word) {
+#pragma HLS INLINE
+
+  static FCSValidator fcsValidator;
+  Optional<RxWord> ret;
+  ret.type = None;
+
+  if (data_word.is_none()) {
+    return ret;
+  }
+  if (data_word.some.idle) {
     fcsValidator.reset();
+    return data_word;
+  }
+  ap_uint<1> bad_data = data_word.some.bad_data;
+  Optional<axis_word> validator_output =
+      fcsValidator.validate({Some, data_word.some.word}, bad_data);
+  if (validator_output.is_some()) {
+    ret = data_word;
+    ret.some.word = validator_output.some;
+    ret.some.bad_data = bad_data;
+    ret.some.fcs_error = fcsValidator.failed();
+  }
+  return ret;
+}
+
+// Runs the words through the protocol handlers. The last word of a frame
+// also tells what became of the frame.
+Optional<HandledWord> handle_protocols(const Optional<RxWord> &checked_word,
+                                       const Addresses &loc,
+                                       const port_table &udp_ports,
+                                       const vlan_table &vlans) {
+#pragma HLS INLINE
+
+  static EthDataHandler ethDataHandler;
+  static ap_uint<1> bad_data = false;
+  Optional<HandledWord> ret;
+  ret.type = None;
+
+  if (checked_word.is_none()) {
+    return ret;
+  }
+  if (checked_word.some.idle) {
     ethDataHandler.reset();
     bad_data = false;
-    data_written = false;
+    return ret;
+  }
+  bad_data = bad_data || checked_word.some.bad_data;
+  Optional<axis_word> payload = ethDataHandler.get_payload(
+      {Some, checked_word.some.word}, loc, udp_ports, vlans, bad_data);
+  ret = {Some,
+         {payload,
+          ethDataHandler.echo_requested(),
+          ethDataHandler.fragment_received(),
+          ethDataHandler.get_fragment_info(),
+          checked_word.some.word.last,
+          bad_data,
+          checked_word.some.phy_error,
+          checked_word.some.fcs_error,
+          ethDataHandler.get_drop_reason(),
+          checked_word.some.frame_bytes,
+          ethDataHandler.arp_received(),
+          ethDataHandler.get_arp_event()}};
+  return ret;
+}
+
+// Hands the payload, ARP packets and echo requests of the frames that passed
+// all checks on and counts the frames. The reassembler checks the addresses
+// of a datagram against loc and udp_ports once it is complete.
+void pass_on(const Optional<HandledWord> &handled_word,
+             hls::stream<axis_word> &data_out,
+             hls::stream<ARPEvent> &arp_out,
+             hls::stream<axis_word> &icmp_out,
+             ap_uint<32> &dropped_frames,
+#if ETH_IN_REASSEMBLY
+             const Addresses &loc,
+             const port_table &udp_ports,
+#endif
+             const ap_uint<8> &stats_snapshot,
+             const ap_uint<8> &stats_select,
+             ap_uint<64> &stats_value,
+             const ap_uint<8> &fifo_select,
+             ap_uint<64> &fifo_value) {
+#pragma HLS INLINE
+
+  static DataAligner dataAligner;
+  static DataAligner echoAligner;
+  static EchoBuffer echoBuffer;
+#if ETH_IN_CUT_THROUGH
+  static DataForwarder dataForwarder;
+#else
+  static FrameBuffer frameBuffer;
+#endif
+#if ETH_IN_REASSEMBLY
+  static DataAligner fragmentAligner;
+  static Reassembler reassembler;
+  static FragmentInfo fragment_info;
+#endif
+  static StatCounters<NUM_RX_STATS> stats;
+  static FIFOMonitor fifoMonitors[NUM_RX_FIFOS];
+  Optional<axis_word> payload = NO_WORD;
+  Optional<axis_word> aligned_payload;
+  Optional<axis_word> echo_request = NO_WORD;
+  Optional<axis_word> aligned_echo_request;
+  Optional<axis_word> fragment = NO_WORD;
+  Optional<axis_word> aligned_fragment;
+  ap_uint<1> frame_end = false;
+  ap_uint<1> bad_data = false;
+  ap_uint<1> no_room = false;
+
+  const HandledWord &word = handled_word.some;
+  if (handled_word.is_some()) {
+    frame_end = word.last;
+    bad_data = word.bad_data;
+    if (word.echo_request) {
+      echo_request = word.payload;
+    } else if (word.fragment) {
+      fragment = word.payload;
+    } else {
+      payload = word.payload;
+    }
+#if ETH_IN_REASSEMBLY
+    fragment_info = word.fragment_info;
+#endif
+  }
+  if (frame_end && !bad_data && word.arp_received) {
+    if (arp_out.full()) {
+      no_room = true;
+    } else {
+      arp_out.write(word.arp_event);
+    }
+  }
+
+  // A frame carries either payload, an echo request or a fragment, so each
+  // aligner may delay the end of its own frames only.
+  ap_uint<1> echo_frame_end = frame_end;
+  ap_uint<1> echo_bad_data = bad_data;
+  aligned_echo_request =
+      echoAligner.align(echo_request, echo_frame_end, echo_bad_data);
+  echoBuffer.write(aligned_echo_request);
+  if (echo_frame_end) {
+    echoBuffer.end_frame(echo_bad_data);
+  }
+  echoBuffer.read(icmp_out);
+
+#if ETH_IN_REASSEMBLY
+  ap_uint<1> fragment_frame_end = frame_end;
+  ap_uint<1> fragment_bad_data = bad_data;
+  aligned_fragment =
+      fragmentAligner.align(fragment, fragment_frame_end, fragment_bad_data);
+  reassembler.write(aligned_fragment, fragment_info);
+  if (fragment_frame_end) {
+    reassembler.end_fragment(fragment_bad_data, loc, udp_ports);
   }
-  dataGate.handle(data_buffer, valid_buffer, data_out);
+  reassembler.evict();
+  reassembler.copy();
+#endif
+
+  aligned_payload = dataAligner.align(payload, frame_end, bad_data);
+#if ETH_IN_CUT_THROUGH
+  dataForwarder.handle(aligned_payload, frame_end, bad_data, data_out);
+  dropped_frames = 0;
+#else
+  frameBuffer.write(aligned_payload);
+  if (frame_end && frameBuffer.end_frame(bad_data)) {
+    no_room = true;
+  }
+#if ETH_IN_REASSEMBLY
+  // Datagrams are read out between the frames of the receive buffer
+  if (reassembler.busy() ||
+      (!frameBuffer.busy() && reassembler.datagram_ready())) {
+    reassembler.read(data_out);
+  } else {
+    frameBuffer.read(data_out);
+  }
+#else
+  frameBuffer.read(data_out);
+#endif
+  dropped_frames = frameBuffer.get_dropped_frames();
+  fifoMonitors[RX_WORD_FIFO].update(frameBuffer.get_used_words(),
+                                    frameBuffer.words_full());
+  fifoMonitors[RX_FRAME_FIFO].update(frameBuffer.get_used_frames(),
+                                     frameBuffer.frames_full());
+#endif
+
+  // A dropped frame counts for the first reason found
+  if (frame_end) {
+    stats.add(RX_FRAMES, 1);
+    stats.add(RX_BYTES, word.frame_bytes);
+    stats.add(RX_FRAMES_64 + size_bucket(word.frame_bytes), 1);
+    if (word.phy_error) {
+      stats.add(RX_PHY_ERRORS, 1);
+    } else if (word.fcs_error) {
+      stats.add(RX_FCS_ERRORS, 1);
+    } else if (word.reason == MAC_MISMATCH) {
+      stats.add(RX_MAC_MISMATCHES, 1);
+    } else if (word.reason == VLAN_MISMATCH) {
+      stats.add(RX_VLAN_MISMATCHES, 1);
+    } else if (word.reason == IP_MISMATCH) {
+      stats.add(RX_IP_MISMATCHES, 1);
+    } else if (word.reason == PORT_MISMATCH) {
+      stats.add(RX_PORT_MISMATCHES, 1);
+    } else if (word.reason == UNSUPPORTED ||
+               (!ETH_IN_REASSEMBLY && word.fragment)) {
+      stats.add(RX_UNSUPPORTED, 1);
+    } else if (bad_data) {
+      stats.add(RX_CHECKSUM_ERRORS, 1);
+    } else if (no_room) {
+      stats.add(RX_OVERFLOWS, 1);
+    }
+  }
+  ap_uint<1> snapshot_taken =
+      stats.publish(stats_snapshot, stats_select, stats_value);
+  publish_fifos<NUM_RX_FIFOS>(
+      fifoMonitors, snapshot_taken, fifo_select, fifo_value);
+}
+
+#if ETH_IN_DATAFLOW
+// The stages as processes of their own, connected by streams
+void receive_process(const phy_data &rxd,
+                     const ap_uint<1> &rxerr,
+                     const ap_uint<1> &crsdv,
+                     hls::stream<RxWord> &data_words) {
+#pragma HLS PIPELINE II = 1
+
+  Optional<RxWord> data_word = receive_word(rxd, rxerr, crsdv);
+  if (data_word.is_some()) {
+    data_words.write(data_word.some);
+  }
+}
+
+void check_fcs_process(hls::stream<RxWord> &data_words,
+                       hls::stream<RxWord> &checked_words) {
+#pragma HLS PIPELINE II = 1
+
+  Optional<RxWord> data_word;
+  data_word.type = None;
+  if (!data_words.empty()) {
+    data_word = {Some, data_words.read()};
+  }
+  Optional<RxWord> checked_word = check_fcs(data_word);
+  if (checked_word.is_some()) {
+    checked_words.write(checked_word.some);
+  }
+}
+
+void handle_protocols_process(hls::stream<RxWord> &checked_words,
+                              hls::stream<HandledWord> &handled_words,
+                              const Addresses &loc,
+                              const port_table &udp_ports,
+                              const vlan_table &vlans) {
+#pragma HLS PIPELINE II = 1
+
+  Optional<RxWord> checked_word;
+  checked_word.type = None;
+  if (!checked_words.empty()) {
+    checked_word = {Some, checked_words.read()};
+  }
+  Optional<HandledWord> handled_word =
+      handle_protocols(checked_word, loc, udp_ports, vlans);
+  if (handled_word.is_some()) {
+    handled_words.write(handled_word.some);
+  }
+}
+
+void pass_on_process(hls::stream<HandledWord> &handled_words,
+                     hls::stream<axis_word> &data_out,
+                     hls::stream<ARPEvent> &arp_out,
+                     hls::stream<axis_word> &icmp_out,
+                     ap_uint<32> &dropped_frames,
+#if ETH_IN_REASSEMBLY
+                     const Addresses &loc,
+                     const port_table &udp_ports,
+#endif
+                     const ap_uint<8> &stats_snapshot,
+                     const ap_uint<8> &stats_select,
+                     ap_uint<64> &stats_value,
+                     const ap_uint<8> &fifo_select,
+                     ap_uint<64> &fifo_value) {
+#pragma HLS PIPELINE II = 1
+
+  Optional<HandledWord> handled_word;
+  handled_word.type = None;
+  if (!handled_words.empty()) {
+    handled_word = {Some, handled_words.read()};
+  }
+  pass_on(handled_word,
+          data_out,
+          arp_out,
+          icmp_out,
+          dropped_frames,
+#if ETH_IN_REASSEMBLY
+          loc,
+          udp_ports,
+#endif
+          stats_snapshot,
+          stats_select,
+          stats_value,
+          fifo_select,
+          fifo_value);
+}
+#endif
+
+void eth_in(const phy_data &rxd,
+            const ap_uint<1> &rxerr,
+            const ap_uint<1> &crsdv,
+            hls::stream<axis_word> &data_out,
+            hls::stream<ARPEvent> &arp_out,
+            hls::stream<axis_word> &icmp_out,
+            ap_uint<32> &dropped_frames,
+            const Addresses &loc,
+            const port_table &udp_ports,
+            const vlan_table &vlans,
+            const ap_uint<8> &stats_snapshot,
+            const ap_uint<8> &stats_select,
+            ap_uint<64> &stats_value,
+            const ap_uint<8> &fifo_select,
+            ap_uint<64> &fifo_value) {
+#pragma HLS INTERFACE axis port = data_out
+#pragma HLS INTERFACE axis port = arp_out
+#pragma HLS INTERFACE axis port = icmp_out
+#pragma HLS INTERFACE s_axilite port = udp_ports
+#pragma HLS INTERFACE s_axilite port = vlans
+#pragma HLS INTERFACE s_axilite port = stats_snapshot
+#pragma HLS INTERFACE s_axilite port = stats_select
+#pragma HLS INTERFACE s_axilite port = stats_value
+#pragma HLS INTERFACE s_axilite port = fifo_select
+#pragma HLS INTERFACE s_axilite port = fifo_value
+#pragma HLS DISAGGREGATE variable = loc
+
+#if ETH_IN_DATAFLOW
+  // Without block level control the processes run freely, each of them every
+  // cycle. A process reads a word from its input stream in every cycle there
+  // is one, writes at most one word per cycle and never waits for its outputs:
+  // the buffers of pass_on only write to a stream that is not full. A stream
+  // thus holds at most the word written in a cycle and the one its reader
+  // takes in it, which a depth of 2 covers. The cut-through build waits for a
+  // full data_out like the pipeline of the other builds does.
+#pragma HLS INTERFACE ap_ctrl_none port = return
+#pragma HLS DATAFLOW
+  hls::stream<RxWord> data_words;
+#pragma HLS STREAM variable = data_words depth = 2
+  hls::stream<RxWord> checked_words;
+#pragma HLS STREAM variable = checked_words depth = 2
+  hls::stream<HandledWord> handled_words;
+#pragma HLS STREAM variable = handled_words depth = 2
+
+  receive_process(rxd, rxerr, crsdv, data_words);
+  check_fcs_process(data_words, checked_words);
+  handle_protocols_process(checked_words, handled_words, loc, udp_ports, vlans);
+  pass_on_process(handled_words,
+                  data_out,
+                  arp_out,
+                  icmp_out,
+                  dropped_frames,
+#if ETH_IN_REASSEMBLY
+                  loc,
+                  udp_ports,
+#endif
+                  stats_snapshot,
+                  stats_select,
+                  stats_value,
+                  fifo_select,
+                  fifo_value);
+#else
+#pragma HLS PIPELINE II = 1
+  Optional<RxWord> data_word = receive_word(rxd, rxerr, crsdv);
+  Optional<RxWord> checked_word = check_fcs(data_word);
+  Optional<HandledWord> handled_word =
+      handle_protocols(checked_word, loc, udp_ports, vlans);
+  pass_on(handled_word,
+          data_out,
+          arp_out,
+          icmp_out,
+          dropped_frames,
+#if ETH_IN_REASSEMBLY
+          loc,
+          udp_ports,
+#endif
+          stats_snapshot,
+          stats_select,
+          stats_value,
+          fifo_select,
+          fifo_value);
+#endif
 }
@@ -31,21 +31,94 @@
 #define ETH_IN_HPP
 #pragma once
 
+#include "../utils/ARPEvent.hpp"
 #include "../utils/Addresses.hpp"
 #include "../utils/Optional.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/buffer_word.hpp"
+#include "../utils/phy.hpp"
+#include "../utils/port_table.hpp"
+#include "../utils/vlan_table.hpp"
+#include "ARPPacketHandler.hpp"
 #include "AxisWordGenerator.hpp"
+#include "DataAligner.hpp"
 #include "DataBundler.hpp"
-#include "DataGate.hpp"
+#include "DataForwarder.hpp"
 #include "DataSpotter.hpp"
+#include "EchoBuffer.hpp"
 #include "EthDataHandler.hpp"
 #include "FCSValidator.hpp"
+#include "FrameBuffer.hpp"
+#include "FrameInfo.hpp"
+#include "HandledWord.hpp"
+#include "Reassembler.hpp"
+#include "RxWord.hpp"
+#include "rx_stats.hpp"
 #include <hls_stream.h>
 
-void eth_in(const ap_uint<2> &rxd,
+// With ETH_IN_CUT_THROUGH set, payload is forwarded while the frame is still
+// being received instead of being stored until the frame checks passed. A
+// failed check is then flagged at USER_ERROR_BIT of the last word and the
+// consumer has to discard the frame itself. Otherwise dropped_frames counts
+// the good frames that did not fit into the receive buffer anymore.
+#ifndef ETH_IN_CUT_THROUGH
+#define ETH_IN_CUT_THROUGH 0
+#endif
+
+// With ETH_IN_REASSEMBLY set, fragmented UDP datagrams are reassembled and
+// passed on in one piece between the frames of the receive buffer. Otherwise
+// they are dropped. Reassembly needs the frame checks of the receive buffer.
+#ifndef ETH_IN_REASSEMBLY
+#define ETH_IN_REASSEMBLY 0
+#endif
+
+#if ETH_IN_REASSEMBLY && ETH_IN_CUT_THROUGH
+#error "ETH_IN_REASSEMBLY does not work with ETH_IN_CUT_THROUGH"
+#endif
+
+// With ETH_IN_DATAFLOW set, the stages of eth_in run as processes of their
+// own, connected by shallow streams: the bundling of rxd into words, the frame
+// check sequence, the protocol handlers and the buffers. No path then spans
+// more than one stage, which lets the core run at 125 MHz beside a GMII PHY
+// (see the eth_in_gmii variant of build.tcl and PHY_GMII in phy.hpp). Each
+// stage adds a few cycles of latency. The core then has no block level
+// control and runs from reset on. Otherwise all stages share one pipeline
+// built for 50 MHz.
+#ifndef ETH_IN_DATAFLOW
+#define ETH_IN_DATAFLOW 0
+#endif
+
+// Only payload sent to one of the ports in udp_ports is passed on, tagged with
+// the queue ID of its entry. The table is written over AXI-Lite at runtime.
+// So is vlans, the VLANs tagged frames are accepted from. Their tag is removed
+// and handed on in the user field of the payload (see axis_word).
+// ARP packets sent to loc or broadcast are handed to eth_out over arp_out once
+// their frame passed all checks. So are the ICMP echo requests to loc.ip_addr
+// over icmp_out, from the identifier on and with the sender in the user field.
+// All ports run on the clock of the PHY. The hierarchy of cdc.tcl puts
+// data_out behind an asynchronous FIFO into a clock domain of its own.
+//
+// The frames received and the reasons they were dropped for are counted in
+// the counters of rx_stat. Writing a new value to stats_snapshot takes a
+// snapshot of them and clears them. stats_value then holds the snapshot of
+// the counter in stats_select. The snapshot also covers the values of
+// fifo_stat kept for each FIFO of rx_fifo, of which fifo_value holds the one
+// in fifo_select.
+
+void eth_in(const phy_data &rxd,
             const ap_uint<1> &rxerr,
             const ap_uint<1> &crsdv,
             hls::stream<axis_word> &data_out,
-            const Addresses &loc);
+            hls::stream<ARPEvent> &arp_out,
+            hls::stream<axis_word> &icmp_out,
+            ap_uint<32> &dropped_frames,
+            const Addresses &loc,
+            const port_table &udp_ports,
+            const vlan_table &vlans,
+            const ap_uint<8> &stats_snapshot,
+            const ap_uint<8> &stats_select,
+            ap_uint<64> &stats_value,
+            const ap_uint<8> &fifo_select,
+            ap_uint<64> &fifo_value);
 
 #endif
@@ -27,35 +27,85 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "../utils/ARPEvent.hpp"
 #include "../utils/Addresses.hpp"
+#include "../utils/VLANTag.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/frame_size.hpp"
+#include "../utils/phy.hpp"
+#include "../utils/port_table.hpp"
+#include "../utils/protocols.hpp"
+#include "../utils/test/ARPFrame.hpp"
 #include "../utils/test/Comparison.hpp"
+#include "../utils/test/ETHFrame.hpp"
+#include "../utils/test/ICMPFrame.hpp"
+#include "../utils/test/IPFrame.hpp"
+#include "../utils/test/IPPacket.hpp"
 #include "../utils/test/ITest.hpp"
 #include "../utils/test/InputValueFeed.hpp"
 #include "../utils/test/OutputStreamStore.hpp"
 #include "../utils/test/TimedValue.hpp"
 #include "../utils/test/UDPFrame.hpp"
+#include "../utils/test/UDPPacket.hpp"
+#include "../utils/test/pack_words.hpp"
+#include "../utils/test/report.hpp"
+#include "../utils/vlan_table.hpp"
 #include "eth_in.hpp"
+#include <algorithm>
 #include <ap_int.h>
+#include <iostream>
 #include <string>
 #include <vector>
 
 template <int L> class EthInTest : public ITest {
 public:
-  InputValueFeed<ap_uint<2>, L> rxd_feed;
+  InputValueFeed<phy_data, L> rxd_feed;
   InputValueFeed<ap_uint<1>, L> rxerr_feed;
   InputValueFeed<ap_uint<1>, L> crsdv_feed;
   OutputStreamStore<axis_word> data_out_store;
+  OutputStreamStore<ARPEvent> arp_out_store;
+  OutputStreamStore<axis_word> icmp_out_store;
+  ap_uint<32> dropped_frames;
   Addresses loc;
+  port_table udp_ports;
+  vlan_table vlans;
+  ap_uint<64> stats_value;
+  ap_uint<64> fifo_value;
   EthInTest(const std::string &title,
-            const std::vector<ap_uint<2> > &rxd_tv,
+            const std::vector<phy_data> &rxd_tv,
             const std::vector<ap_uint<1> > &rxerr_tv,
             const std::vector<ap_uint<1> > &crsdv_tv,
-            const std::vector<TimedValue<axis_word> > &data_out_tv,
-            const Addresses &loc)
+            const std::vector<TimedValue<byte_word> > &data_out_tv,
+            const Addresses &loc,
+            const port_table &udp_ports,
+            const std::vector<TimedValue<ARPEvent> > &arp_out_tv = {},
+            const std::vector<TimedValue<byte_word> > &icmp_out_tv = {},
+            const vlan_table &vlans = 0)
       : ITest(title), rxd_feed(rxd_tv, 0), rxerr_feed(rxerr_tv, 0),
-        crsdv_feed(crsdv_tv, 0), data_out_store("DATA", data_out_tv, 1),
-        loc(loc) {}
+        crsdv_feed(crsdv_tv, 0),
+        // The receive buffer reads the words of a frame out back to back,
+        // cut-through passes each word on at the index of its bytes.
+        data_out_store("DATA",
+                       ETH_IN_CUT_THROUGH ? pack_words(data_out_tv)
+                                          : pack_read_out_words(data_out_tv),
+                       1),
+        arp_out_store("ARP", arp_out_tv, 1, false),
+        icmp_out_store("ICMP", pack_words(icmp_out_tv), 1, false), loc(loc),
+        udp_ports(udp_ports), vlans(vlans) {}
+  // Listens on the port of loc only
+  EthInTest(const std::string &title,
+            const std::vector<phy_data> &rxd_tv,
+            const std::vector<ap_uint<1> > &rxerr_tv,
+            const std::vector<ap_uint<1> > &crsdv_tv,
+            const std::vector<TimedValue<byte_word> > &data_out_tv,
+            const Addresses &loc)
+      : EthInTest(title,
+                  rxd_tv,
+                  rxerr_tv,
+                  crsdv_tv,
+                  data_out_tv,
+                  loc,
+                  port_table(loc.udp_port)) {}
   void feed_inputs(int step_index) override {
     this->rxd_feed.feed(step_index);
     this->rxerr_feed.feed(step_index);
@@ -63,16 +113,196 @@ public:
   }
   void store_outputs(int step_index) override {
     this->data_out_store.store(step_index);
+    this->arp_out_store.store(step_index);
+    this->icmp_out_store.store(step_index);
   }
 
 private:
   std::vector<Comparison> get_comparisons() override {
-    return {this->data_out_store.get_comparison()};
+    return {this->data_out_store.get_comparison(),
+            this->arp_out_store.get_comparison(),
+            this->icmp_out_store.get_comparison()};
   }
 };
 
+// Runs eth_in on the inputs of the test for L cycles and returns the number of
+// errors found
+template <int L> int run(EthInTest<L> &test) {
+  for (int j = 0; j < L; j++) {
+    test.feed_inputs(j);
+    eth_in(test.rxd_feed.value,
+           test.rxerr_feed.value,
+           test.crsdv_feed.value,
+           test.data_out_store.stream,
+           test.arp_out_store.stream,
+           test.icmp_out_store.stream,
+           test.dropped_frames,
+           test.loc,
+           test.udp_ports,
+           test.vlans,
+           0,
+           0,
+           test.stats_value,
+           0,
+           test.fifo_value);
+    test.store_outputs(j);
+  }
+  return test.get_result();
+}
+
+// Frame written to the receive buffer, one word per cycle from cycle start on.
+// Byte i of its payload is first + i.
+struct BufferedFrame {
+  int start;
+  int payload_bytes;
+  ap_uint<8> first;
+  bool bad_data;
+};
+
+std::vector<TimedValue<byte_word> > get_bytes(const BufferedFrame &frame) {
+  const Addresses src = {0x123456789abc, 0x13579bdf, 0xde60};
+  std::vector<TimedValue<byte_word> > bytes;
+  for (int i = 0; i < frame.payload_bytes; i++) {
+    bytes.push_back({0, {frame.first + i, i == frame.payload_bytes - 1, src}});
+  }
+  return bytes;
+}
+
+// Drives the receive buffer on its own. Its reader is stalled up to cycle
+// read_start, as behind a consumer that does not take data_out, so the buffer
+// fills up. Only the order of the words read is checked, together with the
+// count of the good frames dropped for lack of room.
+template <int L> class FrameBufferTest : public ITest {
+public:
+  OutputStreamStore<axis_word> data_out_store;
+  FrameBufferTest(const std::string &title,
+                  const std::vector<BufferedFrame> &frames,
+                  int read_start,
+                  const std::vector<int> &kept_frames,
+                  const ap_uint<32> &dropped_frames)
+      : ITest(title),
+        data_out_store("DATA", get_words(frames, kept_frames), 1, false),
+        frames(frames), read_start(read_start),
+        dropped_frames(dropped_frames) {
+    for (const BufferedFrame &frame : frames) {
+      this->frame_words.push_back(pack_words(get_bytes(frame)));
+    }
+  }
+  void feed_inputs(int step_index) override {
+    for (int i = 0; i < this->frames.size(); i++) {
+      int word = step_index - this->frames[i].start;
+      if (word >= 0 && word < this->frame_words[i].size()) {
+        this->frameBuffer.write({Some, this->frame_words[i][word].value});
+        if (word == this->frame_words[i].size() - 1) {
+          this->frameBuffer.end_frame(this->frames[i].bad_data);
+        }
+      }
+    }
+  }
+  void store_outputs(int step_index) override {
+    if (step_index >= this->read_start) {
+      this->frameBuffer.read(this->data_out_store.stream);
+    }
+    this->data_out_store.store(step_index);
+  }
+
+private:
+  FrameBuffer frameBuffer;
+  std::vector<BufferedFrame> frames;
+  std::vector<std::vector<TimedValue<axis_word> > > frame_words;
+  int read_start;
+  ap_uint<32> dropped_frames;
+  static std::vector<TimedValue<axis_word> >
+  get_words(const std::vector<BufferedFrame> &frames,
+            const std::vector<int> &kept_frames) {
+    std::vector<TimedValue<byte_word> > bytes;
+    for (int i : kept_frames) {
+      std::vector<TimedValue<byte_word> > frame_bytes = get_bytes(frames[i]);
+      bytes.insert(bytes.end(), frame_bytes.begin(), frame_bytes.end());
+    }
+    return pack_words(bytes);
+  }
+  std::vector<Comparison> get_comparisons() override {
+    return {this->data_out_store.get_comparison(),
+            Comparison("DROPPED",
+                       std::vector<ap_uint<32> >{this->dropped_frames},
+                       std::vector<ap_uint<32> >{
+                           this->frameBuffer.get_dropped_frames()},
+                       1)};
+  }
+};
+
+// Cycles of a frame of the smallest size, with preamble and SFD, and of the
+// smallest inter packet gap
+const int MIN_FRAME_CYCLES = PHY_CYCLES_PER_BYTE * (8 + 64);
+const int IPG_CYCLES = PHY_CYCLES_PER_BYTE * 12;
+
+// Sends the UDP packet in IP fragments of fragment_bytes each, in the given
+// order and one inter packet gap apart
+void send_fragmented(const Addresses &src,
+                     const Addresses &dst,
+                     const std::vector<ap_uint<8> > &udp_packet,
+                     int fragment_bytes,
+                     const std::vector<int> &order,
+                     std::vector<phy_data> &rxd,
+                     std::vector<ap_uint<1> > &crsdv,
+                     const ap_uint<16> &id = 0x1234) {
+  for (int i : order) {
+    int begin = i * fragment_bytes;
+    int end = std::min(begin + fragment_bytes, (int)udp_packet.size());
+    ap_uint<16> flags_and_offset = begin / 8;
+    if (end < udp_packet.size()) {
+      flags_and_offset |= IP_MORE_FRAGMENTS;
+    }
+    std::vector<phy_data> frame = IPFrame(
+        src,
+        dst,
+        UDP,
+        std::vector<ap_uint<8> >(udp_packet.begin() + begin,
+                                 udp_packet.begin() + end),
+        id,
+        flags_and_offset);
+    rxd.insert(rxd.end(), frame.begin(), frame.end());
+    rxd.insert(rxd.end(), IPG_CYCLES, 0);
+    crsdv.insert(crsdv.end(), frame.size(), 1);
+    crsdv.insert(crsdv.end(), IPG_CYCLES, 0);
+  }
+}
+
+// Takes a snapshot of the statistics of eth_in by a change of stats_snapshot
+// to snapshot and reads out the counters, one per cycle
+std::vector<ap_uint<64> > read_stats(const Addresses &loc,
+                                     const ap_uint<8> &snapshot) {
+  hls::stream<axis_word> data_out;
+  hls::stream<ARPEvent> arp_out;
+  hls::stream<axis_word> icmp_out;
+  ap_uint<32> dropped_frames;
+  ap_uint<64> fifo_value;
+  std::vector<ap_uint<64> > values(NUM_RX_STATS);
+  for (int i = 0; i < NUM_RX_STATS; i++) {
+    eth_in(0,
+           0,
+           0,
+           data_out,
+           arp_out,
+           icmp_out,
+           dropped_frames,
+           loc,
+           port_table(loc.udp_port),
+           0,
+           snapshot,
+           i,
+           values[i],
+           0,
+           fifo_value);
+  }
+  return values;
+}
+
 int main() {
-  const int NUM_CYCLES = 400;
+  // Long enough for the largest frame to be received and its payload passed on
+  const int NUM_CYCLES =
+      PHY_CYCLES_PER_BYTE * (8 + MAX_FRAME_BYTES) + MAX_UDP_PAYLOAD_BYTES + 100;
   std::vector<EthInTest<NUM_CYCLES> > tests;
   int errors = 0;
 
@@ -81,7 +311,7 @@ int main() {
 
   const Addresses real_loc = {0xaaaaaaaaaaaa, 0xa9fecd01, 0x0035};
   const Addresses real_src = {0xd89ef3fbcf15, 0xa9fecda9, 0xe5b8};
-  std::vector<ap_uint<2> > real(
+  std::vector<phy_data> real = to_phy_data(
       {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
        1, 1, 1, 1, 1, 1, 1, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
        2, 2, 2, 2, 2, 2, 2, 2, 0, 2, 1, 3, 2, 3, 1, 2, 3, 0, 3, 3, 3, 2, 3, 3,
@@ -97,76 +327,735 @@ int main() {
   tests.push_back({"Real world example packet",
                    real,
                    {},
-                   std::vector<ap_uint<1> >(288, 1),
-                   {{288, {0xaa, true, real_src}}},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {{MIN_FRAME_CYCLES, {0xaa, true, real_src}}},
                    real_loc});
 
   tests.push_back({"Normal packet",
                    UDPFrame(src, loc, {0xaa}),
                    {},
-                   std::vector<ap_uint<1> >(288, 1),
-                   {{288, {0xaa, true, src}}},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {{MIN_FRAME_CYCLES, {0xaa, true, src}}},
+                   loc});
+
+#if PHY_GMII
+  // Only a single byte of the preamble is left ahead of the SFD
+  const int SHORTENED_CYCLES = MIN_FRAME_CYCLES - 6;
+  std::vector<phy_data> rxd_shortened = UDPFrame(src, loc, {0xaa});
+  rxd_shortened.erase(rxd_shortened.begin(), rxd_shortened.begin() + 6);
+  tests.push_back({"Normal packet - shortened preamble",
+                   rxd_shortened,
+                   {},
+                   std::vector<ap_uint<1> >(SHORTENED_CYCLES, 1),
+                   {{SHORTENED_CYCLES, {0xaa, true, src}}},
                    loc});
+#endif
 
-  std::vector<ap_uint<2> > rxd_delay = UDPFrame(src, loc, {0xaa});
+  std::vector<phy_data> rxd_delay = UDPFrame(src, loc, {0xaa});
   rxd_delay.insert(rxd_delay.begin(), {0, 0, 0, 0});
   tests.push_back({"Normal packet - delayed rxd",
                    rxd_delay,
                    {},
-                   std::vector<ap_uint<1> >(292, 1),
-                   {{292, {0xaa, true, src}}},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES + 4, 1),
+                   {{MIN_FRAME_CYCLES + 4, {0xaa, true, src}}},
                    loc});
 
-  std::vector<ap_uint<2> > rxd_wrong_fcs(rxd_delay);
-  rxd_wrong_fcs[254].b_not();
+  std::vector<ap_uint<8> > long_payload;
+  for (int i = 0; i < 32; i++) {
+    long_payload.push_back(i);
+  }
+  std::vector<phy_data> rxd_long = UDPFrame(src, loc, long_payload);
+  std::vector<TimedValue<byte_word> > long_out;
+  for (int i = 0; i < 32; i++) {
+#if ETH_IN_CUT_THROUGH
+    // The payload starts at byte 42 of the frame. A word is passed on once
+    // the frame check sequence validator got the 4 / DATAPATH_BYTES + 1 words
+    // of the frame after the one of its last byte, or else with the end of the
+    // frame. The last word waits for the frame check sequence.
+    int word = i / DATAPATH_BYTES;
+    int frame_word = (42 + (word + 1) * DATAPATH_BYTES - 1) / DATAPATH_BYTES +
+                     4 / DATAPATH_BYTES + 1;
+    int index = std::min<int>(
+        PHY_CYCLES_PER_BYTE * (8 + (frame_word + 1) * DATAPATH_BYTES),
+        rxd_long.size());
+    long_out.push_back(
+        {word < 31 / DATAPATH_BYTES ? index : rxd_long.size() + 1,
+         {i, i == 31, src}});
+#else
+    long_out.push_back({rxd_long.size() + i, {i, i == 31, src}});
+#endif
+  }
+  tests.push_back({"Long packet",
+                   rxd_long,
+                   {},
+                   std::vector<ap_uint<1> >(rxd_long.size(), 1),
+                   long_out,
+                   loc});
+
+#if !ETH_IN_CUT_THROUGH
+  std::vector<ap_uint<8> > largest_payload;
+  for (int i = 0; i < MAX_UDP_PAYLOAD_BYTES; i++) {
+    largest_payload.push_back(i);
+  }
+  std::vector<phy_data> rxd_largest = UDPFrame(src, loc, largest_payload);
+  std::vector<TimedValue<byte_word> > largest_out;
+  // Unless the receive buffer has no room for it
+  int largest_words =
+      (MAX_UDP_PAYLOAD_BYTES + DATAPATH_BYTES - 1) / DATAPATH_BYTES;
+  for (int i = 0; largest_words < RX_BUFFER_WORDS && i < largest_payload.size();
+       i++) {
+    largest_out.push_back(
+        {rxd_largest.size() + i,
+         {largest_payload[i], i == largest_payload.size() - 1, src}});
+  }
+  tests.push_back({"Packet of the largest frame size",
+                   rxd_largest,
+                   {},
+                   std::vector<ap_uint<1> >(rxd_largest.size(), 1),
+                   largest_out,
+                   loc});
+#endif
+
+  std::vector<phy_data> rxd_wrong_fcs(rxd_delay);
+  rxd_wrong_fcs[4 + PHY_CYCLES_PER_BYTE * 62 + PHY_CYCLES_PER_BYTE / 2].b_not();
+#if ETH_IN_CUT_THROUGH
+  byte_word flagged_word(0xaa, true, src);
+  flagged_word.user[USER_ERROR_BIT] = true;
   tests.push_back({"Wrong frame check sequence - delayed rxd",
                    rxd_wrong_fcs,
                    {},
-                   std::vector<ap_uint<1> >(292, 1),
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES + 4, 1),
+                   {{MIN_FRAME_CYCLES + 4, flagged_word}},
+                   loc});
+#else
+  tests.push_back({"Wrong frame check sequence - delayed rxd",
+                   rxd_wrong_fcs,
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES + 4, 1),
                    {},
                    loc});
+#endif
+
+  std::vector<phy_data> rxd_burst;
+  std::vector<ap_uint<1> > crsdv_burst;
+  std::vector<TimedValue<byte_word> > burst_out;
+  for (int i = 0; i < 8; i++) {
+    std::vector<phy_data> frame = UDPFrame(src, loc, {i});
+    rxd_burst.insert(rxd_burst.end(), frame.begin(), frame.end());
+    crsdv_burst.insert(crsdv_burst.end(), frame.size(), 1);
+    burst_out.push_back({rxd_burst.size(), {i, true, src}});
+    rxd_burst.insert(rxd_burst.end(), IPG_CYCLES, 0);
+    crsdv_burst.insert(crsdv_burst.end(), IPG_CYCLES, 0);
+  }
+  tests.push_back({"Burst of frames of the smallest size",
+                   rxd_burst,
+                   {},
+                   crsdv_burst,
+                   burst_out,
+                   loc});
 
   const Addresses dst_wrong_mac = {0xbbbbbbbbbbbc, 0x22222222, 0x0035};
-  std::vector<ap_uint<2> > rxd_wrong_mac = UDPFrame(src, dst_wrong_mac, {0xaa});
+  std::vector<phy_data> rxd_wrong_mac = UDPFrame(src, dst_wrong_mac, {0xaa});
   rxd_wrong_mac.insert(rxd_wrong_mac.begin(), {0, 0, 0, 0});
   tests.push_back({"Wrong destination mac address",
                    rxd_wrong_mac,
                    {},
-                   std::vector<ap_uint<1> >(292, 1),
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES + 4, 1),
                    {},
                    loc});
 
   const Addresses dst_wrong_ip = {0xbbbbbbbbbbbb, 0x22222223, 0x0035};
-  std::vector<ap_uint<2> > rxd_wrong_ip = UDPFrame(src, dst_wrong_ip, {0xaa});
+  std::vector<phy_data> rxd_wrong_ip = UDPFrame(src, dst_wrong_ip, {0xaa});
   rxd_wrong_ip.insert(rxd_wrong_ip.begin(), {0, 0, 0, 0});
   tests.push_back({"Wrong destination ip address",
                    rxd_wrong_ip,
                    {},
-                   std::vector<ap_uint<1> >(292, 1),
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES + 4, 1),
                    {},
                    loc});
 
   const Addresses dst_wrong_udp = {0xbbbbbbbbbbbb, 0x22222222, 0x0040};
-  std::vector<ap_uint<2> > rxd_wrong_udp = UDPFrame(src, dst_wrong_udp, {0xaa});
+  std::vector<phy_data> rxd_wrong_udp = UDPFrame(src, dst_wrong_udp, {0xaa});
   rxd_wrong_udp.insert(rxd_wrong_udp.begin(), {0, 0, 0, 0});
   tests.push_back({"Wrong destination udp port",
                    rxd_wrong_udp,
                    {},
-                   std::vector<ap_uint<1> >(292, 1),
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES + 4, 1),
+                   {},
+                   loc});
+
+  const Addresses loc_second_port = {loc.mac_addr, loc.ip_addr, 0x1234};
+  port_table two_ports = loc.udp_port;
+  two_ports(31, 16) = loc_second_port.udp_port;
+  byte_word second_queue_word(0xaa, true, src);
+  second_queue_word.user(USER_QUEUE_HIGH, USER_QUEUE_LOW) = 1;
+  tests.push_back({"Second udp port of the port table",
+                   UDPFrame(src, loc_second_port, {0xaa}),
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {{MIN_FRAME_CYCLES, second_queue_word}},
+                   loc,
+                   two_ports});
+
+  const ARPEvent request = {
+      ARP_REQUEST, src.mac_addr, src.ip_addr, loc.ip_addr};
+  tests.push_back({"ARP request",
+                   ARPFrame(ARP_REQUEST, src, loc),
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {},
+                   loc,
+                   port_table(loc.udp_port),
+                   {{0, request}}});
+
+  const ARPEvent reply = {ARP_REPLY, src.mac_addr, src.ip_addr, loc.ip_addr};
+  tests.push_back({"ARP reply",
+                   ARPFrame(ARP_REPLY, src, loc),
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {},
+                   loc,
+                   port_table(loc.udp_port),
+                   {{0, reply}}});
+
+  tests.push_back({"ARP reply to another mac address",
+                   ARPFrame(ARP_REPLY, src, dst_wrong_mac),
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
                    {},
                    loc});
 
+  // Identifier, sequence number and data of an echo request
+  const std::vector<ap_uint<8> > echo{
+      0x12, 0x34, 0x00, 0x01, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77};
+  const Addresses src_ip = {src.mac_addr, src.ip_addr, 0};
+  std::vector<TimedValue<byte_word> > echo_out;
+  for (int i = 0; i < echo.size(); i++) {
+    echo_out.push_back({0, {echo[i], i == echo.size() - 1, src_ip}});
+  }
+  tests.push_back({"Ping",
+                   ICMPFrame(src, loc, ICMP_ECHO_REQUEST, echo),
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {},
+                   loc,
+                   port_table(loc.udp_port),
+                   {},
+                   echo_out});
+
+  std::vector<ap_uint<8> > wrong_echo(ICMPPacket(ICMP_ECHO_REQUEST, echo));
+  wrong_echo[3] ^= 1;
+  tests.push_back({"Ping with wrong checksum",
+                   IPFrame(src, loc, ICMP, wrong_echo),
+                   {},
+                   std::vector<ap_uint<1> >(MIN_FRAME_CYCLES, 1),
+                   {},
+                   loc});
+
+  // Priority 6 in VLAN 5
+  const VLANTag vlan = {1, 0xC005};
+  std::vector<phy_data> rxd_tagged = ETHFrame(
+      src,
+      loc,
+      IPv4,
+      IPPacket(src, loc, UDP, UDPPacket(src, loc, {0xaa})),
+      vlan);
+  byte_word tagged_word(0xaa, true, src);
+  byte_word::set_vlan(tagged_word.user, vlan);
+  tests.push_back({"VLAN tagged packet",
+                   rxd_tagged,
+                   {},
+                   std::vector<ap_uint<1> >(rxd_tagged.size(), 1),
+                   {{rxd_tagged.size(), tagged_word}},
+                   loc,
+                   port_table(loc.udp_port),
+                   {},
+                   {},
+                   vlan_table(5)});
+
+  tests.push_back({"VLAN missing in the VLAN table",
+                   rxd_tagged,
+                   {},
+                   std::vector<ap_uint<1> >(rxd_tagged.size(), 1),
+                   {},
+                   loc,
+                   port_table(loc.udp_port),
+                   {},
+                   {},
+                   vlan_table(6)});
+
+  const ARPEvent tagged_request = {
+      ARP_REQUEST, src.mac_addr, src.ip_addr, loc.ip_addr, vlan};
+  std::vector<phy_data> rxd_tagged_request(
+      ARPFrame(ARP_REQUEST, src, loc, vlan));
+  tests.push_back({"VLAN tagged ARP request",
+                   rxd_tagged_request,
+                   {},
+                   std::vector<ap_uint<1> >(rxd_tagged_request.size(), 1),
+                   {},
+                   loc,
+                   port_table(loc.udp_port),
+                   {{0, tagged_request}},
+                   {},
+                   vlan_table(5)});
+
+#if ETH_IN_REASSEMBLY
+  std::vector<ap_uint<8> > datagram;
+  for (int i = 0; i < 40; i++) {
+    datagram.push_back(i);
+  }
+  const std::vector<ap_uint<8> > udp_packet = UDPPacket(src, loc, datagram);
+  // Cycles after the frame of the last fragment until its staged words are in
+  // the storage and the datagram can be read out
+  const int COPY_CYCLES = 16 / DATAPATH_BYTES - 1;
+
+  std::vector<phy_data> rxd_fragments;
+  std::vector<ap_uint<1> > crsdv_fragments;
+  send_fragmented(
+      src, loc, udp_packet, 16, {0, 1, 2}, rxd_fragments, crsdv_fragments);
+  // Read out once the last fragment is copied to the storage
+  std::vector<TimedValue<byte_word> > datagram_out;
+  for (int i = 0; i < datagram.size(); i++) {
+    datagram_out.push_back(
+        {rxd_fragments.size() - IPG_CYCLES + COPY_CYCLES + i,
+         {datagram[i], i == datagram.size() - 1, src}});
+  }
+  tests.push_back({"Fragmented datagram",
+                   rxd_fragments,
+                   {},
+                   crsdv_fragments,
+                   datagram_out,
+                   loc});
+
+  std::vector<phy_data> rxd_shuffled;
+  std::vector<ap_uint<1> > crsdv_shuffled;
+  send_fragmented(
+      src, loc, udp_packet, 16, {2, 0, 1}, rxd_shuffled, crsdv_shuffled);
+  tests.push_back({"Fragmented datagram - fragments out of order",
+                   rxd_shuffled,
+                   {},
+                   crsdv_shuffled,
+                   datagram_out,
+                   loc});
+
+  std::vector<ap_uint<8> > wrong_udp_packet(udp_packet);
+  wrong_udp_packet[20] ^= 1;
+  std::vector<phy_data> rxd_wrong_checksum;
+  std::vector<ap_uint<1> > crsdv_wrong_checksum;
+  send_fragmented(src,
+                  loc,
+                  wrong_udp_packet,
+                  16,
+                  {0, 1, 2},
+                  rxd_wrong_checksum,
+                  crsdv_wrong_checksum);
+  tests.push_back({"Fragmented datagram with wrong checksum",
+                   rxd_wrong_checksum,
+                   {},
+                   crsdv_wrong_checksum,
+                   {},
+                   loc});
+
+  // A copy of the first fragment with other bytes and a wrong FCS leaves the
+  // bytes received before alone
+  std::vector<phy_data> rxd_bad_copy;
+  std::vector<ap_uint<1> > crsdv_bad_copy;
+  send_fragmented(
+      src, loc, udp_packet, 16, {0, 1, 0}, rxd_bad_copy, crsdv_bad_copy);
+  int bad_copy_start = rxd_bad_copy.size() - rxd_fragments.size() / 3;
+  rxd_bad_copy[bad_copy_start + PHY_CYCLES_PER_BYTE * (8 + 14 + 20 + 10)] ^= 1;
+  send_fragmented(src, loc, udp_packet, 16, {2}, rxd_bad_copy, crsdv_bad_copy);
+  std::vector<TimedValue<byte_word> > bad_copy_out;
+  for (int i = 0; i < datagram.size(); i++) {
+    bad_copy_out.push_back({rxd_bad_copy.size() - IPG_CYCLES + COPY_CYCLES + i,
+                            {datagram[i], i == datagram.size() - 1, src}});
+  }
+  tests.push_back({"Fragmented datagram - bad copy of a fragment",
+                   rxd_bad_copy,
+                   {},
+                   crsdv_bad_copy,
+                   bad_copy_out,
+                   loc});
+
+  // One datagram more than there are contexts, each started before any is
+  // complete. The last one finds no context for its first fragment.
+  std::vector<phy_data> rxd_contexts;
+  std::vector<ap_uint<1> > crsdv_contexts;
+  std::vector<TimedValue<byte_word> > contexts_out;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j <= REASSEMBLY_CONTEXTS; j++) {
+      std::vector<ap_uint<8> > contexts_datagram(datagram);
+      contexts_datagram[0] = j;
+      send_fragmented(src,
+                      loc,
+                      UDPPacket(src, loc, contexts_datagram),
+                      16,
+                      {i},
+                      rxd_contexts,
+                      crsdv_contexts,
+                      j);
+      if (i == 2 && j < REASSEMBLY_CONTEXTS) {
+        for (int k = 0; k < datagram.size(); k++) {
+          contexts_out.push_back(
+              {rxd_contexts.size() - IPG_CYCLES + COPY_CYCLES + k,
+               {contexts_datagram[k], k == datagram.size() - 1, src}});
+        }
+      }
+    }
+  }
+  tests.push_back({"Fragmented datagrams - out of contexts",
+                   rxd_contexts,
+                   {},
+                   crsdv_contexts,
+                   contexts_out,
+                   loc});
+#else
+  std::vector<ap_uint<8> > datagram(40, 0x5a);
+  std::vector<phy_data> rxd_fragments;
+  std::vector<ap_uint<1> > crsdv_fragments;
+  send_fragmented(src,
+                  loc,
+                  UDPPacket(src, loc, datagram),
+                  16,
+                  {0, 1, 2},
+                  rxd_fragments,
+                  crsdv_fragments);
+  tests.push_back({"Fragmented datagram dropped",
+                   rxd_fragments,
+                   {},
+                   crsdv_fragments,
+                   {},
+                   loc});
+#endif
+
   for (int i = 0; i < tests.size(); i++) {
-    for (int j = 0; j < NUM_CYCLES; j++) {
-      tests[i].feed_inputs(j);
-      eth_in(tests[i].rxd_feed.value,
-             tests[i].rxerr_feed.value,
-             tests[i].crsdv_feed.value,
-             tests[i].data_out_store.stream,
-             tests[i].loc);
-      tests[i].store_outputs(j);
+    errors += run(tests[i]);
+  }
+
+#if ETH_IN_REASSEMBLY
+  // A datagram of more than REASSEMBLY_BYTES is dropped, the one behind it
+  // is passed on
+  {
+    const int LARGEST_FRAGMENT_BYTES = (MAX_IP_PACKET_BYTES - 20) / 8 * 8;
+    const int LARGE_CYCLES =
+        PHY_CYCLES_PER_BYTE * (2 * REASSEMBLY_BYTES + MAX_FRAME_BYTES);
+    std::vector<ap_uint<8> > large_datagram(REASSEMBLY_BYTES, 0x5a);
+    std::vector<phy_data> rxd_large;
+    std::vector<ap_uint<1> > crsdv_large;
+    std::vector<int> large_order;
+    for (int i = 0; i * LARGEST_FRAGMENT_BYTES < REASSEMBLY_BYTES + 8; i++) {
+      large_order.push_back(i);
+    }
+    send_fragmented(src,
+                    loc,
+                    UDPPacket(src, loc, large_datagram),
+                    LARGEST_FRAGMENT_BYTES,
+                    large_order,
+                    rxd_large,
+                    crsdv_large,
+                    1);
+    // A frame is passed on a word per cycle once it is received, which with
+    // a byte per word on GMII is no faster than it arrives. The large frames
+    // are given the time to drain before the small ones behind them.
+    rxd_large.insert(rxd_large.end(), MAX_FRAME_BYTES / DATAPATH_BYTES, 0);
+    crsdv_large.resize(rxd_large.size(), 0);
+    send_fragmented(
+        src, loc, udp_packet, 16, {0, 1, 2}, rxd_large, crsdv_large, 2);
+    std::vector<TimedValue<byte_word> > large_out;
+    for (int i = 0; i < datagram.size(); i++) {
+      large_out.push_back({rxd_large.size() - IPG_CYCLES + COPY_CYCLES + i,
+                           {datagram[i], i == datagram.size() - 1, src}});
+    }
+    EthInTest<LARGE_CYCLES> large_test(
+        "Fragmented datagram of more than REASSEMBLY_BYTES",
+        rxd_large,
+        {},
+        crsdv_large,
+        large_out,
+        loc);
+    errors += run(large_test);
+  }
+
+#if REASSEMBLY_TIMEOUT_CYCLES <= 100000
+  // The first fragment is given up before the others arrive, so they do not
+  // make up a datagram. Only variants with a short timeout get there in time
+  // (see build.tcl).
+  {
+    const int TIMEOUT_CYCLES =
+        REASSEMBLY_TIMEOUT_CYCLES + 8 * MIN_FRAME_CYCLES;
+    std::vector<phy_data> rxd_timeout;
+    std::vector<ap_uint<1> > crsdv_timeout;
+    send_fragmented(
+        src, loc, udp_packet, 16, {0}, rxd_timeout, crsdv_timeout);
+    rxd_timeout.insert(
+        rxd_timeout.end(), REASSEMBLY_TIMEOUT_CYCLES + REASSEMBLY_CONTEXTS, 0);
+    crsdv_timeout.resize(rxd_timeout.size(), 0);
+    send_fragmented(
+        src, loc, udp_packet, 16, {1, 2}, rxd_timeout, crsdv_timeout);
+    EthInTest<TIMEOUT_CYCLES> timeout_test(
+        "Fragmented datagram timed out",
+        rxd_timeout,
+        {},
+        crsdv_timeout,
+        {},
+        loc);
+    errors += run(timeout_test);
+  }
+#endif
+#endif
+
+#if !ETH_IN_CUT_THROUGH
+  // Frames of a quarter of the receive buffer each, of which three fit. One
+  // entry of each ring stays empty.
+  {
+    const int BUFFER_CYCLES = 3 * RX_BUFFER_WORDS + 2 * RX_BUFFER_FRAMES;
+    const int QUARTER_BYTES = RX_BUFFER_BYTES / 4;
+    const int QUARTER_WORDS = QUARTER_BYTES / DATAPATH_BYTES;
+    const int FRAME_WORDS = (100 + DATAPATH_BYTES - 1) / DATAPATH_BYTES;
+    std::vector<FrameBufferTest<BUFFER_CYCLES> > buffer_tests;
+
+    buffer_tests.push_back({"Receive buffer - bad frame rolled back",
+                            {{0, 100, 0x00, false},
+                             {FRAME_WORDS, 100, 0x40, true},
+                             {2 * FRAME_WORDS, 100, 0x80, false}},
+                            0,
+                            {0, 2},
+                            0});
+
+    buffer_tests.push_back(
+        {"Receive buffer - out of room for payload",
+         {{0, QUARTER_BYTES, 0x00, false},
+          {QUARTER_WORDS, QUARTER_BYTES, 0x40, false},
+          {2 * QUARTER_WORDS, QUARTER_BYTES, 0x80, false},
+          {3 * QUARTER_WORDS, QUARTER_BYTES, 0xc0, false},
+          {7 * QUARTER_WORDS + 10, QUARTER_BYTES, 0x20, false}},
+         4 * QUARTER_WORDS,
+         {0, 1, 2, 4},
+         1});
+
+    std::vector<BufferedFrame> smallest_frames;
+    std::vector<int> kept_smallest_frames;
+    for (int i = 0; i <= RX_BUFFER_FRAMES; i++) {
+      smallest_frames.push_back({i, 1, i, false});
+      if (i < RX_BUFFER_FRAMES - 1) {
+        kept_smallest_frames.push_back(i);
+      }
+    }
+    buffer_tests.push_back({"Receive buffer - out of room for frames",
+                            smallest_frames,
+                            RX_BUFFER_FRAMES + 1,
+                            kept_smallest_frames,
+                            2});
+
+    for (int i = 0; i < buffer_tests.size(); i++) {
+      for (int j = 0; j < BUFFER_CYCLES; j++) {
+        buffer_tests[i].feed_inputs(j);
+        buffer_tests[i].store_outputs(j);
+      }
+      errors += buffer_tests[i].get_result();
+    }
+  }
+#endif
+
+  // Every frame is counted, a dropped one also for the reason it was dropped
+  // for
+  {
+    std::vector<ap_uint<8> > stats_payload(200, 0x55);
+    std::vector<phy_data> fcs_error = UDPFrame(src, loc, {0xaa});
+    fcs_error.back() ^= 1;
+    std::vector<ap_uint<8> > bad_udp_packet = UDPPacket(src, loc, {0xaa});
+    bad_udp_packet.back() ^= 1;
+    const Addresses other_mac = {0xbbbbbbbbbbbb, loc.ip_addr, loc.udp_port};
+    const Addresses other_ip = {loc.mac_addr, 0x98765433, loc.udp_port};
+    const Addresses other_port = {loc.mac_addr, loc.ip_addr, 0x0036};
+    const std::vector<std::vector<phy_data> > frames = {
+        UDPFrame(src, loc, stats_payload),
+        UDPFrame(src, loc, {0xaa}),
+        fcs_error,
+        UDPFrame(src, other_mac, {0xaa}),
+        ETHFrame(src,
+                 loc,
+                 IPv4,
+                 IPPacket(src, loc, UDP, UDPPacket(src, loc, {0xaa})),
+                 {1, 0x0006}),
+        UDPFrame(src, other_ip, {0xaa}),
+        UDPFrame(src, other_port, {0xaa}),
+        ETHFrame(src, loc, 0x86DD, {0xaa}),
+        IPFrame(src, loc, UDP, bad_udp_packet)};
+    std::vector<ap_uint<64> > expected(NUM_RX_STATS, 0);
+    expected[RX_FRAMES] = frames.size();
+    expected[RX_PHY_ERRORS] = 1;
+    expected[RX_FCS_ERRORS] = 1;
+    expected[RX_MAC_MISMATCHES] = 1;
+    expected[RX_VLAN_MISMATCHES] = 1;
+    expected[RX_IP_MISMATCHES] = 1;
+    expected[RX_PORT_MISMATCHES] = 1;
+    expected[RX_UNSUPPORTED] = 1;
+    expected[RX_CHECKSUM_ERRORS] = 1;
+    const std::vector<int> bucket_limits = {64, 127, 255, 511, 1023, 1518};
+    for (const std::vector<phy_data> &frame : frames) {
+      int frame_bytes = frame.size() / PHY_CYCLES_PER_BYTE - 8;
+      expected[RX_BYTES] += frame_bytes;
+      int bucket = std::upper_bound(bucket_limits.begin(),
+                                    bucket_limits.end(),
+                                    frame_bytes - 1) -
+                   bucket_limits.begin();
+      expected[RX_FRAMES_64 + bucket]++;
+    }
+
+    hls::stream<axis_word> stats_data_out;
+    hls::stream<ARPEvent> stats_arp_out;
+    hls::stream<axis_word> stats_icmp_out;
+    ap_uint<32> stats_dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    // The first cycle clears the counts of the tests before, the rxerr in
+    // the second frame marks a PHY error
+    for (int i = 0; i < frames.size(); i++) {
+      for (int j = 0; j < frames[i].size() + IPG_CYCLES; j++) {
+        ap_uint<1> crsdv = j < frames[i].size();
+        eth_in(crsdv ? frames[i][j] : phy_data(0),
+               i == 1 && j == PHY_CYCLES_PER_BYTE * 25,
+               crsdv,
+               stats_data_out,
+               stats_arp_out,
+               stats_icmp_out,
+               stats_dropped_frames,
+               loc,
+               port_table(loc.udp_port),
+               0,
+               1,
+               0,
+               stats_value,
+               0,
+               fifo_value);
+      }
+    }
+    std::string mismatch = counter_mismatch(read_stats(loc, 2), expected);
+    errors +=
+        report("Statistics of received frames", mismatch.empty(), mismatch);
+  }
+
+#if !ETH_IN_CUT_THROUGH
+  // The words of a frame pile up in the receive buffer until it passed the
+  // frame checks. Its first word is read out in the cycle it is committed.
+  {
+    std::vector<ap_uint<8> > fifo_payload(200, 0x55);
+    std::vector<phy_data> frame = UDPFrame(src, loc, fifo_payload);
+    hls::stream<axis_word> fifo_data_out;
+    hls::stream<ARPEvent> fifo_arp_out;
+    hls::stream<axis_word> fifo_icmp_out;
+    ap_uint<32> fifo_dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    for (int j = 0; j < frame.size() + 400; j++) {
+      ap_uint<1> crsdv = j < frame.size();
+      eth_in(crsdv ? frame[j] : phy_data(0),
+             0,
+             crsdv,
+             fifo_data_out,
+             fifo_arp_out,
+             fifo_icmp_out,
+             fifo_dropped_frames,
+             loc,
+             port_table(loc.udp_port),
+             0,
+             3,
+             0,
+             stats_value,
+             0,
+             fifo_value);
+    }
+    std::vector<std::vector<ap_uint<64> > > values(
+        NUM_RX_FIFOS, std::vector<ap_uint<64> >(NUM_FIFO_STATS));
+    for (int i = 0; i < NUM_RX_FIFOS; i++) {
+      for (int j = 0; j < NUM_FIFO_STATS; j++) {
+        eth_in(0,
+               0,
+               0,
+               fifo_data_out,
+               fifo_arp_out,
+               fifo_icmp_out,
+               fifo_dropped_frames,
+               loc,
+               port_table(loc.udp_port),
+               0,
+               4,
+               0,
+               stats_value,
+               fifo_stat_select(i, fifo_stat(j)),
+               values[i][j]);
+      }
+    }
+    const std::vector<std::string> names = {"payload words", "frames"};
+    for (int i = 0; i < NUM_RX_FIFOS; i++) {
+      std::cout << "  Receive buffer " << names[i] << ": level "
+                << values[i][FIFO_LEVEL] << ", peak " << values[i][FIFO_PEAK]
+                << ", full " << values[i][FIFO_FULL_CYCLES]
+                << " cycles, empty " << values[i][FIFO_EMPTY_CYCLES]
+                << " cycles" << std::endl;
+    }
+    int payload_words =
+        (fifo_payload.size() + DATAPATH_BYTES - 1) / DATAPATH_BYTES;
+    errors += report("Occupancy of the receive buffer",
+                     values[RX_WORD_FIFO][FIFO_LEVEL] == 0 &&
+                         values[RX_WORD_FIFO][FIFO_PEAK] ==
+                             payload_words - 1 &&
+                         values[RX_WORD_FIFO][FIFO_FULL_CYCLES] == 0 &&
+                         values[RX_FRAME_FIFO][FIFO_LEVEL] == 0 &&
+                         values[RX_FRAME_FIFO][FIFO_FULL_CYCLES] == 0);
+  }
+
+  // A frame with more payload than the receive buffer has room for is dropped
+  // and counted as RX_OVERFLOWS, the frame after it is passed on. Only variants
+  // with a small receive buffer get such frames (see build.tcl).
+  if (RX_BUFFER_BYTES <= MAX_UDP_PAYLOAD_BYTES) {
+    std::vector<ap_uint<8> > overflow_payload(RX_BUFFER_BYTES, 0x55);
+    const std::vector<std::vector<phy_data> > frames = {
+        UDPFrame(src, loc, overflow_payload), UDPFrame(src, loc, {0xaa})};
+    hls::stream<axis_word> overflow_data_out;
+    hls::stream<ARPEvent> overflow_arp_out;
+    hls::stream<axis_word> overflow_icmp_out;
+    ap_uint<32> overflow_dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    // The first cycle clears the counts of the tests before
+    for (int i = 0; i < frames.size(); i++) {
+      for (int j = 0; j < frames[i].size() + IPG_CYCLES; j++) {
+        ap_uint<1> crsdv = j < frames[i].size();
+        eth_in(crsdv ? frames[i][j] : phy_data(0),
+               0,
+               crsdv,
+               overflow_data_out,
+               overflow_arp_out,
+               overflow_icmp_out,
+               overflow_dropped_frames,
+               loc,
+               port_table(loc.udp_port),
+               0,
+               5,
+               0,
+               stats_value,
+               0,
+               fifo_value);
+      }
+    }
+    std::vector<ap_uint<8> > passed_on;
+    while (!overflow_data_out.empty()) {
+      axis_word word = overflow_data_out.read();
+      for (int i = 0; i < DATAPATH_BYTES; i++) {
+        if (word.keep[i]) {
+          passed_on.push_back(word.data(8 * i + 7, 8 * i));
+        }
+      }
     }
-    errors += tests[i].get_result();
+    std::vector<ap_uint<64> > values = read_stats(loc, 6);
+    errors += report("Overflow of the receive buffer",
+                     values[RX_FRAMES] == frames.size() &&
+                         values[RX_OVERFLOWS] == 1 &&
+                         passed_on == std::vector<ap_uint<8> >{0xaa},
+                     values[RX_OVERFLOWS].to_string(10) + " overflows");
   }
+#endif
   return errors;
 }
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RX_STATS_HPP
+#define RX_STATS_HPP
+#pragma once
+
+#include "../utils/FIFOMonitor.hpp"
+#include "../utils/StatCounters.hpp"
+
+// Counters of eth_in, as selected by stats_select. Every frame counts in
+// RX_FRAMES, RX_BYTES and one size bucket, counted from RX_FRAMES_64 on. A
+// dropped frame also counts for the first reason it was dropped for:
+// - RX_PHY_ERRORS: rxerr was set during the frame
+// - RX_FCS_ERRORS: the frame check sequence did not match
+// - RX_MAC_MISMATCHES: sent to another MAC address
+// - RX_VLAN_MISMATCHES: tagged with a VLAN missing in the VLAN table
+// - RX_IP_MISMATCHES: sent to another IP address
+// - RX_PORT_MISMATCHES: sent to a UDP port missing in the port table
+// - RX_UNSUPPORTED: neither ARP, nor UDP, nor an echo request, and fragments
+//   without ETH_IN_REASSEMBLY
+// - RX_CHECKSUM_ERRORS: the UDP or ICMP checksum did not match
+// - RX_OVERFLOWS: no room left in the receive buffer or in arp_out
+enum rx_stat {
+  RX_FRAMES,
+  RX_BYTES,
+  RX_PHY_ERRORS,
+  RX_FCS_ERRORS,
+  RX_MAC_MISMATCHES,
+  RX_VLAN_MISMATCHES,
+  RX_IP_MISMATCHES,
+  RX_PORT_MISMATCHES,
+  RX_UNSUPPORTED,
+  RX_CHECKSUM_ERRORS,
+  RX_OVERFLOWS,
+  RX_FRAMES_64,
+  NUM_RX_STATS = RX_FRAMES_64 + NUM_SIZE_BUCKETS
+};
+
+// FIFOs of eth_in, as selected by fifo_select (see fifo_stat_select): the
+// payload words and the frames of the receive buffer. Both are not used with
+// ETH_IN_CUT_THROUGH.
+enum rx_fifo { RX_WORD_FIFO, RX_FRAME_FIFO, NUM_RX_FIFOS };
+
+#endif
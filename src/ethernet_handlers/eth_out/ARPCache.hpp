@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARP_CACHE
+#define ARP_CACHE
+#pragma once
+
+#include "../utils/bit_width.hpp"
+#include <ap_int.h>
+
+// Number of entries, a power of two
+#ifndef ARP_CACHE_ENTRIES
+#define ARP_CACHE_ENTRIES 16
+#endif
+
+// Direct mapped cache of MAC addresses. The lowest bits of an IP address select
+// its entry, so a newly learned address replaces the one it collides with.
+class ARPCache {
+public:
+  ARPCache() : valid(0) {}
+  void insert(const ap_uint<32> &ip_addr, const ap_uint<48> &mac_addr);
+  ap_uint<1> lookup(const ap_uint<32> &ip_addr, ap_uint<48> &mac_addr) const;
+
+private:
+  ap_uint<ARP_CACHE_ENTRIES> valid;
+  ap_uint<32> ip_addrs[ARP_CACHE_ENTRIES];
+  ap_uint<48> mac_addrs[ARP_CACHE_ENTRIES];
+};
+
+#endif
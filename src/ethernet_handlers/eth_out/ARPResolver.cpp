@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ARPResolver.hpp"
+
+// Has to be called every cycle
+void ARPResolver::learn(hls::stream<ARPEvent> &arp_in, const Addresses &loc) {
+#pragma HLS INLINE
+
+  if (this->state == RESOLVING && this->retry_cnt != 0) {
+    this->retry_cnt--;
+  }
+
+  if (!arp_in.empty()) {
+    ARPEvent event = arp_in.read();
+    // Probes carry no sender IP address
+    if (event.sender_ip_addr != 0) {
+      this->arpCache.insert(event.sender_ip_addr, event.sender_mac_addr);
+      if (event.sender_ip_addr == this->ip_addr) {
+        this->state = IDLE;
+      }
+    }
+    if (event.operation == ARP_REQUEST && event.target_ip_addr == loc.ip_addr) {
+      this->reply = {0,
+                     0,
+                     event.sender_mac_addr,
+                     event.sender_ip_addr,
+                     0,
+                     ARP,
+                     0,
+                     ARP_REPLY,
+                     0,
+                     0,
+                     event.vlan,
+                     0};
+      this->reply_pending = true;
+    }
+  }
+}
+
+ARPResolver::decision_type
+ARPResolver::next_frame(tx_queue queues[NUM_TX_QUEUES],
+                        echo_queue &echo,
+                        const tx_queue_quanta &quanta,
+                        TXPacer &pacer,
+                        Meta &meta) {
+#pragma HLS INLINE
+
+  if (this->reply_pending) {
+    this->reply_pending = false;
+    meta = this->reply;
+    return SEND;
+  }
+
+  // Echo replies go to the MAC address the request came from
+  if (echo.is_waiting(0)) {
+    meta = echo.get_meta(0);
+    echo.take(0);
+    return SEND;
+  }
+
+  // The frames to an address that got no reply are dropped one by one
+  if (this->state == FAILED) {
+    ap_uint<1> dropped = false;
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+      for (int j = 0; j < TX_META_WORDS; j++) {
+#pragma HLS UNROLL
+        Meta frame = queues[i].get_meta(j);
+        if (!dropped && queues[i].is_waiting(j) && frame.dst_mac_addr == 0 &&
+            frame.dst_ip_addr == this->ip_addr) {
+          queues[i].drop(j);
+          meta = frame;
+          meta.queue = i;
+          dropped = true;
+        }
+      }
+    }
+    if (dropped) {
+      return DROP;
+    }
+    this->state = IDLE;
+  }
+
+  if (this->state == RESOLVING && this->retry_cnt == 0) {
+    if (this->request_cnt == ARP_MAX_REQUESTS) {
+      this->state = FAILED;
+      return WAIT;
+    }
+    this->request(meta);
+    return SEND;
+  }
+
+  tx_frame_flags resolved = 0;
+  ap_uint<1> unresolved_found = false;
+  ap_uint<32> unresolved_ip_addr = 0;
+  VLANTag unresolved_vlan = {0, 0};
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+    for (int j = 0; j < TX_META_WORDS; j++) {
+#pragma HLS UNROLL
+      Meta frame = queues[i].get_meta(j);
+      ap_uint<48> mac_addr;
+      resolved[TX_META_WORDS * i + j] =
+          frame.dst_mac_addr != 0 ||
+          this->arpCache.lookup(frame.dst_ip_addr, mac_addr);
+      if (!unresolved_found && queues[i].is_waiting(j) &&
+          !resolved[TX_META_WORDS * i + j]) {
+        unresolved_found = true;
+        unresolved_ip_addr = frame.dst_ip_addr;
+        unresolved_vlan = frame.vlan;
+      }
+    }
+  }
+
+  if (this->state == IDLE && unresolved_found) {
+    this->state = RESOLVING;
+    this->ip_addr = unresolved_ip_addr;
+    this->vlan = unresolved_vlan;
+    this->request_cnt = 0;
+    this->request(meta);
+    return SEND;
+  }
+
+  if (!this->txScheduler.next_frame(queues, quanta, resolved, pacer, meta)) {
+    return WAIT;
+  }
+  ap_uint<48> mac_addr = meta.dst_mac_addr;
+  if (mac_addr == 0) {
+    this->arpCache.lookup(meta.dst_ip_addr, mac_addr);
+  }
+  meta.dst_mac_addr = mac_addr;
+  return SEND;
+}
+
+// Sends a request for ip_addr in the VLAN of the frame to it and waits for the
+// reply
+void ARPResolver::request(Meta &meta) {
+#pragma HLS INLINE
+
+  this->request_cnt++;
+  this->retry_cnt = ARP_RETRY_CYCLES;
+  meta = {0,
+          0,
+          BROADCAST_MAC_ADDR,
+          this->ip_addr,
+          0,
+          ARP,
+          0,
+          ARP_REQUEST,
+          0,
+          0,
+          this->vlan,
+          0};
+}
+
+ap_uint<32> ARPResolver::get_scheduled_frames(int queue) const {
+#pragma HLS INLINE
+
+  return this->txScheduler.get_scheduled_frames(queue);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARP_RESOLVER
+#define ARP_RESOLVER
+#pragma once
+
+#include "../utils/ARPEvent.hpp"
+#include "../utils/Addresses.hpp"
+#include "../utils/VLANTag.hpp"
+#include "../utils/bit_width.hpp"
+#include "../utils/phy.hpp"
+#include "../utils/protocols.hpp"
+#include "ARPCache.hpp"
+#include "Meta.hpp"
+#include "TXQueue.hpp"
+#include "TXScheduler.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Cycles to wait for a reply before a request is repeated (1 s) and number of
+// requests before the frames to an unresolved address are dropped
+#ifndef ARP_RETRY_CYCLES
+#define ARP_RETRY_CYCLES PHY_CLOCK_HZ
+#endif
+#ifndef ARP_MAX_REQUESTS
+#define ARP_MAX_REQUESTS 3
+#endif
+
+// Decides on the frame to send next. Replies to ARP requests for loc go first,
+// in the VLAN of the request, echo replies second. The frames of the transmit
+// queues follow in the order of the TXScheduler.
+// A frame without destination MAC address waits in its queue until the
+// address of its destination IP address got into the cache, while the frames
+// to other destinations are sent. Meanwhile ARP requests for it are sent, for
+// one address at a time and in the VLAN of the frame that found it missing.
+// Destinations outside the local network need the MAC address of their
+// gateway set in the frame.
+class ARPResolver {
+public:
+  enum decision_type { WAIT, SEND, DROP };
+  ARPResolver()
+      : reply_pending(false), state(IDLE), retry_cnt(0), request_cnt(0) {}
+  void learn(hls::stream<ARPEvent> &arp_in, const Addresses &loc);
+  decision_type next_frame(tx_queue queues[NUM_TX_QUEUES],
+                           echo_queue &echo,
+                           const tx_queue_quanta &quanta,
+                           TXPacer &pacer,
+                           Meta &meta);
+  ap_uint<32> get_scheduled_frames(int queue) const;
+
+private:
+  enum state_type { IDLE, RESOLVING, FAILED };
+  void request(Meta &meta);
+  ARPCache arpCache;
+  TXScheduler txScheduler;
+  ap_uint<1> reply_pending;
+  Meta reply;
+  state_type state;
+  ap_uint<32> ip_addr;
+  VLANTag vlan;
+  ap_uint<bit_width<ARP_RETRY_CYCLES>::value> retry_cnt;
+  ap_uint<bit_width<ARP_MAX_REQUESTS>::value> request_cnt;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BufferReader.hpp"
+
+// The next word of the frame is to be refilled
+ap_uint<1> BufferReader::needs_word() const {
+#pragma HLS INLINE
+
+  return !this->next_valid && !this->last_loaded;
+}
+
+// A byte of the frame is there to be read
+ap_uint<1> BufferReader::has_byte() const {
+#pragma HLS INLINE
+
+  return this->current_valid || this->next_valid;
+}
+
+void BufferReader::refill(const buffer_word &word) {
+#pragma HLS INLINE
+
+  this->next = word;
+  this->next_valid = true;
+  this->last_loaded = word.last;
+}
+
+byte_word BufferReader::read() {
+#pragma HLS INLINE
+
+  if (!this->current_valid) {
+    this->current = this->next;
+    this->current_valid = true;
+    this->next_valid = false;
+    this->byte_cnt = 0;
+  }
+  ap_uint<1> last_byte =
+      (this->current.keep >> (this->byte_cnt + 1)) == 0;
+  byte_word ret = {this->current.get_byte(this->byte_cnt),
+                   this->current.last && last_byte,
+                   0};
+  this->byte_cnt++;
+  if (last_byte) {
+    this->current_valid = false;
+  }
+  return ret;
+}
+
+void BufferReader::reset() {
+  this->current_valid = false;
+  this->next_valid = false;
+  this->last_loaded = false;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BUFFER_READER
+#define BUFFER_READER
+#pragma once
+
+#include "../utils/axis_word.hpp"
+#include "../utils/buffer_word.hpp"
+#include <ap_int.h>
+
+// Hands out the payload of a frame byte by byte. Up to two words of the queue
+// are held, so that refilling once per word sent always leaves enough bytes
+// for the next word, however the payload is aligned to the header.
+class BufferReader {
+public:
+  BufferReader()
+      : current_valid(false), next_valid(false), last_loaded(false) {}
+  ap_uint<1> needs_word() const;
+  ap_uint<1> has_byte() const;
+  void refill(const buffer_word &word);
+  byte_word read();
+  void reset();
+
+private:
+  buffer_word current;
+  buffer_word next;
+  ap_uint<bit_width<DATAPATH_BYTES>::value> byte_cnt;
+  ap_uint<1> current_valid;
+  ap_uint<1> next_valid;
+  ap_uint<1> last_loaded;
+};
+
+#endif
@@ -29,24 +29,16 @@
 
 #include "DataInputAnalyzer.hpp"
 
-void DataInputAnalyzer::handle(hls::stream<axis_word> &data_in,
-                               hls::stream<axis_word> &buffer,
-                               hls::stream<Meta> &meta_buffer) {
+// Frames added to the queue so far
+ap_uint<32> DataInputAnalyzer::get_frame_count() const {
 #pragma HLS INLINE
 
-  if (!data_in.empty()) {
-    axis_word tmp = data_in.read();
-    buffer.write(tmp);
-    checksum.add_half(tmp.data);
-    byte_cnt++;
-    if (tmp.last) {
-      meta_buffer.write({checksum.get_accumulator(),
-                         byte_cnt,
-                         tmp.user(47, 0),
-                         tmp.user(79, 48),
-                         tmp.user(95, 80)});
-      byte_cnt = 0;
-      checksum.reset();
-    }
-  }
+  return this->frame_cnt;
+}
+
+// Words written to the queue so far, wrapping around
+ap_uint<16> DataInputAnalyzer::get_word_count() const {
+#pragma HLS INLINE
+
+  return this->word_cnt;
 }
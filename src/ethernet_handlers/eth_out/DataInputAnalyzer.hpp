@@ -32,21 +32,82 @@
 #pragma once
 
 #include "../utils/axis_word.hpp"
+#include "../utils/buffer_word.hpp"
 #include "../utils/checksums/Checksum.hpp"
+#include "../utils/frame_size.hpp"
+#include "../utils/protocols.hpp"
 #include "Meta.hpp"
+#include "TXQueue.hpp"
 #include <ap_int.h>
 #include <hls_stream.h>
 
+// Takes the frames of data_in apart into their payload and the meta of a frame
+// of protocol ip_protocol. Unless segment_bytes is 0, a message on data_in is
+// cut into frames of segment_bytes each, the last one taking the rest. The
+// segment size is capped at MAX_UDP_PAYLOAD_BYTES and rounded down to whole
+// words, but is at least one word. The frames keep the VLAN tag of their words.
 class DataInputAnalyzer {
 public:
-  DataInputAnalyzer() : byte_cnt(0) {}
+  DataInputAnalyzer(const ap_uint<8> &ip_protocol = UDP)
+      : byte_cnt(0), frame_cnt(0), word_cnt(0), ip_protocol(ip_protocol) {}
+  template <int W, int F>
   void handle(hls::stream<axis_word> &data_in,
-              hls::stream<axis_word> &buffer,
-              hls::stream<Meta> &meta_buffer);
+              TXQueue<W, F> &queue,
+              const ap_uint<16> &segment_bytes);
+  ap_uint<32> get_frame_count() const;
+  ap_uint<16> get_word_count() const;
 
 private:
-  ap_uint<11> byte_cnt;
+  ap_uint<FRAME_LENGTH_WIDTH> byte_cnt;
+  ap_uint<32> frame_cnt;
+  ap_uint<16> word_cnt;
+  ap_uint<8> ip_protocol;
   Checksum checksum;
 };
 
+template <int W, int F>
+void DataInputAnalyzer::handle(hls::stream<axis_word> &data_in,
+                               TXQueue<W, F> &queue,
+                               const ap_uint<16> &segment_bytes) {
+#pragma HLS INLINE
+
+  ap_uint<16> segment_limit = segment_bytes;
+  if (segment_limit > MAX_UDP_PAYLOAD_BYTES) {
+    segment_limit = MAX_UDP_PAYLOAD_BYTES;
+  }
+  segment_limit = segment_limit / DATAPATH_BYTES * DATAPATH_BYTES;
+  if (segment_bytes != 0 && segment_limit == 0) {
+    segment_limit = DATAPATH_BYTES;
+  }
+
+  // Words are only taken while the queue has room for them and the frame
+  if (!data_in.empty() && queue.has_room()) {
+    axis_word tmp = data_in.read();
+    checksum.add<DATAPATH_BYTES>(tmp.data, tmp.keep);
+    byte_cnt += tmp.num_bytes();
+    if (segment_limit != 0 && byte_cnt == segment_limit) {
+      tmp.last = true;
+    }
+    queue.write(buffer_word(tmp));
+    word_cnt++;
+    if (tmp.last) {
+      queue.add_frame({checksum.get_sum(),
+                       byte_cnt,
+                       tmp.user(47, 0),
+                       tmp.user(79, 48),
+                       tmp.user(95, 80),
+                       IPv4,
+                       ip_protocol,
+                       0,
+                       0,
+                       0,
+                       tmp.get_vlan(),
+                       0});
+      frame_cnt++;
+      byte_cnt = 0;
+      checksum.reset();
+    }
+  }
+}
+
 #endif
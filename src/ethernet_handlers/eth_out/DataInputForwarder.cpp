@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "DataInputForwarder.hpp"
+
+void DataInputForwarder::handle(hls::stream<axis_word> &data_in,
+                                hls::stream<PayloadDescriptor> &desc_in,
+                                tx_queue &queue) {
+#pragma HLS INLINE
+
+  // The first word of a frame also needs its descriptor and room for the
+  // frame. The words dropped need no room at all.
+  ap_uint<1> room = dropping || (in_frame ? queue.has_word_room()
+                                          : queue.has_room());
+  if (!data_in.empty() && room && (in_frame || !desc_in.empty())) {
+    axis_word tmp = data_in.read();
+    ap_uint<1> input_last = tmp.last;
+    if (!in_frame) {
+      PayloadDescriptor desc = desc_in.read();
+      byte_cnt = 0;
+      length = desc.length;
+      queue.announce_frame({desc.checksum,
+                            desc.length,
+                            tmp.user(47, 0),
+                            tmp.user(79, 48),
+                            tmp.user(95, 80),
+                            IPv4,
+                            UDP,
+                            0,
+                            desc.no_checksum,
+                            0,
+                            tmp.get_vlan(),
+                            0});
+      frame_cnt++;
+    }
+    if (!dropping) {
+      byte_cnt += tmp.num_bytes();
+      if (byte_cnt >= length && !tmp.last) {
+        tmp.last = true;
+        dropping = true;
+        queue.poison();
+      } else if (tmp.last && byte_cnt != length) {
+        queue.poison();
+      }
+      queue.write(buffer_word(tmp));
+    }
+    if (input_last) {
+      dropping = false;
+    }
+    in_frame = !input_last;
+  }
+}
+
+// Frames added to the queue so far
+ap_uint<32> DataInputForwarder::get_frame_count() const {
+#pragma HLS INLINE
+
+  return this->frame_cnt;
+}
+
@@ -27,41 +27,40 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef IP_PACKET_WORD_GENERATOR
-#define IP_PACKET_WORD_GENERATOR
+#ifndef DATA_INPUT_FORWARDER
+#define DATA_INPUT_FORWARDER
 #pragma once
 
-#include "../utils/Addresses.hpp"
+#include "../utils/PayloadDescriptor.hpp"
 #include "../utils/axis_word.hpp"
-#include "../utils/checksums/Checksum.hpp"
+#include "../utils/buffer_word.hpp"
 #include "../utils/protocols.hpp"
 #include "Meta.hpp"
-#include "UDPPacketWordGenerator.hpp"
+#include "TXQueue.hpp"
 #include <ap_int.h>
 #include <hls_stream.h>
 
-const ap_uint<8> IP_VERSION_AND_STD_IHL = 0x45;
-const ap_uint<16> IP_VERSION_AND_STD_IHL_AND_NO_SPECIAL = 0x4500;
-const ap_uint<8> IP_HOP_COUNT = 0x80;
-const int IP_PKT_HEADER_BYTE_SIZE = 20;
-const int IP_AND_UDP_HEADER_BYTE_SIZE =
-    IP_PKT_HEADER_BYTE_SIZE + UDP_PKT_HEADER_BYTE_SIZE;
-
-class IPPacketWordGenerator {
+// Cut-through counterpart of DataInputAnalyzer. The meta of a frame is taken
+// from its descriptor and added to the queue along with the first word, so the
+// frame can be sent before its last word arrived. The frame is cut off at the
+// length of its descriptor, the rest of its words are dropped. A frame that
+// is cut off or ends early is poisoned in the queue.
+class DataInputForwarder {
 public:
-  IPPacketWordGenerator() : word_cnt(0) {}
-  axis_word get_next_word(const Addresses &loc,
-                          const Meta &meta,
-                          hls::stream<axis_word> &buffer);
-  void reset();
+  DataInputForwarder()
+      : in_frame(false), dropping(false), byte_cnt(0), length(0),
+        frame_cnt(0) {}
+  void handle(hls::stream<axis_word> &data_in,
+              hls::stream<PayloadDescriptor> &desc_in,
+              tx_queue &queue);
+  ap_uint<32> get_frame_count() const;
 
 private:
-  ap_uint<32> word_cnt;
-  Checksum ip_checksum;
-  ap_uint<8> ip_pkt_protocol;
-  ap_uint<11> ip_pkt_length;
-  ap_uint<16> ip_hop_count_and_protocol;
-  UDPPacketWordGenerator udpPacketWordGenerator;
+  ap_uint<1> in_frame;
+  ap_uint<1> dropping;
+  ap_uint<16> byte_cnt;
+  ap_uint<16> length;
+  ap_uint<32> frame_cnt;
 };
 
 #endif
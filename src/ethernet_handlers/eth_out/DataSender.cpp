@@ -29,69 +29,118 @@
 
 #include "DataSender.hpp"
 
-void write_data_bit_pair(const axis_word &word,
-                         ap_uint<2> &data_bit_pair_cnt,
-                         ap_uint<2> &txd,
-                         ap_uint<1> &txen) {
+void count_data_symbol(
+    const axis_word &word,
+    ap_uint<bit_width<MAX_SYMBOL_INDEX + 1>::value> &data_symbol_cnt) {
 #pragma HLS INLINE
 
-  txd = word.data(2 * data_bit_pair_cnt + 1, 2 * data_bit_pair_cnt);
-  txen = true;
-  data_bit_pair_cnt++;
+  if (data_symbol_cnt == PHY_CYCLES_PER_BYTE * word.num_bytes() - 1) {
+    data_symbol_cnt = 0;
+  } else {
+    data_symbol_cnt++;
+  }
 }
 
-void write_idle_bit_pair(ap_uint<2> &txd, ap_uint<1> &txen) {
+void DataSender::handle(hls::stream<TxWord> &tx_words,
+                        tx_queue queues[NUM_TX_QUEUES],
+                        echo_queue &echo,
+                        hls::stream<ARPEvent> &arp_in,
+                        const Addresses &loc,
+                        const ap_uint<8> &ipg_bytes,
+                        const ap_uint<8> &ip_id_restart,
+                        const tx_queue_quanta &quanta,
+                        const ap_uint<16> &pacing_rate,
+                        const ap_uint<16> &pacing_burst) {
 #pragma HLS INLINE
 
-  txd = 0;
-  txen = false;
-}
-
-void DataSender::handle(ap_uint<2> &txd,
-                        ap_uint<1> &txen,
-                        hls::stream<axis_word> &buffer,
-                        hls::stream<Meta> &meta_buffer,
-                        const Addresses &loc) {
-#pragma HLS INLINE
+  // A change of ip_id_restart numbers the packets sent next from 0 again
+  if (ip_id_restart != last_ip_id_restart) {
+    ip_id = 0;
+    echo_ip_id = 0;
+    last_ip_id_restart = ip_id_restart;
+  }
+  arpResolver.learn(arp_in, loc);
+  dataWordGenerator.update();
+  txPacer.update(pacing_rate, pacing_burst);
+  ap_uint<8> gap_bytes =
+      ipg_bytes < MIN_IPG_BYTES ? MIN_IPG_BYTES : ipg_bytes;
+  ap_uint<10> max_ipg_index = PHY_CYCLES_PER_BYTE * gap_bytes - 1;
 
   switch (state) {
   case IDLE:
-    if (!meta_buffer.empty()) {
-      meta = meta_buffer.read();
+    switch (arpResolver.next_frame(queues, echo, quanta, txPacer, meta)) {
+    case ARPResolver::SEND:
+      // UDP packets and echo replies are numbered separately in the order
+      // they are sent
+      if (meta.ether_type == IPv4 && meta.ip_protocol == ICMP) {
+        meta.ip_id = echo_ip_id++;
+      } else if (meta.ether_type == IPv4) {
+        meta.ip_id = ip_id++;
+      }
       state = SENDING_PACKET;
-      word = dataWordGenerator.get_next_word(loc, meta, buffer);
-      write_data_bit_pair(word, data_bit_pair_cnt, txd, txen);
-    } else {
-      write_idle_bit_pair(txd, txen);
-    }
-    break;
-  case SENDING_PACKET:
-    switch (data_bit_pair_cnt) {
-    case 0:
-      word = dataWordGenerator.get_next_word(loc, meta, buffer);
+      dataWordGenerator.start_frame(loc, meta);
+      word = dataWordGenerator.get_next_word(meta, queues, echo);
+      tx_words.write(word);
+      frame_bytes = word.word.num_bytes();
+      count_data_symbol(word.word, data_symbol_cnt);
       break;
-    case 1:
-      dataWordGenerator.maintenance();
-      break;
-    case 3:
-      if (word.last) {
-        dataWordGenerator.reset();
-        state = WAITING_FOR_INTER_PACKAGE_GAP;
-      }
+    case ARPResolver::DROP:
+      dropped_frames[meta.queue]++;
+      stats.add(TX_UNRESOLVED, 1);
       break;
     default:
       break;
     }
-    write_data_bit_pair(word, data_bit_pair_cnt, txd, txen);
+    break;
+  case SENDING_PACKET:
+    if (data_symbol_cnt == 0) {
+      word = dataWordGenerator.get_next_word(meta, queues, echo);
+      tx_words.write(word);
+      frame_bytes += word.word.num_bytes();
+    }
+    if (data_symbol_cnt == PHY_CYCLES_PER_BYTE * word.word.num_bytes() - 1 &&
+        word.word.last) {
+      // The preamble and SFD are not part of the frame
+      stats.add(TX_FRAMES, 1);
+      stats.add(TX_BYTES, frame_bytes - 8);
+      stats.add(TX_FRAMES_64 + size_bucket(frame_bytes - 8), 1);
+      dataWordGenerator.reset();
+      state = WAITING_FOR_INTER_PACKAGE_GAP;
+    }
+    count_data_symbol(word.word, data_symbol_cnt);
     break;
   case WAITING_FOR_INTER_PACKAGE_GAP:
-    if (ipg_cnt < MAX_IPG_INDEX) {
+    // The next frame may start right in the cycle after the gap
+    if (ipg_cnt < max_ipg_index) {
       ipg_cnt++;
     } else {
       ipg_cnt = 0;
       state = IDLE;
     }
-    write_idle_bit_pair(txd, txen);
     break;
   }
 }
+
+// Frames taken from the transmit queue so far, sent or dropped
+ap_uint<32> DataSender::get_scheduled_frames(int queue) const {
+#pragma HLS INLINE
+
+  return this->arpResolver.get_scheduled_frames(queue) +
+         this->dropped_frames[queue];
+}
+
+// Frames of the transmit queue dropped for lack of a MAC address
+ap_uint<32> DataSender::get_dropped_frames(int queue) const {
+#pragma HLS INLINE
+
+  return this->dropped_frames[queue];
+}
+
+// Returns whether a snapshot was taken
+ap_uint<1> DataSender::publish_stats(const ap_uint<8> &snapshot,
+                                     const ap_uint<8> &select,
+                                     ap_uint<64> &value) {
+#pragma HLS INLINE
+
+  return this->stats.publish(snapshot, select, value);
+}
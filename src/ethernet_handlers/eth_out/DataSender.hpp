@@ -31,32 +31,70 @@
 #define DATA_SENDER
 #pragma once
 
+#include "../utils/ARPEvent.hpp"
 #include "../utils/Addresses.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/buffer_word.hpp"
+#include "../utils/phy.hpp"
+#include "ARPResolver.hpp"
 #include "DataWordGenerator.hpp"
 #include "Meta.hpp"
+#include "TXPacer.hpp"
+#include "TXQueue.hpp"
+#include "TXScheduler.hpp"
+#include "TxWord.hpp"
+#include "tx_stats.hpp"
 #include <ap_int.h>
 #include <hls_stream.h>
 
-const ap_uint<8> MAX_IPG_INDEX = 95;
+// Smallest inter packet gap allowed, 96 bit times. The gap is set in bytes,
+// each taking PHY_CYCLES_PER_BYTE cycles to send.
+const ap_uint<8> MIN_IPG_BYTES = 12;
 
+// Chooses the frames to send and hands their words to tx_words at line rate,
+// each in the cycle its first symbol is due. The symbols of a word are only
+// counted here, they are sent by the FrameSerializer.
 class DataSender {
 public:
-  DataSender() : data_bit_pair_cnt(0), ipg_cnt(0) {}
-  void handle(ap_uint<2> &txd,
-              ap_uint<1> &txen,
-              hls::stream<axis_word> &buffer,
-              hls::stream<Meta> &meta_buffer,
-              const Addresses &loc);
+  DataSender()
+      : data_symbol_cnt(0), ipg_cnt(0), ip_id(0), echo_ip_id(0),
+        last_ip_id_restart(0), frame_bytes(0) {
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+      this->dropped_frames[i] = 0;
+    }
+  }
+  void handle(hls::stream<TxWord> &tx_words,
+              tx_queue queues[NUM_TX_QUEUES],
+              echo_queue &echo,
+              hls::stream<ARPEvent> &arp_in,
+              const Addresses &loc,
+              const ap_uint<8> &ipg_bytes,
+              const ap_uint<8> &ip_id_restart,
+              const tx_queue_quanta &quanta,
+              const ap_uint<16> &pacing_rate,
+              const ap_uint<16> &pacing_burst);
+  ap_uint<32> get_scheduled_frames(int queue) const;
+  ap_uint<32> get_dropped_frames(int queue) const;
+  ap_uint<1> publish_stats(const ap_uint<8> &snapshot,
+                           const ap_uint<8> &select,
+                           ap_uint<64> &value);
 
 private:
   enum state_type { IDLE, SENDING_PACKET, WAITING_FOR_INTER_PACKAGE_GAP };
   state_type state = IDLE;
   Meta meta;
-  axis_word word;
-  ap_uint<2> data_bit_pair_cnt;
-  ap_uint<7> ipg_cnt;
+  TxWord word;
+  ap_uint<bit_width<MAX_SYMBOL_INDEX + 1>::value> data_symbol_cnt;
+  ap_uint<10> ipg_cnt;
+  ap_uint<16> ip_id;
+  ap_uint<16> echo_ip_id;
+  ap_uint<8> last_ip_id_restart;
+  ap_uint<32> dropped_frames[NUM_TX_QUEUES];
+  ap_uint<16> frame_bytes;
+  StatCounters<NUM_TX_STATS> stats;
   DataWordGenerator dataWordGenerator;
+  ARPResolver arpResolver;
+  TXPacer txPacer;
 };
 
 #endif
@@ -29,9 +29,81 @@
 
 #include "DataWordGenerator.hpp"
 
-axis_word DataWordGenerator::get_next_word(const Addresses &loc,
-                                           const Meta &meta,
-                                           hls::stream<axis_word> &buffer) {
+// Builds the headers of the frame described by meta, before its first word
+void DataWordGenerator::start_frame(const Addresses &loc, const Meta &meta) {
+#pragma HLS INLINE
+
+  headerBuilder.build(loc, meta);
+}
+
+void DataWordGenerator::update() {
+#pragma HLS INLINE
+
+  headerBuilder.update();
+}
+
+TxWord DataWordGenerator::get_next_word(const Meta &meta,
+                                        tx_queue queues[NUM_TX_QUEUES],
+                                        echo_queue &echo) {
+#pragma HLS INLINE
+
+  // ARP frames do not take anything from the queues
+  if (meta.ether_type == IPv4 && bufferReader.needs_word()) {
+    if (meta.ip_protocol == ICMP) {
+      if (echo.can_read()) {
+        bufferReader.refill(echo.read());
+      }
+    } else {
+      for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+        if (i == meta.queue && queues[i].can_read()) {
+          bufferReader.refill(queues[i].read());
+        }
+      }
+    }
+  }
+  TxWord ret = {axis_word(0, 0, false, 0), 0, 0, false};
+
+  // The preamble is a multiple of the word size, so the data bytes of a word
+  // always start in the lowest lane.
+  for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+    if (state != FCS) {
+      byte_word next = get_next_byte();
+      if (state == DATA) {
+        ret.data_lanes[i] = 1;
+      }
+      maintenance();
+      ret.word.set_byte(i, next.data);
+      ret.word.keep[i] = 1;
+    }
+  }
+
+  // A poisoned frame gets a wrong FCS
+  ret.invalid = payloadMerger.is_poisoned();
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+    if (meta.ether_type == IPv4 && meta.ip_protocol != ICMP &&
+        i == meta.queue && queues[i].is_poisoned()) {
+      ret.invalid = true;
+    }
+  }
+
+  // The FCS bytes follow the last data byte in the same word
+  for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+    if (state == FCS && !ret.word.keep[i] && !ret.word.last) {
+      byte_word next = get_next_byte();
+      maintenance();
+      ret.fcs_lanes[i] = 1;
+      ret.word.keep[i] = 1;
+      ret.word.last = next.last;
+    }
+  }
+  return ret;
+}
+
+byte_word DataWordGenerator::get_next_byte() {
 #pragma HLS INLINE
 
   switch (state) {
@@ -40,11 +112,12 @@ axis_word DataWordGenerator::get_next_word(const Addresses &loc,
     return {word.data, false, 0};
     break;
   case DATA:
-    word = ethPacketWordGenerator.get_next_word(loc, meta, buffer);
+    word = payloadMerger.get_next_byte(headerBuilder, bufferReader);
     return {word.data, false, 0};
     break;
   case FCS:
-    word = fcsWordGenerator.get_next_word();
+    // Only the place of the byte, its value is up to the FrameSerializer
+    word = counted(0, fcs_cnt, fcs_cnt == 3);
     return word;
     break;
   default:
@@ -62,7 +135,6 @@ void DataWordGenerator::maintenance() {
     }
     break;
   case DATA:
-    fcsWordGenerator.add_to_fcs(word.data);
     if (word.last) {
       state = FCS;
     }
@@ -79,7 +151,9 @@ void DataWordGenerator::maintenance() {
 
 void DataWordGenerator::reset() {
   preambleWordGenerator.reset();
-  ethPacketWordGenerator.reset();
-  fcsWordGenerator.reset();
+  payloadMerger.reset();
+  fcs_cnt = 0;
+  bufferReader.reset();
   state = PREAMBLE;
 }
+
@@ -32,23 +32,37 @@
 #pragma once
 
 #include "../utils/axis_word.hpp"
+#include "../utils/buffer_word.hpp"
 #include "../utils/Addresses.hpp"
 #include "Meta.hpp"
 #include <hls_stream.h>
+#include "BufferReader.hpp"
 #include "PreambleWordGenerator.hpp"
-#include "ETHPacketWordGenerator.hpp"
-#include "FCSWordGenerator.hpp"
+#include "HeaderBuilder.hpp"
+#include "PayloadMerger.hpp"
+#include "TXQueue.hpp"
+#include "TxWord.hpp"
+#include "counted.hpp"
 
+// Generates the frame in words of DATAPATH_BYTES bytes. The bytes of a word
+// are generated one lane after another by the same state machines. The
+// headers are built up front by start_frame() and completed by update() while
+// the preamble is sent, so the data bytes only merge the built headers with
+// the payload, however many headers there are. The bytes of the FCS are left
+// to the FrameSerializer, the words only hold their place.
 class DataWordGenerator {
 public:
-  DataWordGenerator() : state(PREAMBLE) {}
-  axis_word get_next_word(const Addresses &loc,
-                          const Meta &meta,
-                          hls::stream<axis_word> &buffer);
-  void maintenance();
+  DataWordGenerator() : state(PREAMBLE), fcs_cnt(0) {}
+  void start_frame(const Addresses &loc, const Meta &meta);
+  void update();
+  TxWord get_next_word(const Meta &meta,
+                       tx_queue queues[NUM_TX_QUEUES],
+                       echo_queue &echo);
   void reset();
 
 private:
+  byte_word get_next_byte();
+  void maintenance();
   enum state_type {
     PREAMBLE,
     DATA,
@@ -56,9 +70,11 @@ private:
   };
   state_type state;
   PreambleWordGenerator preambleWordGenerator;
-  ETHPacketWordGenerator ethPacketWordGenerator;
-  FCSWordGenerator fcsWordGenerator;
-  axis_word word;
+  HeaderBuilder headerBuilder;
+  PayloadMerger payloadMerger;
+  BufferReader bufferReader;
+  byte_word word;
+  ap_uint<2> fcs_cnt;
 };
 
 #endif
@@ -29,21 +29,22 @@
 
 #include "FCSWordGenerator.hpp"
 
-axis_word FCSWordGenerator::get_next_word() {
+byte_word FCSWordGenerator::get_next_word() {
 #pragma HLS INLINE
 
+  ap_uint<8> mask = invalid ? 0xff : 0;
   switch (word_cnt) {
   case 0:
-    return counted(fcs(31, 24), word_cnt);
+    return counted(fcs(31, 24) ^ mask, word_cnt);
     break;
   case 1:
-    return counted(fcs(23, 16), word_cnt);
+    return counted(fcs(23, 16) ^ mask, word_cnt);
     break;
   case 2:
-    return counted(fcs(15, 8), word_cnt);
+    return counted(fcs(15, 8) ^ mask, word_cnt);
     break;
   case 3:
-    return counted(fcs(7, 0), word_cnt, true);
+    return counted(fcs(7, 0) ^ mask, word_cnt, true);
     break;
   default:
     return {true, 0, 0};
@@ -51,13 +52,20 @@ axis_word FCSWordGenerator::get_next_word() {
   }
 }
 
-void FCSWordGenerator::add_to_fcs(const ap_uint<8> &word) {
+void FCSWordGenerator::add_to_fcs(const axis_word &word) {
 #pragma HLS INLINE
 
-  fcs.add(word);
+  fcs.add<DATAPATH_BYTES>(word.data, word.keep);
+}
+
+void FCSWordGenerator::invalidate() {
+#pragma HLS INLINE
+
+  invalid = true;
 }
 
 void FCSWordGenerator::reset() {
   word_cnt = 0;
+  invalid = false;
   fcs.reset();
 }
@@ -36,15 +36,19 @@
 #include "counted.hpp"
 #include <ap_int.h>
 
+// Hands out the FCS of the bytes added. The FCS of an invalidated frame is
+// inverted, so the frame is dropped by its receiver.
 class FCSWordGenerator {
 public:
-  FCSWordGenerator() : word_cnt(0) {}
-  axis_word get_next_word();
-  void add_to_fcs(const ap_uint<8> &word);
+  FCSWordGenerator() : word_cnt(0), invalid(false) {}
+  byte_word get_next_word();
+  void add_to_fcs(const axis_word &word);
+  void invalidate();
   void reset();
 
 private:
   ap_uint<2> word_cnt;
+  ap_uint<1> invalid;
   CRC32 fcs;
 };
 
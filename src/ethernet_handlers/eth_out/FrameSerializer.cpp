@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FrameSerializer.hpp"
+
+void FrameSerializer::handle(hls::stream<TxWord> &tx_words,
+                             phy_data &txd,
+                             ap_uint<1> &txen) {
+#pragma HLS INLINE
+
+  if (!this->sending && !tx_words.empty()) {
+    this->word = fill_in_fcs(tx_words.read());
+    this->sending = true;
+  }
+
+  if (this->sending) {
+    txd = this->word.data(PHY_DATA_WIDTH * this->symbol_cnt +
+                              PHY_DATA_WIDTH - 1,
+                          PHY_DATA_WIDTH * this->symbol_cnt);
+    txen = true;
+    if (this->symbol_cnt ==
+        PHY_CYCLES_PER_BYTE * this->word.num_bytes() - 1) {
+      this->symbol_cnt = 0;
+      this->sending = false;
+    } else {
+      this->symbol_cnt++;
+    }
+  } else {
+    txd = 0;
+    txen = false;
+  }
+}
+
+// The FCS bytes follow the last data byte in the same word, so the data
+// bytes of the word are added first
+axis_word FrameSerializer::fill_in_fcs(const TxWord &tx_word) {
+#pragma HLS INLINE
+
+  axis_word ret = tx_word.word;
+  fcsWordGenerator.add_to_fcs(
+      axis_word(tx_word.word.data, tx_word.data_lanes, false, 0));
+  if (tx_word.invalid) {
+    fcsWordGenerator.invalidate();
+  }
+  for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+    if (tx_word.fcs_lanes[i]) {
+      ret.set_byte(i, fcsWordGenerator.get_next_word().data);
+    }
+  }
+  if (tx_word.word.last) {
+    fcsWordGenerator.reset();
+  }
+  return ret;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FRAME_SERIALIZER
+#define FRAME_SERIALIZER
+#pragma once
+
+#include "../utils/bit_width.hpp"
+#include "../utils/phy.hpp"
+#include "FCSWordGenerator.hpp"
+#include "TxWord.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Fills in the FCS of the words of tx_words and sends them symbol by symbol
+// on txd. A word is taken in the cycle after the last symbol of the word
+// before, so the words have to come in at line rate, as the DataSender times
+// them.
+class FrameSerializer {
+public:
+  FrameSerializer() : sending(false), symbol_cnt(0) {}
+  void handle(hls::stream<TxWord> &tx_words, phy_data &txd, ap_uint<1> &txen);
+
+private:
+  axis_word fill_in_fcs(const TxWord &tx_word);
+  axis_word word;
+  ap_uint<1> sending;
+  ap_uint<bit_width<MAX_SYMBOL_INDEX + 1>::value> symbol_cnt;
+  FCSWordGenerator fcsWordGenerator;
+};
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "HeaderBuilder.hpp"
+
+// Writes value to the N bytes from pos on, most significant byte first
+template <int N>
+void put_bytes(ap_uint<8> bytes[], int pos, const ap_uint<8 * N> &value) {
+#pragma HLS INLINE
+
+  for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+    bytes[pos + i] = value(8 * (N - i) - 1, 8 * (N - i - 1));
+  }
+}
+
+void HeaderBuilder::build(const Addresses &loc, const Meta &meta) {
+#pragma HLS INLINE
+
+  put_bytes<6>(this->eth_header, 0, meta.dst_mac_addr);
+  put_bytes<6>(this->eth_header, 6, loc.mac_addr);
+  if (meta.vlan.tagged) {
+    put_bytes<2>(this->eth_header, 12, VLAN);
+    put_bytes<2>(this->eth_header, 14, meta.vlan.tci);
+    put_bytes<2>(this->eth_header, 16, meta.ether_type);
+    this->eth_bytes = ETH_HEADER_BYTE_SIZE + VLAN_TAG_BYTE_SIZE;
+  } else {
+    put_bytes<2>(this->eth_header, 12, meta.ether_type);
+    this->eth_bytes = ETH_HEADER_BYTE_SIZE;
+  }
+
+  this->ip_pkt = meta.ether_type == IPv4;
+  if (this->ip_pkt) {
+    ap_uint<1> icmp_pkt = meta.ip_protocol == ICMP;
+    ap_uint<16> ip_pkt_length =
+        meta.payload_length + (icmp_pkt ? IP_AND_ICMP_HEADER_BYTE_SIZE
+                                        : IP_AND_UDP_HEADER_BYTE_SIZE);
+    ap_uint<16> udp_pkt_length =
+        meta.payload_length + UDP_PKT_HEADER_BYTE_SIZE;
+    ap_uint<16> ip_hop_count_and_protocol;
+    ip_hop_count_and_protocol(15, 8) = IP_HOP_COUNT;
+    ip_hop_count_and_protocol(7, 0) = meta.ip_protocol;
+
+    put_bytes<1>(this->pkt_header, 0, IP_VERSION_AND_STD_IHL);
+    put_bytes<1>(this->pkt_header, 1, 0); // DSCP + ECN
+    put_bytes<2>(this->pkt_header, 2, ip_pkt_length);
+    put_bytes<2>(this->pkt_header, 4, meta.ip_id);
+    put_bytes<2>(this->pkt_header, 6, 0); // Flags + fragment offset
+    put_bytes<2>(this->pkt_header, 8, ip_hop_count_and_protocol);
+    put_bytes<2>(this->pkt_header, 10, 0); // Checksum, see update()
+    put_bytes<4>(this->pkt_header, 12, loc.ip_addr);
+    put_bytes<4>(this->pkt_header, 16, meta.dst_ip_addr);
+    if (icmp_pkt) {
+      // Type and code are 0, so the checksum covers the echoed payload only
+      Checksum icmp_checksum(meta.payload_checksum);
+      put_bytes<1>(this->pkt_header, 20, ICMP_ECHO_REPLY);
+      put_bytes<1>(this->pkt_header, 21, 0); // Code
+      put_bytes<2>(this->pkt_header, 22, icmp_checksum.get_value());
+      this->pkt_bytes = IP_AND_ICMP_HEADER_BYTE_SIZE;
+    } else {
+      put_bytes<2>(this->pkt_header, 20, loc.udp_port);
+      put_bytes<2>(this->pkt_header, 22, meta.dst_udp_port);
+      put_bytes<2>(this->pkt_header, 24, udp_pkt_length);
+      put_bytes<2>(this->pkt_header, 26, 0); // Checksum, see update()
+      this->pkt_bytes = IP_AND_UDP_HEADER_BYTE_SIZE;
+    }
+    this->udp_checksum_used = !icmp_pkt && !meta.no_udp_checksum;
+
+    this->ip_terms[0] = IP_VERSION_AND_STD_IHL_AND_NO_SPECIAL;
+    this->ip_terms[1] = loc.ip_addr(31, 16);
+    this->ip_terms[2] = loc.ip_addr(15, 0);
+    this->ip_terms[3] = ip_pkt_length;
+    this->ip_terms[4] = meta.dst_ip_addr(31, 16);
+    this->ip_terms[5] = meta.dst_ip_addr(15, 0);
+    this->ip_terms[6] = meta.ip_id;
+    this->ip_terms[7] = ip_hop_count_and_protocol;
+
+    // The pseudo header, the UDP header and the payload
+    this->udp_terms[0] = loc.ip_addr(31, 16);
+    this->udp_terms[1] = loc.ip_addr(15, 0);
+    this->udp_terms[2] = meta.dst_ip_addr(31, 16);
+    this->udp_terms[3] = meta.dst_ip_addr(15, 0);
+    this->udp_terms[4] = 0x0011;
+    this->udp_terms[5] = udp_pkt_length;
+    this->udp_terms[6] = loc.udp_port;
+    this->udp_terms[7] = meta.dst_udp_port;
+    this->udp_terms[8] = udp_pkt_length;
+    this->udp_terms[9] = meta.payload_checksum;
+  } else {
+    // Requests leave the target MAC address open
+    ap_uint<48> target_mac_addr = meta.arp_operation == ARP_REQUEST
+                                      ? ap_uint<48>(0)
+                                      : meta.dst_mac_addr;
+    put_bytes<6>(this->pkt_header, 0, ARP_IPV4_OVER_ETHERNET);
+    put_bytes<2>(this->pkt_header, 6, meta.arp_operation);
+    put_bytes<6>(this->pkt_header, 8, loc.mac_addr);
+    put_bytes<4>(this->pkt_header, 14, loc.ip_addr);
+    put_bytes<6>(this->pkt_header, 18, target_mac_addr);
+    put_bytes<4>(this->pkt_header, 24, meta.dst_ip_addr);
+    this->pkt_bytes = ARP_PKT_BYTE_SIZE;
+    this->udp_checksum_used = false;
+  }
+
+  this->ip_checksum.reset();
+  this->udp_checksum.reset();
+  this->term_cnt = 0;
+}
+
+// Adds the next terms to the checksums and writes them to the header once
+// all terms are summed up. Called every cycle.
+void HeaderBuilder::update() {
+#pragma HLS INLINE
+
+  if (this->term_cnt < NUM_UDP_CHECKSUM_TERMS) {
+    if (this->term_cnt < NUM_IP_CHECKSUM_TERMS) {
+      this->ip_checksum.add(this->ip_terms[this->term_cnt]);
+    }
+    this->udp_checksum.add(this->udp_terms[this->term_cnt]);
+    this->term_cnt++;
+  } else if (this->term_cnt == NUM_UDP_CHECKSUM_TERMS) {
+    if (this->ip_pkt) {
+      put_bytes<2>(this->pkt_header, 10, this->ip_checksum.get_value());
+    }
+    if (this->udp_checksum_used) {
+      put_bytes<2>(this->pkt_header, 26, this->udp_checksum.get_value());
+    }
+    this->term_cnt++;
+  }
+}
+
+ap_uint<8>
+HeaderBuilder::get_byte(const ap_uint<FRAME_LENGTH_WIDTH> &index) const {
+#pragma HLS INLINE
+
+  if (index < this->eth_bytes) {
+    return this->eth_header[index];
+  }
+  return this->pkt_header[index - this->eth_bytes];
+}
+
+// Bytes of the headers
+ap_uint<6> HeaderBuilder::get_length() const {
+#pragma HLS INLINE
+
+  return this->eth_bytes + this->pkt_bytes;
+}
+
+// Bytes the frame is padded to, without the FCS
+ap_uint<7> HeaderBuilder::get_min_length() const {
+#pragma HLS INLINE
+
+  return this->eth_bytes + MIN_ETH_PAYLOAD_BYTE_SIZE;
+}
+
+// Whether payload from the buffers follows the headers, as it does for IP
+ap_uint<1> HeaderBuilder::has_payload() const {
+#pragma HLS INLINE
+
+  return this->ip_pkt;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEADER_BUILDER
+#define HEADER_BUILDER
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/bit_width.hpp"
+#include "../utils/checksums/Checksum.hpp"
+#include "../utils/protocols.hpp"
+#include "Meta.hpp"
+#include <ap_int.h>
+
+const int ETH_HEADER_BYTE_SIZE = 14;
+const int VLAN_TAG_BYTE_SIZE = 4;
+const int IP_PKT_HEADER_BYTE_SIZE = 20;
+const int UDP_PKT_HEADER_BYTE_SIZE = 8;
+// Identifier and sequence number come with the echoed payload
+const int ICMP_PKT_HEADER_BYTE_SIZE = 4;
+const int IP_AND_UDP_HEADER_BYTE_SIZE =
+    IP_PKT_HEADER_BYTE_SIZE + UDP_PKT_HEADER_BYTE_SIZE;
+const int IP_AND_ICMP_HEADER_BYTE_SIZE =
+    IP_PKT_HEADER_BYTE_SIZE + ICMP_PKT_HEADER_BYTE_SIZE;
+// Frames are padded to the minimum payload size of Ethernet
+const int MIN_ETH_PAYLOAD_BYTE_SIZE = 46;
+
+const ap_uint<8> IP_VERSION_AND_STD_IHL = 0x45;
+const ap_uint<16> IP_VERSION_AND_STD_IHL_AND_NO_SPECIAL = 0x4500;
+const ap_uint<8> IP_HOP_COUNT = 0x80;
+
+// Words summed up into the IP header checksum and into the UDP checksum, one
+// of each per cycle
+const int NUM_IP_CHECKSUM_TERMS = 8;
+const int NUM_UDP_CHECKSUM_TERMS = 10;
+
+// Builds the headers of a frame up to its payload into a buffer as soon as its
+// meta is known: Ethernet, with the 802.1Q tag of meta.vlan if it is set,
+// followed by IP and UDP, by IP and ICMP or by the whole ARP packet. The
+// checksums are summed up by update() over the next cycles, while the
+// preamble is sent, and are in place long before the bytes are read. So no
+// byte of the header depends on the bytes generated before it.
+class HeaderBuilder {
+public:
+  HeaderBuilder()
+      : eth_bytes(ETH_HEADER_BYTE_SIZE),
+        term_cnt(NUM_UDP_CHECKSUM_TERMS + 1) {}
+  void build(const Addresses &loc, const Meta &meta);
+  void update();
+  ap_uint<8> get_byte(const ap_uint<FRAME_LENGTH_WIDTH> &index) const;
+  ap_uint<6> get_length() const;
+  ap_uint<7> get_min_length() const;
+  ap_uint<1> has_payload() const;
+
+private:
+  ap_uint<8> eth_header[ETH_HEADER_BYTE_SIZE + VLAN_TAG_BYTE_SIZE];
+  ap_uint<8> pkt_header[ARP_PKT_BYTE_SIZE];
+  ap_uint<5> eth_bytes;
+  ap_uint<5> pkt_bytes;
+  ap_uint<1> ip_pkt;
+  ap_uint<1> udp_checksum_used;
+  ap_uint<16> ip_terms[NUM_IP_CHECKSUM_TERMS];
+  ap_uint<16> udp_terms[NUM_UDP_CHECKSUM_TERMS];
+  Checksum ip_checksum;
+  Checksum udp_checksum;
+  ap_uint<bit_width<NUM_UDP_CHECKSUM_TERMS + 1>::value> term_cnt;
+};
+
+#endif
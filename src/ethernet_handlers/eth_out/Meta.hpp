@@ -31,14 +31,40 @@
 #define META
 #pragma once
 
+#include "../utils/VLANTag.hpp"
+#include "../utils/bit_width.hpp"
+#include "../utils/frame_size.hpp"
 #include <ap_int.h>
 
+// Number of transmit queues, each a TXQueue of its own
+#ifndef NUM_TX_QUEUES
+#define NUM_TX_QUEUES 2
+#endif
+
+#if NUM_TX_QUEUES < 2
+#error "NUM_TX_QUEUES has to be at least 2"
+#endif
+
+const int TX_QUEUE_ID_WIDTH = bit_width<NUM_TX_QUEUES - 1>::value;
+
+// Describes the next frame to send. ARP frames carry no payload, they are
+// built from the addresses and arp_operation alone. UDP packets are sent with
+// a checksum of 0 if no_udp_checksum is set. ip_id is the identification of
+// the IP packet, vlan the tag the frame is sent with and queue the transmit
+// queue holding its payload.
 struct Meta {
   ap_uint<16> payload_checksum;
-  ap_uint<11> payload_length;
+  ap_uint<FRAME_LENGTH_WIDTH> payload_length;
   ap_uint<48> dst_mac_addr;
   ap_uint<32> dst_ip_addr;
   ap_uint<16> dst_udp_port;
+  ap_uint<16> ether_type;
+  ap_uint<8> ip_protocol;
+  ap_uint<16> arp_operation;
+  ap_uint<1> no_udp_checksum;
+  ap_uint<16> ip_id;
+  VLANTag vlan;
+  ap_uint<TX_QUEUE_ID_WIDTH> queue;
 };
 
 #endif
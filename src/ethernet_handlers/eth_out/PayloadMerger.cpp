@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PayloadMerger.hpp"
+
+byte_word PayloadMerger::get_next_byte(const HeaderBuilder &header,
+                                       BufferReader &buffer) {
+#pragma HLS INLINE
+
+  byte_word word = {0, false, 0};
+  switch (state) {
+  case HEADER:
+    word.data = header.get_byte(byte_cnt);
+    if (byte_cnt == header.get_length() - 1) {
+      state = header.has_payload() ? PAYLOAD : PADDING;
+    }
+    break;
+  case PAYLOAD:
+    // The word of a cut-through frame may not be written in time
+    if (buffer.has_byte()) {
+      word = buffer.read();
+    } else {
+      poisoned = true;
+    }
+    if (word.last && byte_cnt < header.get_min_length() - 1) {
+      word.last = false;
+      state = PADDING;
+    }
+    break;
+  case PADDING:
+    word.last = byte_cnt == header.get_min_length() - 1;
+    break;
+  default:
+    break;
+  }
+  byte_cnt++;
+  return word;
+}
+
+ap_uint<1> PayloadMerger::is_poisoned() const {
+#pragma HLS INLINE
+
+  return this->poisoned;
+}
+
+void PayloadMerger::reset() {
+  byte_cnt = 0;
+  state = HEADER;
+  poisoned = false;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PAYLOAD_MERGER
+#define PAYLOAD_MERGER
+#pragma once
+
+#include "../utils/axis_word.hpp"
+#include "../utils/frame_size.hpp"
+#include "BufferReader.hpp"
+#include "HeaderBuilder.hpp"
+#include <ap_int.h>
+
+// Hands out the bytes of the headers built by HeaderBuilder, followed by the
+// payload from the buffer and the padding up to the minimum frame size. A
+// byte of the payload missing from the buffer is sent as 0, and the frame is
+// poisoned.
+class PayloadMerger {
+public:
+  PayloadMerger() : byte_cnt(0), state(HEADER), poisoned(false) {}
+  byte_word get_next_byte(const HeaderBuilder &header, BufferReader &buffer);
+  ap_uint<1> is_poisoned() const;
+  void reset();
+
+private:
+  enum state_type { HEADER, PAYLOAD, PADDING };
+  ap_uint<FRAME_LENGTH_WIDTH> byte_cnt;
+  state_type state;
+  ap_uint<1> poisoned;
+};
+
+#endif
@@ -29,7 +29,7 @@
 
 #include "PreambleWordGenerator.hpp"
 
-axis_word PreambleWordGenerator::get_next_word() {
+byte_word PreambleWordGenerator::get_next_word() {
 #pragma HLS INLINE
 
   if (word_cnt == 7) {
@@ -38,7 +38,7 @@
 class PreambleWordGenerator {
 public:
   PreambleWordGenerator() : word_cnt(0) {}
-  axis_word get_next_word();
+  byte_word get_next_word();
   void reset();
 
 private:
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "QueueDemux.hpp"
+
+ap_uint<TX_QUEUE_ID_WIDTH> queue_of(const VLANTag &vlan) {
+#pragma HLS INLINE
+
+  if (!vlan.tagged) {
+    return 0;
+  }
+  return vlan.pcp() * NUM_TX_QUEUES / 8;
+}
+
+void QueueDemux::handle(hls::stream<axis_word> &data_in,
+                        hls::stream<axis_word> queue_in[NUM_TX_QUEUES]) {
+#pragma HLS INLINE
+
+  if (!this->held_valid && !data_in.empty()) {
+    this->held = data_in.read();
+    this->held_valid = true;
+    if (!this->in_frame) {
+      this->queue = queue_of(this->held.get_vlan());
+    }
+    this->in_frame = !this->held.last;
+  }
+  if (this->held_valid) {
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+      if (i == this->queue && !queue_in[i].full()) {
+        queue_in[i].write(this->held);
+        this->held_valid = false;
+        this->written_words[i]++;
+      }
+    }
+  }
+}
+
+// Words written to the queue so far, wrapping around
+ap_uint<16> QueueDemux::get_written_words(int queue) const {
+#pragma HLS INLINE
+
+  return this->written_words[queue];
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef QUEUE_DEMUX
+#define QUEUE_DEMUX
+#pragma once
+
+#include "../utils/VLANTag.hpp"
+#include "../utils/axis_word.hpp"
+#include "Meta.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+ap_uint<TX_QUEUE_ID_WIDTH> queue_of(const VLANTag &vlan);
+
+// Hands the frames of data_in on to the transmit queue of their priority. The
+// priority code points are spread evenly over the queues, untagged frames go
+// to queue 0. A word whose queue has no room is held until it has.
+class QueueDemux {
+public:
+  QueueDemux() : held_valid(false), in_frame(false), queue(0) {
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+      this->written_words[i] = 0;
+    }
+  }
+  void handle(hls::stream<axis_word> &data_in,
+              hls::stream<axis_word> queue_in[NUM_TX_QUEUES]);
+  ap_uint<16> get_written_words(int queue) const;
+
+private:
+  axis_word held;
+  ap_uint<1> held_valid;
+  ap_uint<1> in_frame;
+  ap_uint<TX_QUEUE_ID_WIDTH> queue;
+  ap_uint<16> written_words[NUM_TX_QUEUES];
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TXPacer.hpp"
+
+// Takes the rate and burst size and refills the buckets once per period. Has
+// to be called every cycle.
+void TXPacer::update(const ap_uint<16> &rate_bytes,
+                     const ap_uint<16> &burst_bytes) {
+#pragma HLS INLINE
+
+  this->rate_bytes = rate_bytes;
+  this->burst_bytes = burst_bytes;
+  ap_uint<1> refill = this->period_cnt == TX_PACER_PERIOD - 1;
+  this->period_cnt = refill ? 0 : this->period_cnt + 1;
+
+  for (int i = 0; i < TX_PACER_FLOWS; i++) {
+#pragma HLS UNROLL
+    ap_uint<17> filled = this->tokens[i] + rate_bytes;
+    if (rate_bytes == 0) {
+      this->tokens[i] = 0xFFFF;
+    } else if (refill) {
+      this->tokens[i] =
+          filled < burst_bytes ? ap_uint<16>(filled) : burst_bytes;
+    }
+  }
+}
+
+ap_uint<1> TXPacer::allows(const Meta &meta) const {
+#pragma HLS INLINE
+
+  flow_index index;
+  ap_uint<16> tokens;
+  ap_uint<1> found = this->find(meta, index, tokens);
+  return this->rate_bytes == 0 ||
+         (found &&
+          (tokens >= meta.payload_length || tokens == this->burst_bytes));
+}
+
+// Only called for frames allows let pass
+void TXPacer::charge(const Meta &meta) {
+#pragma HLS INLINE
+
+  flow_index index;
+  ap_uint<16> tokens;
+  this->find(meta, index, tokens);
+  this->ip_addrs[index] = meta.dst_ip_addr;
+  this->udp_ports[index] = meta.dst_udp_port;
+  this->tokens[index] =
+      tokens > meta.payload_length ? ap_uint<16>(tokens - meta.payload_length)
+                                   : ap_uint<16>(0);
+}
+
+// Finds the entry of the destination of meta, or else the first free one,
+// along with the tokens it holds, at most burst_bytes
+ap_uint<1> TXPacer::find(const Meta &meta,
+                         flow_index &index,
+                         ap_uint<16> &tokens) const {
+#pragma HLS INLINE
+
+  ap_uint<1> matched = false;
+  ap_uint<1> free_found = false;
+  flow_index match_index = 0;
+  flow_index free_index = 0;
+  for (int i = 0; i < TX_PACER_FLOWS; i++) {
+#pragma HLS UNROLL
+    ap_uint<1> full = this->tokens[i] >= this->burst_bytes;
+    if (!matched && this->ip_addrs[i] == meta.dst_ip_addr &&
+        this->udp_ports[i] == meta.dst_udp_port) {
+      matched = true;
+      match_index = i;
+    }
+    if (!free_found && full) {
+      free_found = true;
+      free_index = i;
+    }
+  }
+  index = matched ? match_index : free_index;
+  tokens = this->tokens[index] < this->burst_bytes ? this->tokens[index]
+                                                   : this->burst_bytes;
+  return matched || free_found;
+}
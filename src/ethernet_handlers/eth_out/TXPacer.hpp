@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_PACER
+#define TX_PACER
+#pragma once
+
+#include "../utils/bit_width.hpp"
+#include "Meta.hpp"
+#include <ap_int.h>
+
+// Number of destinations paced at a time
+#ifndef TX_PACER_FLOWS
+#define TX_PACER_FLOWS 16
+#endif
+
+#if TX_PACER_FLOWS < 1
+#error "TX_PACER_FLOWS has to be at least 1"
+#endif
+
+// Cycles between two refills of the token buckets
+#ifndef TX_PACER_PERIOD
+#define TX_PACER_PERIOD 64
+#endif
+
+// Paces the frames of the transmit queues by their destination, the pair of
+// destination IP address and UDP port. A table of TX_PACER_FLOWS entries holds
+// a token bucket of up to burst_bytes per destination, which gains rate_bytes
+// every TX_PACER_PERIOD cycles. A frame waits until the bucket of its
+// destination holds its payload or is full, and then takes its payload out of
+// it. A full bucket is no different from a new one, so its entry is free for
+// any destination. A destination without an entry starts with a full bucket
+// in a free entry, or waits for one if all are taken, so destinations never
+// share a bucket. With rate_bytes at 0 frames are not paced, and the buckets
+// are kept full.
+class TXPacer {
+public:
+  TXPacer() : rate_bytes(0), burst_bytes(0), period_cnt(0) {
+    for (int i = 0; i < TX_PACER_FLOWS; i++) {
+      this->ip_addrs[i] = 0;
+      this->udp_ports[i] = 0;
+      this->tokens[i] = 0xFFFF;
+    }
+  }
+  void update(const ap_uint<16> &rate_bytes, const ap_uint<16> &burst_bytes);
+  ap_uint<1> allows(const Meta &meta) const;
+  void charge(const Meta &meta);
+
+private:
+  typedef ap_uint<bit_width<TX_PACER_FLOWS - 1>::value> flow_index;
+  ap_uint<1>
+  find(const Meta &meta, flow_index &index, ap_uint<16> &tokens) const;
+  ap_uint<16> rate_bytes;
+  ap_uint<16> burst_bytes;
+  ap_uint<bit_width<TX_PACER_PERIOD - 1>::value> period_cnt;
+  ap_uint<32> ip_addrs[TX_PACER_FLOWS];
+  ap_uint<16> udp_ports[TX_PACER_FLOWS];
+  ap_uint<16> tokens[TX_PACER_FLOWS];
+};
+
+#endif
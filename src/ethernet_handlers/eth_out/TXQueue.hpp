@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_QUEUE_HPP
+#define TX_QUEUE_HPP
+#pragma once
+
+#include "../utils/bit_width.hpp"
+#include "../utils/buffer_word.hpp"
+#include "../utils/frame_size.hpp"
+#include "../utils/icmp_echo.hpp"
+#include "Meta.hpp"
+#include <ap_int.h>
+
+// Queue of up to F frames to send, with their payload in a ring buffer of W
+// words. The frames are added in the order of their words, but they may be
+// taken in any order, so a frame held back does not hold up the frames behind
+// it. The reader sees the frames by their age, 0 being the oldest. The words
+// of a frame are freed once it was read or dropped and all frames before it
+// are gone too. The words of the oldest frame are freed while it is read.
+template <int W, int F> class TXQueue {
+public:
+  TXQueue()
+      : word_wr_ptr(0), word_frame_ptr(0), word_free_ptr(0), word_rd_ptr(0),
+        used_words(0), frame_rd_ptr(0), used_frames(0), waiting(0),
+        poisoned(0), open(false), reading(false), read_slot(0) {}
+
+  // Room for a word and a frame
+  ap_uint<1> has_room() const {
+#pragma HLS INLINE
+
+    return this->has_word_room() && this->used_frames < F;
+  }
+
+  ap_uint<1> has_word_room() const {
+#pragma HLS INLINE
+
+    return this->used_words < W;
+  }
+
+  void write(const buffer_word &word) {
+#pragma HLS INLINE
+
+    this->words[this->word_wr_ptr] = word;
+    this->word_wr_ptr = next_word(this->word_wr_ptr);
+    this->used_words++;
+    if (word.last && this->open) {
+      this->open = false;
+      this->word_frame_ptr = this->word_wr_ptr;
+    }
+  }
+
+  // Adds the frame of the words written since the frame before
+  void add_frame(const Meta &meta) {
+#pragma HLS INLINE
+
+    this->insert(meta);
+    this->word_frame_ptr = this->word_wr_ptr;
+  }
+
+  // Adds the frame of the words written from now on, up to the one marked
+  // last. It may be taken before its words are all written.
+  void announce_frame(const Meta &meta) {
+#pragma HLS INLINE
+
+    this->insert(meta);
+    this->open = true;
+  }
+
+  // Marks the frame added last as not to be received, e.g. as its words do
+  // not match its meta
+  void poison() {
+#pragma HLS INLINE
+
+    this->poisoned[this->slot(this->used_frames - 1)] = true;
+  }
+
+  // The frame of the age is waiting to be taken
+  ap_uint<1> is_waiting(int age) const {
+#pragma HLS INLINE
+
+    return this->waiting[this->slot(age)];
+  }
+
+  Meta get_meta(int age) const {
+#pragma HLS INLINE
+
+    return this->metas[this->slot(age)];
+  }
+
+  // Starts reading the frame of the age
+  void take(int age) {
+#pragma HLS INLINE
+
+    frame_slot slot = this->slot(age);
+    this->waiting[slot] = false;
+    this->reading = true;
+    this->read_slot = slot;
+    this->word_rd_ptr = this->starts[slot];
+  }
+
+  void drop(int age) {
+#pragma HLS INLINE
+
+    this->waiting[this->slot(age)] = false;
+  }
+
+  // The next word of the frame being read was written
+  ap_uint<1> can_read() const {
+#pragma HLS INLINE
+
+    // Only the words of the newest frame may not all be written yet
+    frame_slot newest = this->slot(this->used_frames - 1);
+    return this->reading &&
+           (!this->open || this->read_slot != newest ||
+            this->word_rd_ptr != this->word_wr_ptr);
+  }
+
+  // The frame being read was poisoned
+  ap_uint<1> is_poisoned() const {
+#pragma HLS INLINE
+
+    return this->poisoned[this->read_slot];
+  }
+
+  buffer_word read() {
+#pragma HLS INLINE
+
+    buffer_word word = this->words[this->word_rd_ptr];
+    this->word_rd_ptr = next_word(this->word_rd_ptr);
+    this->reading = !word.last;
+    return word;
+  }
+
+  // Frees the words of the frames gone. Has to be called every cycle.
+  void update() {
+#pragma HLS INLINE
+
+    frame_slot oldest = this->frame_rd_ptr;
+    if (this->used_frames == 0 || this->waiting[oldest]) {
+      return;
+    }
+    if (this->reading && this->read_slot == oldest) {
+      this->free_words(this->word_rd_ptr, false);
+    } else if (this->used_frames > 1) {
+      this->free_words(this->starts[next_slot(oldest)], true);
+      this->frame_rd_ptr = next_slot(oldest);
+      this->used_frames--;
+    } else if (!this->open) {
+      this->free_words(this->word_frame_ptr, true);
+      this->frame_rd_ptr = next_slot(oldest);
+      this->used_frames--;
+    }
+  }
+
+  // Words of the frames not yet freed and of the frame being written
+  ap_uint<16> get_used_words() const {
+#pragma HLS INLINE
+
+    return this->used_words;
+  }
+
+  // Frames not yet freed
+  ap_uint<16> get_used_frames() const {
+#pragma HLS INLINE
+
+    return this->used_frames;
+  }
+
+private:
+  typedef ap_uint<bit_width<W - 1>::value> word_ptr;
+  typedef ap_uint<bit_width<F - 1>::value> frame_slot;
+
+  static word_ptr next_word(const word_ptr &ptr) {
+#pragma HLS INLINE
+
+    return ptr == W - 1 ? word_ptr(0) : word_ptr(ptr + 1);
+  }
+
+  static frame_slot next_slot(const frame_slot &slot) {
+#pragma HLS INLINE
+
+    return slot == F - 1 ? frame_slot(0) : frame_slot(slot + 1);
+  }
+
+  frame_slot slot(int age) const {
+#pragma HLS INLINE
+
+    ap_uint<bit_width<2 * F - 2>::value> slot = this->frame_rd_ptr + age;
+    return slot >= F ? frame_slot(slot - F) : frame_slot(slot);
+  }
+
+  void insert(const Meta &meta) {
+#pragma HLS INLINE
+
+    frame_slot slot = this->slot(this->used_frames);
+    this->metas[slot] = meta;
+    this->starts[slot] = this->word_frame_ptr;
+    this->waiting[slot] = true;
+    this->poisoned[slot] = false;
+    this->used_frames++;
+  }
+
+  // Frees the words up to end. The words of a whole frame that end where
+  // they start fill the ring.
+  void free_words(const word_ptr &end, const ap_uint<1> &whole_frame) {
+#pragma HLS INLINE
+
+    if (end > this->word_free_ptr) {
+      this->used_words -= end - this->word_free_ptr;
+    } else if (end < this->word_free_ptr ||
+               (whole_frame && this->used_words == W)) {
+      this->used_words -= W - this->word_free_ptr + end;
+    }
+    this->word_free_ptr = end;
+  }
+
+  buffer_word words[W];
+  Meta metas[F];
+  word_ptr starts[F];
+  word_ptr word_wr_ptr;
+  word_ptr word_frame_ptr;
+  word_ptr word_free_ptr;
+  word_ptr word_rd_ptr;
+  ap_uint<bit_width<W>::value> used_words;
+  frame_slot frame_rd_ptr;
+  ap_uint<bit_width<F>::value> used_frames;
+  ap_uint<F> waiting;
+  ap_uint<F> poisoned;
+  ap_uint<1> open;
+  ap_uint<1> reading;
+  frame_slot read_slot;
+};
+
+// Frames of the largest size the buffer of a transmit queue holds. With two,
+// a frame can be taken in while the one before is sent, as its words are only
+// freed as it is read. Each frame takes MAX_UDP_PAYLOAD_BYTES of block RAM in
+// words of 9 * DATAPATH_BYTES + 1 bits, one to two 18 Kbit block RAMs per
+// frame and queue with 1518 byte frames, and six times that with jumbo frames.
+#ifndef TX_BUFFER_FRAMES
+#define TX_BUFFER_FRAMES 2
+#endif
+
+#if TX_BUFFER_FRAMES < 1
+#error "TX_BUFFER_FRAMES has to be at least 1"
+#endif
+
+const int TX_BUFFER_WORDS =
+    TX_BUFFER_FRAMES * MAX_UDP_PAYLOAD_BYTES / DATAPATH_BYTES;
+
+// Frames held by a transmit queue
+const int TX_META_WORDS = 6;
+
+// Sizes of the queue of the echo replies, which holds the largest one
+const int TX_ECHO_BUFFER_WORDS =
+    (ICMP_ECHO_BYTES + DATAPATH_BYTES - 1) / DATAPATH_BYTES;
+const int TX_ECHO_META_WORDS = 2;
+
+typedef TXQueue<TX_BUFFER_WORDS, TX_META_WORDS> tx_queue;
+typedef TXQueue<TX_ECHO_BUFFER_WORDS, TX_ECHO_META_WORDS> echo_queue;
+
+#endif
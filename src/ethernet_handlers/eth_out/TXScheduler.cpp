@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TXScheduler.hpp"
+
+typedef ap_uint<bit_width<TX_META_WORDS - 1>::value> tx_frame_age;
+
+// Looks for the frame queue offers, see TXScheduler
+ap_uint<1> find_head(const tx_queue &queue,
+                     const ap_uint<TX_META_WORDS> &resolved,
+                     const TXPacer &pacer,
+                     Meta &head,
+                     tx_frame_age &age) {
+#pragma HLS INLINE
+
+  ap_uint<1> found = false;
+  for (int i = 0; i < TX_META_WORDS; i++) {
+#pragma HLS UNROLL
+    Meta frame = queue.get_meta(i);
+    ap_uint<1> overtakes = false;
+    for (int j = 0; j < i; j++) {
+#pragma HLS UNROLL
+      Meta before = queue.get_meta(j);
+      if (queue.is_waiting(j) && before.dst_ip_addr == frame.dst_ip_addr &&
+          before.dst_udp_port == frame.dst_udp_port) {
+        overtakes = true;
+      }
+    }
+    if (!found && queue.is_waiting(i) && resolved[i] && !overtakes &&
+        pacer.allows(frame)) {
+      found = true;
+      head = frame;
+      age = i;
+    }
+  }
+  return found;
+}
+
+ap_uint<1> TXScheduler::next_frame(tx_queue queues[NUM_TX_QUEUES],
+                                   const tx_queue_quanta &quanta,
+                                   const tx_frame_flags &resolved,
+                                   TXPacer &pacer,
+                                   Meta &meta) {
+#pragma HLS INLINE
+
+  Meta heads[NUM_TX_QUEUES];
+  tx_frame_age ages[NUM_TX_QUEUES];
+  ap_uint<NUM_TX_QUEUES> ready = 0;
+  ap_uint<NUM_TX_QUEUES> waiting = 0;
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+    ready[i] = find_head(queues[i],
+                         resolved(TX_META_WORDS * i + TX_META_WORDS - 1,
+                                  TX_META_WORDS * i),
+                         pacer,
+                         heads[i],
+                         ages[i]);
+    for (int j = 0; j < TX_META_WORDS; j++) {
+#pragma HLS UNROLL
+      if (queues[i].is_waiting(j)) {
+        waiting[i] = true;
+      }
+    }
+  }
+
+  ap_uint<1> found = false;
+  ap_uint<TX_QUEUE_ID_WIDTH> queue = 0;
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+    if (quanta(16 * i + 15, 16 * i) == 0 && ready[i]) {
+      found = true;
+      queue = i;
+    }
+  }
+
+  if (!found) {
+    queue = this->current;
+    if (ready[queue] && this->deficits[queue] >= heads[queue].payload_length) {
+      found = true;
+    }
+  }
+
+  // Turn to the next queue with a frame, which may be the current one again
+  if (!found) {
+    if (!waiting[queue]) {
+      this->deficits[queue] = 0;
+    }
+    ap_uint<1> next_found = false;
+    ap_uint<TX_QUEUE_ID_WIDTH> next_queue = 0;
+    for (int i = NUM_TX_QUEUES; i > 0; i--) {
+#pragma HLS UNROLL
+      ap_uint<TX_QUEUE_ID_WIDTH + 1> candidate = this->current + i;
+      if (candidate >= NUM_TX_QUEUES) {
+        candidate -= NUM_TX_QUEUES;
+      }
+      if (ready[candidate]) {
+        next_found = true;
+        next_queue = candidate;
+      }
+    }
+    if (!next_found) {
+      return false;
+    }
+    queue = next_queue;
+    this->current = next_queue;
+    this->deficits[queue] += quanta(16 * queue + 15, 16 * queue);
+    if (this->deficits[queue] < heads[queue].payload_length) {
+      return false;
+    }
+  }
+
+  if (quanta(16 * queue + 15, 16 * queue) != 0) {
+    this->deficits[queue] -= heads[queue].payload_length;
+  }
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+    if (i == queue) {
+      queues[i].take(ages[i]);
+    }
+  }
+  meta = heads[queue];
+  meta.queue = queue;
+  pacer.charge(meta);
+  this->scheduled_frames[queue]++;
+  return true;
+}
+
+// Frames taken from the queue so far
+ap_uint<32> TXScheduler::get_scheduled_frames(int queue) const {
+#pragma HLS INLINE
+
+  return this->scheduled_frames[queue];
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_SCHEDULER
+#define TX_SCHEDULER
+#pragma once
+
+#include "../utils/bit_width.hpp"
+#include "../utils/frame_size.hpp"
+#include "Meta.hpp"
+#include "TXPacer.hpp"
+#include "TXQueue.hpp"
+#include <ap_int.h>
+
+// Quantum of each transmit queue in payload bytes, entry i at bits 16 * i + 15
+// to 16 * i. Queues with a quantum of 0 are served in strict priority.
+typedef ap_uint<16 * NUM_TX_QUEUES> tx_queue_quanta;
+
+// A 32 bit counter per transmit queue, entry i at bits 32 * i + 31 to 32 * i
+typedef ap_uint<32 * NUM_TX_QUEUES> tx_queue_counters;
+
+// A flag per frame of the transmit queues, the one of the frame of age k in
+// queue i at bit TX_META_WORDS * i + k
+typedef ap_uint<NUM_TX_QUEUES * TX_META_WORDS> tx_frame_flags;
+
+// Deficits stay below the largest payload plus the largest quantum
+const int TX_DEFICIT_WIDTH = bit_width<MAX_UDP_PAYLOAD_BYTES + 0xFFFF>::value;
+
+// Picks the frame to send next. Strict priority queues go first, the highest
+// one first. The other queues take turns by deficit round robin: each turn
+// adds the quantum of a queue to its deficit, which its frames are sent from
+// as long as it covers their payload. An emptied queue loses its deficit. A
+// turn that does not yet reach the length of the frame costs a cycle, so
+// quanta of at least the payload size keep the line busy.
+// Each queue offers its oldest frame that is resolved, that the pacer allows
+// and that no frame before it in the queue goes to the same destination IP
+// address and UDP port. So frames held back only hold up the frames to their
+// own destination, and the frames to a destination keep their order.
+class TXScheduler {
+public:
+  TXScheduler() : current(0) {
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+      this->deficits[i] = 0;
+      this->scheduled_frames[i] = 0;
+    }
+  }
+  ap_uint<1> next_frame(tx_queue queues[NUM_TX_QUEUES],
+                        const tx_queue_quanta &quanta,
+                        const tx_frame_flags &resolved,
+                        TXPacer &pacer,
+                        Meta &meta);
+  ap_uint<32> get_scheduled_frames(int queue) const;
+
+private:
+  ap_uint<TX_DEFICIT_WIDTH> deficits[NUM_TX_QUEUES];
+  ap_uint<TX_QUEUE_ID_WIDTH> current;
+  ap_uint<32> scheduled_frames[NUM_TX_QUEUES];
+};
+
+#endif
@@ -1,31 +1,102 @@
-open_project proj_eth_out -reset
-set_top eth_out
-add_files eth_out.cpp
-add_files DataInputAnalyzer.cpp
-add_files DataSender.cpp
-add_files DataWordGenerator.cpp
-add_files ETHPacketWordGenerator.cpp
-add_files FCSWordGenerator.cpp
-add_files IPPacketWordGenerator.cpp
-add_files PayloadWordGenerator.cpp
-add_files PreambleWordGenerator.cpp
-add_files UDPPacketWordGenerator.cpp
-add_files ../utils/checksums/Checksum.cpp
-add_files ../utils/checksums/CRC32.cpp
-add_files ../utils/axis_word.cpp
-add_files -tb eth_out_test.cpp
-add_files -tb ../utils/test/Frame.cpp
-add_files -tb ../utils/test/ETHPacket.cpp
-add_files -tb ../utils/test/IPPacket.cpp
-add_files -tb ../utils/test/UDPPacket.cpp
-add_files -tb ../utils/test/calculate_checksum.cpp
-add_files -tb ../utils/Addresses.cpp
-open_solution "solution1"
-set_part {xc7a100tcsg324-1}
-create_clock -period 20 -name default
-set_clock_uncertainty 1
-config_rtl -module_auto_prefix -reset all -reset_level high
-csim_design
-csynth_design
-cosim_design -rtl verilog -tool xsim
-export_design -format ip_catalog -flow impl -ipname eth_out -library eth -output ../../ip/eth_out -rtl verilog -vendor ME -version 1.0.0
+set design_files {
+  eth_out.cpp
+  ARPCache.cpp
+  ARPResolver.cpp
+  BufferReader.cpp
+  DataInputAnalyzer.cpp
+  DataInputForwarder.cpp
+  DataSender.cpp
+  DataWordGenerator.cpp
+  FCSWordGenerator.cpp
+  FrameSerializer.cpp
+  HeaderBuilder.cpp
+  PayloadMerger.cpp
+  PreambleWordGenerator.cpp
+  QueueDemux.cpp
+  TXPacer.cpp
+  TXScheduler.cpp
+  ../utils/checksums/Checksum.cpp
+  ../utils/checksums/CRC32.cpp
+  ../utils/FIFOMonitor.cpp
+  ../utils/StatCounters.cpp
+  ../utils/axis_word.cpp
+}
+set tb_files {
+  eth_out_test.cpp
+  ../eth_in/eth_in.cpp
+  ../eth_in/ARPPacketHandler.cpp
+  ../eth_in/AxisWordGenerator.cpp
+  ../eth_in/DataAligner.cpp
+  ../eth_in/DataBundler.cpp
+  ../eth_in/DataForwarder.cpp
+  ../eth_in/DataSpotter.cpp
+  ../eth_in/EchoBuffer.cpp
+  ../eth_in/EthDataHandler.cpp
+  ../eth_in/FCSValidator.cpp
+  ../eth_in/FrameBuffer.cpp
+  ../eth_in/ICMPPacketHandler.cpp
+  ../eth_in/IPPacketHandler.cpp
+  ../eth_in/Reassembler.cpp
+  ../eth_in/UDPPacketHandler.cpp
+  ../utils/test/ARPPacket.cpp
+  ../utils/test/Frame.cpp
+  ../utils/test/ICMPPacket.cpp
+  ../utils/test/ETHPacket.cpp
+  ../utils/test/IPPacket.cpp
+  ../utils/test/UDPPacket.cpp
+  ../utils/test/calculate_checksum.cpp
+  ../utils/ARPEvent.cpp
+  ../utils/Addresses.cpp
+}
+
+# IP name, compiler flags and clock period in ns of every variant
+set variants {
+  eth_out {} 20
+  eth_out_cut_through {-DETH_OUT_CUT_THROUGH=1} 20
+  eth_out_4byte {-DDATAPATH_BYTES=4} 20
+  eth_out_8byte {-DDATAPATH_BYTES=8} 20
+  eth_out_jumbo {-DMAX_FRAME_BYTES=9018} 20
+  eth_out_dataflow {-DETH_OUT_DATAFLOW=1} 8
+  eth_out_gmii {-DPHY_GMII=1 -DETH_OUT_DATAFLOW=1} 8
+}
+
+foreach {ip_name cflags period} $variants {
+  open_project proj_$ip_name -reset
+  set_top eth_out
+  foreach file $design_files {
+    add_files $file -cflags $cflags
+  }
+  foreach file $tb_files {
+    add_files -tb $file -cflags $cflags
+  }
+  open_solution "solution1"
+  set_part {xc7a100tcsg324-1}
+  create_clock -period $period -name default
+  set_clock_uncertainty 1
+  config_rtl -module_auto_prefix -reset all -reset_level high
+  csim_design
+  csynth_design
+  cosim_design -rtl verilog -tool xsim
+  export_design -format ip_catalog -flow impl -ipname $ip_name -library eth -output ../../ip/$ip_name -rtl verilog -vendor ME -version 1.0.0
+}
+
+# Name and compiler flags of variants that are only simulated, to test limits
+# the default configuration takes too long to reach
+set csim_variants {
+  eth_out_arp_limits {-DARP_RETRY_CYCLES=2000 -DARP_MAX_REQUESTS=2}
+  eth_out_one_frame {-DTX_BUFFER_FRAMES=1 -DARP_RETRY_CYCLES=2000 -DARP_MAX_REQUESTS=2}
+}
+
+foreach {name cflags} $csim_variants {
+  open_project proj_$name -reset
+  set_top eth_out
+  foreach file $design_files {
+    add_files $file -cflags $cflags
+  }
+  foreach file $tb_files {
+    add_files -tb $file -cflags $cflags
+  }
+  open_solution "solution1"
+  set_part {xc7a100tcsg324-1}
+  csim_design
+}
@@ -35,7 +35,7 @@
 #include <ap_int.h>
 
 template <int I>
-axis_word counted(const ap_uint<8> &data, ap_uint<I> &cnt, bool last = false) {
+byte_word counted(const ap_uint<8> &data, ap_uint<I> &cnt, bool last = false) {
 #pragma HLS INLINE
 
   cnt++;
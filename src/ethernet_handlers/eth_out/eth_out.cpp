@@ -29,21 +29,281 @@
 
 #include "eth_out.hpp"
 
+// Takes the frames in, queues them and hands the words of the frames chosen
+// to tx_words at line rate, without their FCS. Also counts the frames and
+// keeps track of the FIFOs.
+void send_frames(hls::stream<axis_word> &data_in,
+#if ETH_OUT_CUT_THROUGH
+                 hls::stream<PayloadDescriptor> &desc_in,
+#endif
+                 hls::stream<ARPEvent> &arp_in,
+                 hls::stream<axis_word> &icmp_in,
+                 hls::stream<TxWord> &tx_words,
+                 const Addresses &loc,
+                 const ap_uint<8> &ipg_bytes,
+                 const ap_uint<16> &segment_bytes,
+                 const ap_uint<8> &ip_id_restart,
+                 const tx_queue_quanta &queue_quanta,
+                 const ap_uint<16> &pacing_rate,
+                 const ap_uint<16> &pacing_burst,
+                 tx_queue_counters &queued_frames,
+                 tx_queue_counters &dropped_frames,
+                 const ap_uint<8> &stats_snapshot,
+                 const ap_uint<8> &stats_select,
+                 ap_uint<64> &stats_value,
+                 const ap_uint<8> &fifo_select,
+                 ap_uint<64> &fifo_value) {
+#pragma HLS INLINE
+
+#if ETH_OUT_CUT_THROUGH
+  static DataInputForwarder dataInputForwarder;
+#else
+  static QueueDemux queueDemux;
+  static DataInputAnalyzer dataInputAnalyzers[NUM_TX_QUEUES];
+  static hls::stream<axis_word> queue_in[NUM_TX_QUEUES];
+#pragma HLS STREAM variable = queue_in depth = TX_QUEUE_IN_WORDS
+#endif
+  static DataInputAnalyzer echoInputAnalyzer(ICMP);
+  static DataSender dataSender;
+  static tx_queue queues[NUM_TX_QUEUES];
+  static echo_queue echo;
+  static FIFOMonitor fifoMonitors[NUM_TX_FIFOS];
+
+#if ETH_OUT_CUT_THROUGH
+  dataInputForwarder.handle(data_in, desc_in, queues[0]);
+#else
+  queueDemux.handle(data_in, queue_in);
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+    dataInputAnalyzers[i].handle(queue_in[i], queues[i], segment_bytes);
+  }
+#endif
+  echoInputAnalyzer.handle(icmp_in, echo, 0);
+  dataSender.handle(tx_words,
+                    queues,
+                    echo,
+                    arp_in,
+                    loc,
+                    ipg_bytes,
+                    ip_id_restart,
+                    queue_quanta,
+                    pacing_rate,
+                    pacing_burst);
+
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+#if ETH_OUT_CUT_THROUGH
+    ap_uint<32> written = 0;
+    if (i == 0) {
+      written = dataInputForwarder.get_frame_count();
+    }
+#else
+    ap_uint<32> written = dataInputAnalyzers[i].get_frame_count();
+#endif
+    queued_frames(32 * i + 31, 32 * i) =
+        written - dataSender.get_scheduled_frames(i);
+    dropped_frames(32 * i + 31, 32 * i) = dataSender.get_dropped_frames(i);
+  }
+
+  // The levels of the queues are the words and frames not yet freed
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+#pragma HLS UNROLL
+#if ETH_OUT_CUT_THROUGH
+    ap_uint<16> queue_in_level = 0;
+#else
+    ap_uint<16> queue_in_level = queueDemux.get_written_words(i) -
+                                 dataInputAnalyzers[i].get_word_count();
+#endif
+    ap_uint<16> buffer_level = queues[i].get_used_words();
+    ap_uint<16> meta_level = queues[i].get_used_frames();
+    fifoMonitors[TX_QUEUE_IN_FIFO + i].update(
+        queue_in_level, queue_in_level >= TX_QUEUE_IN_WORDS);
+    fifoMonitors[TX_BUFFER_FIFO + i].update(buffer_level,
+                                            buffer_level >= TX_BUFFER_WORDS);
+    fifoMonitors[TX_META_FIFO + i].update(meta_level,
+                                          meta_level >= TX_META_WORDS);
+    queues[i].update();
+  }
+  ap_uint<16> echo_buffer_level = echo.get_used_words();
+  ap_uint<16> echo_meta_level = echo.get_used_frames();
+  fifoMonitors[TX_ECHO_BUFFER_FIFO].update(
+      echo_buffer_level, echo_buffer_level >= TX_ECHO_BUFFER_WORDS);
+  fifoMonitors[TX_ECHO_META_FIFO].update(
+      echo_meta_level, echo_meta_level >= TX_ECHO_META_WORDS);
+  echo.update();
+
+  ap_uint<1> snapshot_taken =
+      dataSender.publish_stats(stats_snapshot, stats_select, stats_value);
+  publish_fifos<NUM_TX_FIFOS>(
+      fifoMonitors, snapshot_taken, fifo_select, fifo_value);
+}
+
+// Fills in the FCS and sends the words on txd
+void serialize(hls::stream<TxWord> &tx_words, phy_data &txd, ap_uint<1> &txen) {
+#pragma HLS INLINE
+
+  static FrameSerializer frameSerializer;
+  frameSerializer.handle(tx_words, txd, txen);
+}
+
+#if ETH_OUT_DATAFLOW
+// The stages as processes of their own, connected by tx_words
+void send_frames_process(hls::stream<axis_word> &data_in,
+#if ETH_OUT_CUT_THROUGH
+                         hls::stream<PayloadDescriptor> &desc_in,
+#endif
+                         hls::stream<ARPEvent> &arp_in,
+                         hls::stream<axis_word> &icmp_in,
+                         hls::stream<TxWord> &tx_words,
+                         const Addresses &loc,
+                         const ap_uint<8> &ipg_bytes,
+                         const ap_uint<16> &segment_bytes,
+                         const ap_uint<8> &ip_id_restart,
+                         const tx_queue_quanta &queue_quanta,
+                         const ap_uint<16> &pacing_rate,
+                         const ap_uint<16> &pacing_burst,
+                         tx_queue_counters &queued_frames,
+                         tx_queue_counters &dropped_frames,
+                         const ap_uint<8> &stats_snapshot,
+                         const ap_uint<8> &stats_select,
+                         ap_uint<64> &stats_value,
+                         const ap_uint<8> &fifo_select,
+                         ap_uint<64> &fifo_value) {
+#pragma HLS PIPELINE II = 1
+
+  send_frames(data_in,
+#if ETH_OUT_CUT_THROUGH
+              desc_in,
+#endif
+              arp_in,
+              icmp_in,
+              tx_words,
+              loc,
+              ipg_bytes,
+              segment_bytes,
+              ip_id_restart,
+              queue_quanta,
+              pacing_rate,
+              pacing_burst,
+              queued_frames,
+              dropped_frames,
+              stats_snapshot,
+              stats_select,
+              stats_value,
+              fifo_select,
+              fifo_value);
+}
+
+void serialize_process(hls::stream<TxWord> &tx_words,
+                       phy_data &txd,
+                       ap_uint<1> &txen) {
+#pragma HLS PIPELINE II = 1
+
+  serialize(tx_words, txd, txen);
+}
+#endif
+
 void eth_out(hls::stream<axis_word> &data_in,
-             ap_uint<2> &txd,
+#if ETH_OUT_CUT_THROUGH
+             hls::stream<PayloadDescriptor> &desc_in,
+#endif
+             hls::stream<ARPEvent> &arp_in,
+             hls::stream<axis_word> &icmp_in,
+             phy_data &txd,
              ap_uint<1> &txen,
-             const Addresses &loc) {
+             const Addresses &loc,
+             const ap_uint<8> &ipg_bytes,
+             const ap_uint<16> &segment_bytes,
+             const ap_uint<8> &ip_id_restart,
+             const tx_queue_quanta &queue_quanta,
+             const ap_uint<16> &pacing_rate,
+             const ap_uint<16> &pacing_burst,
+             tx_queue_counters &queued_frames,
+             tx_queue_counters &dropped_frames,
+             const ap_uint<8> &stats_snapshot,
+             const ap_uint<8> &stats_select,
+             ap_uint<64> &stats_value,
+             const ap_uint<8> &fifo_select,
+             ap_uint<64> &fifo_value) {
 #pragma HLS INTERFACE axis port = data_in
+#if ETH_OUT_CUT_THROUGH
+#pragma HLS INTERFACE axis port = desc_in
+#endif
+#pragma HLS INTERFACE axis port = arp_in
+#pragma HLS INTERFACE axis port = icmp_in
+#pragma HLS INTERFACE s_axilite port = ipg_bytes
+#pragma HLS INTERFACE s_axilite port = segment_bytes
+#pragma HLS INTERFACE s_axilite port = ip_id_restart
+#pragma HLS INTERFACE s_axilite port = queue_quanta
+#pragma HLS INTERFACE s_axilite port = pacing_rate
+#pragma HLS INTERFACE s_axilite port = pacing_burst
+#pragma HLS INTERFACE s_axilite port = queued_frames
+#pragma HLS INTERFACE s_axilite port = dropped_frames
+#pragma HLS INTERFACE s_axilite port = stats_snapshot
+#pragma HLS INTERFACE s_axilite port = stats_select
+#pragma HLS INTERFACE s_axilite port = stats_value
+#pragma HLS INTERFACE s_axilite port = fifo_select
+#pragma HLS INTERFACE s_axilite port = fifo_value
 #pragma HLS DISAGGREGATE variable = loc
-#pragma HLS PIPELINE II = 1
 
-  static DataInputAnalyzer dataInputAnalyzer;
-  static DataSender dataSender;
-  static hls::stream<axis_word> buffer;
-#pragma HLS STREAM variable = buffer depth = 1500
-  static hls::stream<Meta> meta_buffer;
-#pragma HLS STREAM variable = meta_buffer depth = 6
+#if ETH_OUT_DATAFLOW
+  // Without block level control both processes run freely, each of them every
+  // cycle. send_frames writes at most one word per cycle, and serialize takes
+  // each word in the cycle it arrives in, as the word before it was sent by
+  // then. tx_words thus holds at most one word, which a depth of 2 covers.
+#pragma HLS INTERFACE ap_ctrl_none port = return
+#pragma HLS DATAFLOW
+  hls::stream<TxWord> tx_words;
+#pragma HLS STREAM variable = tx_words depth = 2
+
+  send_frames_process(data_in,
+#if ETH_OUT_CUT_THROUGH
+                      desc_in,
+#endif
+                      arp_in,
+                      icmp_in,
+                      tx_words,
+                      loc,
+                      ipg_bytes,
+                      segment_bytes,
+                      ip_id_restart,
+                      queue_quanta,
+                      pacing_rate,
+                      pacing_burst,
+                      queued_frames,
+                      dropped_frames,
+                      stats_snapshot,
+                      stats_select,
+                      stats_value,
+                      fifo_select,
+                      fifo_value);
+  serialize_process(tx_words, txd, txen);
+#else
+#pragma HLS PIPELINE II = 1
+  static hls::stream<TxWord> tx_words;
+#pragma HLS STREAM variable = tx_words depth = 2
 
-  dataInputAnalyzer.handle(data_in, buffer, meta_buffer);
-  dataSender.handle(txd, txen, buffer, meta_buffer, loc);
+  send_frames(data_in,
+#if ETH_OUT_CUT_THROUGH
+              desc_in,
+#endif
+              arp_in,
+              icmp_in,
+              tx_words,
+              loc,
+              ipg_bytes,
+              segment_bytes,
+              ip_id_restart,
+              queue_quanta,
+              pacing_rate,
+              pacing_burst,
+              queued_frames,
+              dropped_frames,
+              stats_snapshot,
+              stats_select,
+              stats_value,
+              fifo_select,
+              fifo_value);
+  serialize(tx_words, txd, txen);
+#endif
 }
@@ -31,17 +31,121 @@
 #define ETH_OUT_HPP
 #pragma once
 
+#include "../utils/ARPEvent.hpp"
 #include "../utils/Addresses.hpp"
+#include "../utils/PayloadDescriptor.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/buffer_word.hpp"
+#include "../utils/frame_size.hpp"
+#include "../utils/phy.hpp"
 #include "DataInputAnalyzer.hpp"
+#include "DataInputForwarder.hpp"
 #include "DataSender.hpp"
+#include "FrameSerializer.hpp"
 #include "Meta.hpp"
+#include "QueueDemux.hpp"
+#include "TXPacer.hpp"
+#include "TXQueue.hpp"
+#include "TXScheduler.hpp"
+#include "TxWord.hpp"
+#include "tx_stats.hpp"
 #include <ap_int.h>
 #include <hls_stream.h>
 
+// With ETH_OUT_CUT_THROUGH set, a frame of data_in is sent as soon as its first
+// word arrived instead of once it is buffered completely. Its payload length
+// and checksum are then taken from the descriptor in desc_in, which has to be
+// written no later than the first word. From then on the words of the frame
+// have to follow at least at line rate. A frame whose words fall behind or do
+// not add up to the length of its descriptor is sent with a wrong FCS, so it
+// is dropped by the receiver (see DataInputForwarder). Only a cut-through
+// eth_out has desc_in.
+#ifndef ETH_OUT_CUT_THROUGH
+#define ETH_OUT_CUT_THROUGH 0
+#endif
+
+// With ETH_OUT_DATAFLOW set, the FCS and the serialization of the words into
+// symbols of txd run as a process of their own beside the rest of eth_out,
+// connected by a shallow stream. The paths of the CRC then no longer share a
+// cycle with those of the scheduler and the queues, which lets the core run at
+// 125 MHz beside a GMII PHY (see the eth_out_gmii variant of build.tcl and
+// PHY_GMII in phy.hpp). The core then has no block level control and runs
+// from reset on. Otherwise all stages share one pipeline built for 50 MHz.
+#ifndef ETH_OUT_DATAFLOW
+#define ETH_OUT_DATAFLOW 0
+#endif
+
+// Depth of the FIFOs ahead of the transmit queues in words
+const int TX_QUEUE_IN_WORDS = 2;
+
+// A frame with destination MAC address 0 in user(47, 0) is sent to the MAC
+// address the ARP cache holds for its destination IP address. Until the
+// address is resolved the frame waits, the frames to other destinations are
+// sent meanwhile (see ARPResolver). The cache learns
+// from the ARP packets eth_in receives, which also yield the replies to
+// requests for loc. The echo requests eth_in passes on over icmp_in are
+// answered ahead of the frames of data_in. Frames are sent ipg_bytes apart,
+// but at least the 12 bytes of the standard. Unless segment_bytes is 0, every
+// frame of data_in is sent as a series of UDP packets of segment_bytes payload
+// each (see DataInputAnalyzer). The packets of eth_out are numbered in their
+// IP identification, UDP packets and echo replies separately. Writing a new
+// value to ip_id_restart starts both numberings at 0 again. Segmentation
+// needs the checksums of the store and forward mode, so a cut-through eth_out
+// ignores segment_bytes.
+//
+// Frames are sent with the VLAN tag in the user field of their words (see
+// axis_word), echo replies with the tag of their request. Frames of a higher
+// priority code point are queued separately (see QueueDemux). Which queue is
+// sent from next is up to queue_quanta (see TXScheduler): queues with a
+// quantum of 0 are sent ahead of those waiting in lower queues, the others
+// share the line by deficit round robin. The frame being sent is finished
+// first either way. A cut-through eth_out sends the frames in the order of
+// data_in. ARP replies are sent in the VLAN of their request, ARP requests in
+// the VLAN of the frame waiting for the address.
+//
+// Unless pacing_rate is 0, the frames to each destination IP address and UDP
+// port are paced to pacing_rate bytes of payload every TX_PACER_PERIOD cycles,
+// in bursts of up to pacing_burst bytes (see TXPacer). Up to TX_PACER_FLOWS
+// destinations are paced at a time. A frame held back only holds up the
+// frames to its own destination, in its queue as in the others (see
+// TXScheduler). A frame of more than pacing_burst bytes waits for a full
+// bucket.
+//
+// All ports run on the clock of the PHY. The hierarchy of cdc.tcl puts
+// data_in and desc_in behind asynchronous FIFOs into a clock domain of their
+// own.
+//
+// queued_frames holds the frames waiting in each transmit queue, and
+// dropped_frames those of each queue dropped as no MAC address was found for
+// their destination. Both are read over AXI-Lite.
+//
+// The frames sent are counted in the counters of tx_stat. Writing a new value
+// to stats_snapshot takes a snapshot of them and clears them. stats_value then
+// holds the snapshot of the counter in stats_select. The snapshot also covers
+// the values of fifo_stat kept for each FIFO of tx_fifo, of which fifo_value
+// holds the one in fifo_select.
+
 void eth_out(hls::stream<axis_word> &data_in,
-             ap_uint<2> &txd,
+#if ETH_OUT_CUT_THROUGH
+             hls::stream<PayloadDescriptor> &desc_in,
+#endif
+             hls::stream<ARPEvent> &arp_in,
+             hls::stream<axis_word> &icmp_in,
+             phy_data &txd,
              ap_uint<1> &txen,
-             const Addresses &loc);
+             const Addresses &loc,
+             const ap_uint<8> &ipg_bytes,
+             const ap_uint<16> &segment_bytes,
+             const ap_uint<8> &ip_id_restart,
+             const tx_queue_quanta &queue_quanta,
+             const ap_uint<16> &pacing_rate,
+             const ap_uint<16> &pacing_burst,
+             tx_queue_counters &queued_frames,
+             tx_queue_counters &dropped_frames,
+             const ap_uint<8> &stats_snapshot,
+             const ap_uint<8> &stats_select,
+             ap_uint<64> &stats_value,
+             const ap_uint<8> &fifo_select,
+             ap_uint<64> &fifo_value);
 
 #endif
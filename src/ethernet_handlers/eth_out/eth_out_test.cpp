@@ -27,35 +27,239 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "../utils/ARPEvent.hpp"
+#include "../eth_in/eth_in.hpp"
 #include "../utils/Addresses.hpp"
+#include "../utils/PayloadDescriptor.hpp"
+#include "../utils/VLANTag.hpp"
 #include "../utils/axis_word.hpp"
+#include "../utils/checksums/CRC32.hpp"
+#include "../utils/frame_size.hpp"
+#include "../utils/icmp_echo.hpp"
+#include "../utils/phy.hpp"
+#include "../utils/port_table.hpp"
+#include "../utils/protocols.hpp"
+#include "../utils/test/ARPFrame.hpp"
 #include "../utils/test/Comparison.hpp"
+#include "../utils/test/ETHFrame.hpp"
+#include "../utils/test/ICMPFrame.hpp"
 #include "../utils/test/ITest.hpp"
+#include "../utils/test/IPPacket.hpp"
 #include "../utils/test/InputStreamFeed.hpp"
 #include "../utils/test/OutputValueStore.hpp"
 #include "../utils/test/TimedValue.hpp"
 #include "../utils/test/UDPFrame.hpp"
+#include "../utils/test/UDPPacket.hpp"
+#include "../utils/test/calculate_checksum.hpp"
+#include "../utils/test/pack_words.hpp"
+#include "../utils/test/report.hpp"
+#include "../utils/vlan_table.hpp"
 #include "eth_out.hpp"
+#include <algorithm>
 #include <ap_int.h>
+#include <cstdlib>
 #include <initializer_list>
+#include <iostream>
 #include <string>
 #include <vector>
 
+// Descriptors of the frames in data_in_tv, each written along with the first
+// byte of its frame. Only a cut-through eth_out reads them.
+std::vector<TimedValue<PayloadDescriptor> >
+describe(const std::vector<TimedValue<byte_word> > &data_in_tv,
+         const ap_uint<1> &no_checksum) {
+  std::vector<TimedValue<PayloadDescriptor> > ret;
+  if (!ETH_OUT_CUT_THROUGH) {
+    return ret;
+  }
+  std::vector<ap_uint<8> > payload;
+  int first_index = 0;
+  for (int i = 0; i < data_in_tv.size(); i++) {
+    if (payload.empty()) {
+      first_index = data_in_tv[i].index;
+    }
+    payload.push_back(data_in_tv[i].value.data);
+    if (data_in_tv[i].value.last) {
+      ap_uint<16> sum = calculate_checksum(payload);
+      sum.b_not();
+      ret.push_back({first_index, {payload.size(), sum, no_checksum}});
+      payload.clear();
+    }
+  }
+  return ret;
+}
+
+// Sends message through eth_out in segments of segment_bytes and checks that
+// the frames on txd hold segments of expected_bytes, numbered from 0. Returns
+// the number of errors.
+int check_segments(const std::string &name,
+                   const std::vector<ap_uint<8> > &message,
+                   const ap_uint<16> &segment_bytes,
+                   int expected_bytes,
+                   const Addresses &loc,
+                   const Addresses &dst,
+                   const ap_uint<8> &ip_id_restart) {
+  std::vector<std::vector<phy_data> > expected;
+  for (int i = 0; i < message.size(); i += expected_bytes) {
+    int end = std::min<int>(i + expected_bytes, message.size());
+    std::vector<ap_uint<8> > segment(message.begin() + i,
+                                     message.begin() + end);
+    expected.push_back(UDPFrame(loc, dst, segment, expected.size()));
+  }
+  std::vector<TimedValue<byte_word> > message_in;
+  for (int i = 0; i < message.size(); i++) {
+    message_in.push_back({i, {message[i], i == message.size() - 1, dst}});
+  }
+  hls::stream<axis_word> data_in;
+  hls::stream<PayloadDescriptor> desc_in;
+  hls::stream<ARPEvent> arp_in;
+  hls::stream<axis_word> icmp_in;
+  for (const TimedValue<axis_word> &word : pack_words(message_in)) {
+    data_in.write(word.value);
+  }
+  std::vector<std::vector<phy_data> > frames;
+  tx_queue_counters queued_frames;
+  tx_queue_counters dropped_frames;
+  ap_uint<64> stats_value;
+  ap_uint<64> fifo_value;
+  ap_uint<1> last_txen = 0;
+  for (int j = 0; (frames.size() < expected.size() || last_txen) &&
+                  j < 100 * PHY_CYCLES_PER_BYTE * message.size();
+       j++) {
+    phy_data txd;
+    ap_uint<1> txen;
+    eth_out(data_in,
+#if ETH_OUT_CUT_THROUGH
+            desc_in,
+#endif
+            arp_in,
+            icmp_in,
+            txd,
+            txen,
+            loc,
+            MIN_IPG_BYTES,
+            segment_bytes,
+            ip_id_restart,
+            0,
+            0,
+            0,
+            queued_frames,
+            dropped_frames,
+            0,
+            0,
+            stats_value,
+            0,
+            fifo_value);
+    if (txen && !last_txen) {
+      frames.push_back({});
+    }
+    if (txen) {
+      frames.back().push_back(txd);
+    }
+    last_txen = txen;
+  }
+  return report(name,
+                frames == expected,
+                std::to_string(frames.size()) + " of " +
+                    std::to_string(expected.size()) + " frames");
+}
+
+// Takes a snapshot of the statistics of eth_out by a change of stats_snapshot
+// to snapshot and reads out the counters, one per cycle
+std::vector<ap_uint<64> > read_stats(const Addresses &loc,
+                                     const ap_uint<8> &snapshot) {
+  hls::stream<axis_word> data_in;
+  hls::stream<PayloadDescriptor> desc_in;
+  hls::stream<ARPEvent> arp_in;
+  hls::stream<axis_word> icmp_in;
+  tx_queue_counters queued_frames;
+  tx_queue_counters dropped_frames;
+  ap_uint<64> fifo_value;
+  std::vector<ap_uint<64> > values(NUM_TX_STATS);
+  for (int i = 0; i < NUM_TX_STATS; i++) {
+    phy_data txd;
+    ap_uint<1> txen;
+    eth_out(data_in,
+#if ETH_OUT_CUT_THROUGH
+            desc_in,
+#endif
+            arp_in,
+            icmp_in,
+            txd,
+            txen,
+            loc,
+            MIN_IPG_BYTES,
+            0,
+            0,
+            0,
+            0,
+            0,
+            queued_frames,
+            dropped_frames,
+            snapshot,
+            i,
+            values[i],
+            0,
+            fifo_value);
+  }
+  return values;
+}
+
+// Whether the frame on txd, from its preamble to its FCS, has a valid FCS
+ap_uint<1> has_valid_fcs(const std::vector<phy_data> &frame) {
+  CRC32 fcs;
+  // The preamble and SFD take the first 8 bytes
+  for (int i = 8 * PHY_CYCLES_PER_BYTE; i + PHY_CYCLES_PER_BYTE <= frame.size();
+       i += PHY_CYCLES_PER_BYTE) {
+    ap_uint<8> byte = 0;
+    for (int j = 0; j < PHY_CYCLES_PER_BYTE; j++) {
+      byte(PHY_DATA_WIDTH * j + PHY_DATA_WIDTH - 1, PHY_DATA_WIDTH * j) =
+          frame[i + j];
+    }
+    fcs.add(byte);
+  }
+  return fcs.get_accumulator() == CRC32_RESIDUE_INV_BREV;
+}
+
 template <int L> class EthOutTest : public ITest {
 public:
   InputStreamFeed<axis_word> data_in_feed;
-  OutputValueStore<ap_uint<2>, L> txd_store;
+  InputStreamFeed<PayloadDescriptor> desc_in_feed;
+  InputStreamFeed<ARPEvent> arp_in_feed;
+  InputStreamFeed<axis_word> icmp_in_feed;
+  OutputValueStore<phy_data, L> txd_store;
   OutputValueStore<ap_uint<1>, L> txen_store;
   Addresses loc;
+  ap_uint<16> segment_bytes;
+  tx_queue_quanta queue_quanta;
+  ap_uint<8> ipg_bytes;
+  tx_queue_counters queued_frames;
+  tx_queue_counters dropped_frames;
+  ap_uint<64> stats_value;
+  ap_uint<64> fifo_value;
   EthOutTest(const std::string &title,
-             const std::vector<TimedValue<axis_word> > &data_in_tv,
-             const std::vector<ap_uint<2> > &txd_tv,
+             const std::vector<TimedValue<byte_word> > &data_in_tv,
+             const std::vector<phy_data> &txd_tv,
              const std::vector<ap_uint<1> > &txen_tv,
-             const Addresses &loc)
-      : ITest(title), data_in_feed(data_in_tv), txd_store("TXD", txd_tv, 0, 4),
-        txen_store("TXEN", txen_tv, 0, 8), loc(loc) {}
+             const Addresses &loc,
+             const std::vector<TimedValue<ARPEvent> > &arp_in_tv = {},
+             const std::vector<TimedValue<byte_word> > &icmp_in_tv = {},
+             const ap_uint<1> &no_udp_checksum = false,
+             const ap_uint<16> &segment_bytes = 0,
+             const tx_queue_quanta &queue_quanta = 0,
+             const ap_uint<8> &ipg_bytes = MIN_IPG_BYTES)
+      : ITest(title), data_in_feed(pack_words(data_in_tv)),
+        desc_in_feed(describe(data_in_tv, no_udp_checksum)),
+        arp_in_feed(arp_in_tv), icmp_in_feed(pack_words(icmp_in_tv)),
+        txd_store("TXD", txd_tv, 0, PHY_CYCLES_PER_BYTE),
+        txen_store("TXEN", txen_tv, 0, 8), loc(loc),
+        segment_bytes(segment_bytes), queue_quanta(queue_quanta),
+        ipg_bytes(ipg_bytes) {}
   void feed_inputs(int step_index) override {
     this->data_in_feed.feed(step_index);
+    this->desc_in_feed.feed(step_index);
+    this->arp_in_feed.feed(step_index);
+    this->icmp_in_feed.feed(step_index);
   }
   void store_outputs(int step_index) override {
     this->txd_store.store(step_index);
@@ -69,23 +273,82 @@ private:
   }
 };
 
+// Runs the test with eth_in receiving rxd and handing its ARP packets and echo
+// requests on to eth_out, and returns the number of errors found
+template <int L>
+int run_through_eth_in(EthOutTest<L> &test,
+                       const std::vector<phy_data> &rxd,
+                       const vlan_table &vlans) {
+  hls::stream<axis_word> data_out;
+  ap_uint<32> dropped_frames;
+  ap_uint<64> stats_value;
+  ap_uint<64> fifo_value;
+  for (int j = 0; j < L; j++) {
+    ap_uint<1> crsdv = j < rxd.size();
+    eth_in(crsdv ? rxd[j] : phy_data(0),
+           0,
+           crsdv,
+           data_out,
+           test.arp_in_feed.stream,
+           test.icmp_in_feed.stream,
+           dropped_frames,
+           test.loc,
+           port_table(test.loc.udp_port),
+           vlans,
+           0,
+           0,
+           stats_value,
+           0,
+           fifo_value);
+    eth_out(test.data_in_feed.stream,
+#if ETH_OUT_CUT_THROUGH
+            test.desc_in_feed.stream,
+#endif
+            test.arp_in_feed.stream,
+            test.icmp_in_feed.stream,
+            test.txd_store.value,
+            test.txen_store.value,
+            test.loc,
+            MIN_IPG_BYTES,
+            0,
+            0,
+            0,
+            0,
+            0,
+            test.queued_frames,
+            test.dropped_frames,
+            0,
+            0,
+            test.stats_value,
+            0,
+            test.fifo_value);
+    test.store_outputs(j);
+  }
+  return test.get_result();
+}
+
 int main() {
-  const int NUM_CYCLES = 700;
+  const int NUM_CYCLES = 1400;
+  const ap_uint<8> IPG_BYTES = 12;
   std::vector<EthOutTest<NUM_CYCLES> > tests;
   int errors = 0;
 
   const Addresses loc = {0x123456789abc, 0x13579bdf, 0xde60};
   const Addresses dst = {0xfedcba987654, 0x98765432, 0x0035};
 
-  std::vector<ap_uint<2> > packet_d(UDPFrame(loc, dst, {0xAA}));
-  std::vector<ap_uint<1> > packet_en(288, 1);
-  std::vector<ap_uint<2> > ipg_d(96, 0);
-  std::vector<ap_uint<1> > ipg_en(96, 0);
-  std::vector<ap_uint<2> > output_d(packet_d);
+  // The UDP packets and the echo replies are numbered separately in their IP
+  // identification, which every test restarts at 0.
+  std::vector<phy_data> packet_d(UDPFrame(loc, dst, {0xAA}, 0));
+  std::vector<phy_data> second_packet_d(UDPFrame(loc, dst, {0xAA}, 1));
+  std::vector<ap_uint<1> > packet_en(packet_d.size(), 1);
+  std::vector<phy_data> ipg_d(PHY_CYCLES_PER_BYTE * IPG_BYTES, 0);
+  std::vector<ap_uint<1> > ipg_en(PHY_CYCLES_PER_BYTE * IPG_BYTES, 0);
+  std::vector<phy_data> output_d(packet_d);
   std::vector<ap_uint<1> > output_en(packet_en);
   output_d.insert(output_d.end(), ipg_d.begin(), ipg_d.end());
   output_en.insert(output_en.end(), ipg_en.begin(), ipg_en.end());
-  output_d.insert(output_d.end(), packet_d.begin(), packet_d.end());
+  output_d.insert(
+      output_d.end(), second_packet_d.begin(), second_packet_d.end());
   output_en.insert(output_en.end(), packet_en.begin(), packet_en.end());
   tests.push_back({"Normal packets with IPG",
                    {{0, {0xaa, true, dst}}, {1, {0xaa, true, dst}}},
@@ -93,16 +356,1234 @@ int main() {
                    output_en,
                    loc});
 
+  // A larger gap is kept as set, a smaller one is raised to the minimum
+  for (int ipg_bytes : {20, 4}) {
+    int gap_bytes = std::max<int>(ipg_bytes, MIN_IPG_BYTES);
+    std::vector<phy_data> gap_d(packet_d);
+    std::vector<ap_uint<1> > gap_en(packet_en);
+    gap_d.insert(gap_d.end(), PHY_CYCLES_PER_BYTE * gap_bytes, 0);
+    gap_en.insert(gap_en.end(), PHY_CYCLES_PER_BYTE * gap_bytes, 0);
+    gap_d.insert(gap_d.end(), second_packet_d.begin(), second_packet_d.end());
+    gap_en.insert(gap_en.end(), packet_en.begin(), packet_en.end());
+    tests.push_back({"Normal packets with an IPG of " +
+                         std::to_string(ipg_bytes) + " bytes",
+                     {{0, {0xaa, true, dst}}, {1, {0xaa, true, dst}}},
+                     gap_d,
+                     gap_en,
+                     loc,
+                     {},
+                     {},
+                     false,
+                     0,
+                     0,
+                     ipg_bytes});
+  }
+
+  std::vector<ap_uint<8> > long_payload;
+  std::vector<TimedValue<byte_word> > long_in;
+  for (int i = 0; i < 32; i++) {
+    long_payload.push_back(i);
+    long_in.push_back({i, {i, i == 31, dst}});
+  }
+  std::vector<phy_data> long_d(UDPFrame(loc, dst, long_payload));
+  std::vector<ap_uint<1> > long_en(long_d.size(), 1);
+  tests.push_back({"Long packet", long_in, long_d, long_en, loc});
+
+  std::vector<ap_uint<8> > carry_payload;
+  std::vector<TimedValue<byte_word> > carry_in;
+  for (int i = 0; i < 25; i++) {
+    carry_payload.push_back(0xF0 + i % 16);
+    carry_in.push_back({i, {carry_payload[i], i == 24, dst}});
+  }
+  std::vector<phy_data> carry_d(UDPFrame(loc, dst, carry_payload));
+  std::vector<ap_uint<1> > carry_en(carry_d.size(), 1);
+  tests.push_back(
+      {"Payload checksum with carries", carry_in, carry_d, carry_en, loc});
+
+  const ARPEvent request = {
+      ARP_REQUEST, dst.mac_addr, dst.ip_addr, loc.ip_addr};
+  std::vector<phy_data> reply_d(ARPFrame(ARP_REPLY, loc, dst));
+  tests.push_back({"ARP reply",
+                   {},
+                   reply_d,
+                   std::vector<ap_uint<1> >(reply_d.size(), 1),
+                   loc,
+                   {{0, request}}});
+
+  // The frames leave user(47, 0) at 0
+  const Addresses dst_ip = {0, dst.ip_addr, dst.udp_port};
+  const ARPEvent reply = {ARP_REPLY, dst.mac_addr, dst.ip_addr, loc.ip_addr};
+  std::vector<phy_data> cached_d(UDPFrame(loc, dst, {0xaa}));
+  tests.push_back({"Destination mac address from the ARP cache",
+                   {{1, {0xaa, true, dst_ip}}},
+                   cached_d,
+                   packet_en,
+                   loc,
+                   {{0, reply}}});
+
+  const Addresses unknown = {0x0a0b0c0d0e0f, 0x98765433, 0x0035};
+  const Addresses unknown_ip = {0, unknown.ip_addr, unknown.udp_port};
+  const ARPEvent unknown_reply = {
+      ARP_REPLY, unknown.mac_addr, unknown.ip_addr, loc.ip_addr};
+  std::vector<phy_data> resolve_d(ARPFrame(ARP_REQUEST, loc, unknown));
+  std::vector<ap_uint<1> > resolve_en(resolve_d.size(), 1);
+  resolve_d.resize(400, 0);
+  resolve_en.resize(400, 0);
+  std::vector<phy_data> unknown_d(UDPFrame(loc, unknown, {0xaa}));
+  resolve_d.insert(resolve_d.end(), unknown_d.begin(), unknown_d.end());
+  resolve_en.insert(resolve_en.end(), unknown_d.size(), 1);
+  tests.push_back({"ARP request for an unknown destination",
+                   {{0, {0xaa, true, unknown_ip}}},
+                   resolve_d,
+                   resolve_en,
+                   loc,
+                   {{400, unknown_reply}}});
+
+  // As handed on by eth_in
+  const std::vector<ap_uint<8> > echo{
+      0x12, 0x34, 0x00, 0x01, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77};
+  const Addresses dst_mac_ip = {dst.mac_addr, dst.ip_addr, 0};
+  std::vector<TimedValue<byte_word> > echo_in;
+  for (int i = 0; i < echo.size(); i++) {
+    echo_in.push_back({i, {echo[i], i == echo.size() - 1, dst_mac_ip}});
+  }
+  std::vector<phy_data> echo_d(ICMPFrame(loc, dst, ICMP_ECHO_REPLY, echo));
+  std::vector<ap_uint<1> > echo_en(echo_d.size(), 1);
+  tests.push_back({"Echo reply",
+                   {},
+                   echo_d,
+                   echo_en,
+                   loc,
+                   {},
+                   echo_in});
+
+  std::vector<ap_uint<8> > largest_echo(echo.begin(), echo.begin() + 4);
+  largest_echo.resize(ICMP_ECHO_BYTES, 0x5a);
+  std::vector<TimedValue<byte_word> > largest_echo_in;
+  for (int i = 0; i < largest_echo.size(); i++) {
+    largest_echo_in.push_back(
+        {i, {largest_echo[i], i == largest_echo.size() - 1, dst_mac_ip}});
+  }
+  std::vector<phy_data> largest_echo_d(
+      ICMPFrame(loc, dst, ICMP_ECHO_REPLY, largest_echo));
+  tests.push_back({"Echo reply of the largest size",
+                   {},
+                   largest_echo_d,
+                   std::vector<ap_uint<1> >(largest_echo_d.size(), 1),
+                   loc,
+                   {},
+                   largest_echo_in});
+
+  // Priority 0 in VLAN 5
+  const VLANTag vlan = {1, 0x0005};
+  byte_word tagged_in(0xaa, true, dst);
+  byte_word::set_vlan(tagged_in.user, vlan);
+  std::vector<phy_data> tagged_d(ETHFrame(
+      loc, dst, IPv4, IPPacket(loc, dst, UDP, UDPPacket(loc, dst, {0xaa})),
+      vlan));
+  tests.push_back({"VLAN tagged packet",
+                   {{0, tagged_in}},
+                   tagged_d,
+                   std::vector<ap_uint<1> >(tagged_d.size(), 1),
+                   loc});
+
+  // The request goes out in the VLAN of the frame waiting for the address
+  const Addresses tagged_unknown = {0x0a0b0c0d0e11, 0x98765435, 0x0035};
+  const Addresses tagged_unknown_ip = {
+      0, tagged_unknown.ip_addr, tagged_unknown.udp_port};
+  const ARPEvent tagged_unknown_reply = {
+      ARP_REPLY, tagged_unknown.mac_addr, tagged_unknown.ip_addr, loc.ip_addr};
+  byte_word tagged_unknown_in(0xaa, true, tagged_unknown_ip);
+  byte_word::set_vlan(tagged_unknown_in.user, vlan);
+  std::vector<phy_data> tagged_resolve_d(
+      ARPFrame(ARP_REQUEST, loc, tagged_unknown, vlan));
+  std::vector<ap_uint<1> > tagged_resolve_en(tagged_resolve_d.size(), 1);
+  tagged_resolve_d.resize(400, 0);
+  tagged_resolve_en.resize(400, 0);
+  std::vector<phy_data> tagged_unknown_d(
+      ETHFrame(loc,
+               tagged_unknown,
+               IPv4,
+               IPPacket(loc,
+                        tagged_unknown,
+                        UDP,
+                        UDPPacket(loc, tagged_unknown, {0xaa})),
+               vlan));
+  tagged_resolve_d.insert(
+      tagged_resolve_d.end(), tagged_unknown_d.begin(), tagged_unknown_d.end());
+  tagged_resolve_en.insert(tagged_resolve_en.end(), tagged_unknown_d.size(), 1);
+  tests.push_back({"ARP request in the VLAN of the frame",
+                   {{0, tagged_unknown_in}},
+                   tagged_resolve_d,
+                   tagged_resolve_en,
+                   loc,
+                   {{400, tagged_unknown_reply}}});
+
+#if ETH_OUT_CUT_THROUGH
+  std::vector<phy_data> no_checksum_d(
+      UDPFrame(loc, dst, long_payload, 0, false));
+  tests.push_back({"Zero UDP checksum",
+                   long_in,
+                   no_checksum_d,
+                   std::vector<ap_uint<1> >(no_checksum_d.size(), 1),
+                   loc,
+                   {},
+                   {},
+                   true});
+#else
+  std::vector<ap_uint<8> > message;
+  std::vector<TimedValue<byte_word> > message_in;
+  for (int i = 0; i < 24; i++) {
+    message.push_back(i);
+    message_in.push_back({i, {i, i == 23, dst}});
+  }
+  std::vector<ap_uint<8> > first_segment(message.begin(), message.begin() + 16);
+  std::vector<ap_uint<8> > last_segment(message.begin() + 16, message.end());
+  std::vector<phy_data> segments_d(UDPFrame(loc, dst, first_segment));
+  std::vector<ap_uint<1> > segments_en(segments_d.size(), 1);
+  std::vector<phy_data> last_segment_d(UDPFrame(loc, dst, last_segment, 1));
+  segments_d.insert(segments_d.end(), ipg_d.begin(), ipg_d.end());
+  segments_en.insert(segments_en.end(), ipg_en.begin(), ipg_en.end());
+  segments_d.insert(
+      segments_d.end(), last_segment_d.begin(), last_segment_d.end());
+  segments_en.insert(segments_en.end(), last_segment_d.size(), 1);
+  tests.push_back({"Segmented message",
+                   message_in,
+                   segments_d,
+                   segments_en,
+                   loc,
+                   {},
+                   {},
+                   false,
+                   16});
+
+  // The urgent frame overtakes the second bulk frame, which is still queued
+  // when the first one is done
+  const VLANTag urgent_vlan = {1, 0xE005};
+  byte_word urgent_in(0xbb, true, dst);
+  byte_word::set_vlan(urgent_in.user, urgent_vlan);
+  std::vector<phy_data> priority_d(UDPFrame(loc, dst, {0xaa}));
+  std::vector<phy_data> urgent_d(ETHFrame(
+      loc,
+      dst,
+      IPv4,
+      IPPacket(loc, dst, UDP, UDPPacket(loc, dst, {0xbb}), 1),
+      urgent_vlan));
+  std::vector<phy_data> second_bulk_d(UDPFrame(loc, dst, {0xcc}, 2));
+  std::vector<ap_uint<1> > priority_en(priority_d.size(), 1);
+  for (const std::vector<phy_data> &frame_d : {urgent_d, second_bulk_d}) {
+    priority_d.insert(priority_d.end(), ipg_d.begin(), ipg_d.end());
+    priority_en.insert(priority_en.end(), ipg_en.begin(), ipg_en.end());
+    priority_d.insert(priority_d.end(), frame_d.begin(), frame_d.end());
+    priority_en.insert(priority_en.end(), frame_d.size(), 1);
+  }
+  tests.push_back({"Priority frame ahead of queued frames",
+                   {{0, {0xaa, true, dst}},
+                    {1, {0xcc, true, dst}},
+                    {2, urgent_in}},
+                   priority_d,
+                   priority_en,
+                   loc});
+
+  // With a quantum of one byte each, the queues take turns frame by frame
+  tx_queue_quanta drr_quanta = 0;
+  for (int i = 0; i < NUM_TX_QUEUES; i++) {
+    drr_quanta(16 * i + 15, 16 * i) = 1;
+  }
+  byte_word second_urgent_in(0xbc, true, dst);
+  byte_word::set_vlan(second_urgent_in.user, urgent_vlan);
+  std::vector<phy_data> drr_d(UDPFrame(loc, dst, {0xaa}));
+  std::vector<phy_data> first_urgent_d(ETHFrame(
+      loc,
+      dst,
+      IPv4,
+      IPPacket(loc, dst, UDP, UDPPacket(loc, dst, {0xbb}), 1),
+      urgent_vlan));
+  std::vector<phy_data> second_drr_d(UDPFrame(loc, dst, {0xab}, 2));
+  std::vector<phy_data> second_urgent_d(ETHFrame(
+      loc,
+      dst,
+      IPv4,
+      IPPacket(loc, dst, UDP, UDPPacket(loc, dst, {0xbc}), 3),
+      urgent_vlan));
+  std::vector<ap_uint<1> > drr_en(drr_d.size(), 1);
+  for (const std::vector<phy_data> &frame_d :
+       {first_urgent_d, second_drr_d, second_urgent_d}) {
+    drr_d.insert(drr_d.end(), ipg_d.begin(), ipg_d.end());
+    drr_en.insert(drr_en.end(), ipg_en.begin(), ipg_en.end());
+    drr_d.insert(drr_d.end(), frame_d.begin(), frame_d.end());
+    drr_en.insert(drr_en.end(), frame_d.size(), 1);
+  }
+  tests.push_back({"Deficit round robin",
+                   {{0, {0xaa, true, dst}},
+                    {1, {0xab, true, dst}},
+                    {2, urgent_in},
+                    {3, second_urgent_in}},
+                   drr_d,
+                   drr_en,
+                   loc,
+                   {},
+                   {},
+                   false,
+                   0,
+                   drr_quanta});
+
+  // The frame behind the one waiting for the reply is sent meanwhile
+  const Addresses parked = {0x0a0b0c0d0e10, 0x98765434, 0x0035};
+  const Addresses parked_ip = {0, parked.ip_addr, parked.udp_port};
+  const ARPEvent parked_reply = {
+      ARP_REPLY, parked.mac_addr, parked.ip_addr, loc.ip_addr};
+  std::vector<phy_data> parked_d(ARPFrame(ARP_REQUEST, loc, parked));
+  std::vector<ap_uint<1> > parked_en(parked_d.size(), 1);
+  std::vector<phy_data> passing_d(UDPFrame(loc, dst, {0xbb}));
+  parked_d.insert(parked_d.end(), ipg_d.begin(), ipg_d.end());
+  parked_en.insert(parked_en.end(), ipg_en.begin(), ipg_en.end());
+  parked_d.insert(parked_d.end(), passing_d.begin(), passing_d.end());
+  parked_en.insert(parked_en.end(), passing_d.size(), 1);
+  parked_d.resize(800, 0);
+  parked_en.resize(800, 0);
+  std::vector<phy_data> waiting_d(UDPFrame(loc, parked, {0xaa}, 1));
+  parked_d.insert(parked_d.end(), waiting_d.begin(), waiting_d.end());
+  parked_en.insert(parked_en.end(), waiting_d.size(), 1);
+  tests.push_back({"Frame passing a frame waiting for ARP",
+                   {{0, {0xaa, true, parked_ip}}, {1, {0xbb, true, dst}}},
+                   parked_d,
+                   parked_en,
+                   loc,
+                   {{800, parked_reply}}});
+#endif
+
   for (int i = 0; i < tests.size(); i++) {
     for (int j = 0; j < NUM_CYCLES; j++) {
       tests[i].feed_inputs(j);
       eth_out(tests[i].data_in_feed.stream,
+#if ETH_OUT_CUT_THROUGH
+              tests[i].desc_in_feed.stream,
+#endif
+              tests[i].arp_in_feed.stream,
+              tests[i].icmp_in_feed.stream,
               tests[i].txd_store.value,
               tests[i].txen_store.value,
-              loc);
+              loc,
+              tests[i].ipg_bytes,
+              tests[i].segment_bytes,
+              i + 1,
+              tests[i].queue_quanta,
+              0,
+              0,
+              tests[i].queued_frames,
+              tests[i].dropped_frames,
+              0,
+              0,
+              tests[i].stats_value,
+              0,
+              tests[i].fifo_value);
       tests[i].store_outputs(j);
     }
     errors += tests[i].get_result();
   }
+
+  // The echo request of a ping takes its way through eth_in
+  std::vector<phy_data> ping(ICMPFrame(dst, loc, ICMP_ECHO_REQUEST, echo));
+  std::vector<phy_data> ping_reply_d(
+      ICMPFrame(loc, dst, ICMP_ECHO_REPLY, echo));
+  EthOutTest<NUM_CYCLES> ping_test(
+      "Ping through eth_in", {}, ping_reply_d, echo_en, loc);
+  errors += run_through_eth_in(ping_test, ping, 0);
+
+  // So does an ARP request in a VLAN, which is answered in the same VLAN
+  std::vector<phy_data> tagged_request(ARPFrame(ARP_REQUEST, dst, loc, vlan));
+  std::vector<phy_data> tagged_reply_d(ARPFrame(ARP_REPLY, loc, dst, vlan));
+  EthOutTest<NUM_CYCLES> tagged_arp_test(
+      "VLAN tagged ARP request through eth_in",
+      {},
+      tagged_reply_d,
+      std::vector<ap_uint<1> >(tagged_reply_d.size(), 1),
+      loc);
+  errors += run_through_eth_in(tagged_arp_test, tagged_request, vlan_table(5));
+
+  // Back to back frames of 64, 512, 1518 bytes and the largest frame size at
+  // the line rate of the PHY
+  const int NUM_FRAMES = 4;
+  std::vector<int> bench_frame_bytes = {64, 512, 1518};
+  if (MAX_FRAME_BYTES > 1518) {
+    bench_frame_bytes.push_back(MAX_FRAME_BYTES);
+  }
+  for (int frame_bytes : bench_frame_bytes) {
+    int payload_bytes = frame_bytes - 46;
+    hls::stream<axis_word> bench_data_in;
+    hls::stream<PayloadDescriptor> bench_desc_in;
+    hls::stream<ARPEvent> bench_arp_in;
+    hls::stream<axis_word> bench_icmp_in;
+    for (int i = 0; i < NUM_FRAMES; i++) {
+      std::vector<TimedValue<byte_word> > frame;
+      for (int j = 0; j < payload_bytes; j++) {
+        frame.push_back({j, {j, j == payload_bytes - 1, dst}});
+      }
+      for (const TimedValue<axis_word> &word : pack_words(frame)) {
+        bench_data_in.write(word.value);
+      }
+      for (const TimedValue<PayloadDescriptor> &desc : describe(frame, 0)) {
+        bench_desc_in.write(desc.value);
+      }
+    }
+    std::vector<int> starts;
+    int num_ends = 0;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    ap_uint<1> last_txen = 0;
+    for (int j = 0; num_ends < NUM_FRAMES && j < 200000; j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(bench_data_in,
+#if ETH_OUT_CUT_THROUGH
+              bench_desc_in,
+#endif
+              bench_arp_in,
+              bench_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              0,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (txen && !last_txen) {
+        starts.push_back(j);
+      } else if (!txen && last_txen) {
+        num_ends++;
+      }
+      last_txen = txen;
+    }
+    // Preamble, frame and gap are sent at the line rate of the PHY
+    int line_rate_cycles =
+        PHY_CYCLES_PER_BYTE * (8 + frame_bytes + IPG_BYTES);
+    int cycles = starts.size() == NUM_FRAMES
+                     ? (starts.back() - starts.front()) / (NUM_FRAMES - 1)
+                     : 0;
+    errors += report(
+        "Throughput of " + std::to_string(frame_bytes) + " byte frames",
+        cycles == line_rate_cycles,
+        std::to_string(cycles ? PHY_CLOCK_HZ / cycles : 0) + " of " +
+            std::to_string(PHY_CLOCK_HZ / line_rate_cycles) + " frames/s");
+  }
+
+  // Every frame sent is counted along with its bytes and size
+  {
+    std::vector<ap_uint<8> > stats_payload(200, 0x55);
+    std::vector<TimedValue<byte_word> > stats_in;
+    for (int i = 0; i < stats_payload.size(); i++) {
+      stats_in.push_back(
+          {i, {stats_payload[i], i == stats_payload.size() - 1, dst}});
+    }
+    stats_in.push_back({stats_payload.size(), {0xaa, true, dst}});
+    hls::stream<axis_word> stats_data_in;
+    hls::stream<PayloadDescriptor> stats_desc_in;
+    hls::stream<ARPEvent> stats_arp_in;
+    hls::stream<axis_word> stats_icmp_in;
+    for (const TimedValue<axis_word> &word : pack_words(stats_in)) {
+      stats_data_in.write(word.value);
+    }
+    for (const TimedValue<PayloadDescriptor> &desc : describe(stats_in, 0)) {
+      stats_desc_in.write(desc.value);
+    }
+    std::vector<ap_uint<64> > expected(NUM_TX_STATS, 0);
+    // The counts leave out the preamble
+    const std::vector<ap_uint<8> > long_frame =
+        UDPFrame(loc, dst, stats_payload);
+    const std::vector<ap_uint<8> > short_frame = UDPFrame(loc, dst, {0xaa});
+    const std::vector<int> frame_sizes = {(int)long_frame.size() - 8,
+                                          (int)short_frame.size() - 8};
+    const std::vector<int> bucket_limits = {64, 127, 255, 511, 1023, 1518};
+    for (int frame_bytes : frame_sizes) {
+      expected[TX_FRAMES]++;
+      expected[TX_BYTES] += frame_bytes;
+      int bucket = std::upper_bound(bucket_limits.begin(),
+                                    bucket_limits.end(),
+                                    frame_bytes - 1) -
+                   bucket_limits.begin();
+      expected[TX_FRAMES_64 + bucket]++;
+    }
+
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    // The first cycle clears the counts of the tests before
+    for (int j = 0; j < 3000; j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(stats_data_in,
+#if ETH_OUT_CUT_THROUGH
+              stats_desc_in,
+#endif
+              stats_arp_in,
+              stats_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              1,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+    }
+    std::string mismatch = counter_mismatch(read_stats(loc, 2), expected);
+    errors += report("Statistics of sent frames", mismatch.empty(), mismatch);
+  }
+
+  // The payload of a frame piles up in its transmit queue until the frame is
+  // taken, which frees its words as they are read. A cut-through eth_out reads
+  // words while the frame is still written.
+  {
+    std::vector<ap_uint<8> > fifo_payload(200, 0x55);
+    std::vector<TimedValue<byte_word> > fifo_in;
+    for (int i = 0; i < fifo_payload.size(); i++) {
+      fifo_in.push_back(
+          {i, {fifo_payload[i], i == fifo_payload.size() - 1, dst}});
+    }
+    hls::stream<axis_word> fifo_data_in;
+    hls::stream<PayloadDescriptor> fifo_desc_in;
+    hls::stream<ARPEvent> fifo_arp_in;
+    hls::stream<axis_word> fifo_icmp_in;
+    for (const TimedValue<axis_word> &word : pack_words(fifo_in)) {
+      fifo_data_in.write(word.value);
+    }
+    for (const TimedValue<PayloadDescriptor> &desc : describe(fifo_in, 0)) {
+      fifo_desc_in.write(desc.value);
+    }
+
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    for (int j = 0; j < 3000; j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(fifo_data_in,
+#if ETH_OUT_CUT_THROUGH
+              fifo_desc_in,
+#endif
+              fifo_arp_in,
+              fifo_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              3,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+    }
+    std::vector<std::vector<ap_uint<64> > > values(
+        NUM_TX_FIFOS, std::vector<ap_uint<64> >(NUM_FIFO_STATS));
+    for (int i = 0; i < NUM_TX_FIFOS; i++) {
+      for (int j = 0; j < NUM_FIFO_STATS; j++) {
+        phy_data txd;
+        ap_uint<1> txen;
+        eth_out(fifo_data_in,
+#if ETH_OUT_CUT_THROUGH
+                fifo_desc_in,
+#endif
+                fifo_arp_in,
+                fifo_icmp_in,
+                txd,
+                txen,
+                loc,
+                IPG_BYTES,
+                0,
+                0,
+                0,
+                0,
+                0,
+                queued_frames,
+                dropped_frames,
+                4,
+                0,
+                stats_value,
+                fifo_stat_select(i, fifo_stat(j)),
+                values[i][j]);
+      }
+    }
+    std::vector<std::string> names;
+    for (const std::string &kind : {"queue_in", "buffers", "meta_buffers"}) {
+      for (int i = 0; i < NUM_TX_QUEUES; i++) {
+        names.push_back(kind + "[" + std::to_string(i) + "]");
+      }
+    }
+    names.push_back("echo_buffer");
+    names.push_back("echo_meta_buffer");
+    ap_uint<1> idle = true;
+    for (int i = 0; i < NUM_TX_FIFOS; i++) {
+      std::cout << "  " << names[i] << ": level " << values[i][FIFO_LEVEL]
+                << ", peak " << values[i][FIFO_PEAK] << ", full "
+                << values[i][FIFO_FULL_CYCLES] << " cycles, empty "
+                << values[i][FIFO_EMPTY_CYCLES] << " cycles" << std::endl;
+      if (values[i][FIFO_LEVEL] != 0 || values[i][FIFO_FULL_CYCLES] != 0) {
+        idle = false;
+      }
+    }
+    int payload_words =
+        (fifo_payload.size() + DATAPATH_BYTES - 1) / DATAPATH_BYTES;
+    ap_uint<64> peak = values[TX_BUFFER_FIFO][FIFO_PEAK];
+#if ETH_OUT_CUT_THROUGH
+    ap_uint<1> peak_ok = peak > 0 && peak < payload_words;
+#else
+    ap_uint<1> peak_ok = peak == payload_words;
+#endif
+    errors += report("Occupancy of the transmit FIFOs", idle && peak_ok);
+  }
+
+#if ETH_OUT_CUT_THROUGH
+  // A frame that does not match its descriptor or whose words fall behind is
+  // sent with a wrong FCS. The frame after it is sent as usual.
+  {
+    struct BrokenFrame {
+      std::string name;
+      int payload_bytes;
+      int descriptor_bytes;
+      int stall_cycles;
+    };
+    const std::vector<BrokenFrame> broken_frames = {
+        {"Frame longer than its descriptor", 40, 32, 0},
+        {"Frame shorter than its descriptor", 20, 32, 0},
+        {"Frame stalled halfway", 64, 64, 1000}};
+    const int NEXT_FRAME_INDEX = 2000;
+    for (int i = 0; i < broken_frames.size(); i++) {
+      const BrokenFrame &broken = broken_frames[i];
+      std::vector<TimedValue<byte_word> > broken_in;
+      for (int j = 0; j < broken.payload_bytes; j++) {
+        int index = j < broken.payload_bytes / 2 ? j : j + broken.stall_cycles;
+        broken_in.push_back({index, {j, j == broken.payload_bytes - 1, dst}});
+      }
+      std::vector<TimedValue<byte_word> > next_in = {
+          {NEXT_FRAME_INDEX, {0xaa, true, dst}}};
+      std::vector<TimedValue<PayloadDescriptor> > desc_in_tv = {
+          {0, {broken.descriptor_bytes, 0, false}}};
+      desc_in_tv.push_back(describe(next_in, false)[0]);
+      std::vector<TimedValue<axis_word> > data_in_tv = pack_words(broken_in);
+      for (const TimedValue<axis_word> &word : pack_words(next_in)) {
+        data_in_tv.push_back(word);
+      }
+      InputStreamFeed<axis_word> data_in_feed(data_in_tv);
+      InputStreamFeed<PayloadDescriptor> desc_in_feed(desc_in_tv);
+      hls::stream<ARPEvent> broken_arp_in;
+      hls::stream<axis_word> broken_icmp_in;
+      std::vector<std::vector<phy_data> > frames;
+      tx_queue_counters queued_frames;
+      tx_queue_counters dropped_frames;
+      ap_uint<64> stats_value;
+      ap_uint<64> fifo_value;
+      ap_uint<1> last_txen = 0;
+      for (int j = 0; j < 2 * NEXT_FRAME_INDEX; j++) {
+        data_in_feed.feed(j);
+        desc_in_feed.feed(j);
+        phy_data txd;
+        ap_uint<1> txen;
+        eth_out(data_in_feed.stream,
+                desc_in_feed.stream,
+                broken_arp_in,
+                broken_icmp_in,
+                txd,
+                txen,
+                loc,
+                IPG_BYTES,
+                0,
+                i + 1,
+                0,
+                0,
+                0,
+                queued_frames,
+                dropped_frames,
+                0,
+                0,
+                stats_value,
+                0,
+                fifo_value);
+        if (txen && !last_txen) {
+          frames.push_back({});
+        }
+        if (txen) {
+          frames.back().push_back(txd);
+        }
+        last_txen = txen;
+      }
+      std::vector<phy_data> next_d(UDPFrame(loc, dst, {0xaa}, 1));
+      errors += report(broken.name,
+                       frames.size() == 2 && !has_valid_fcs(frames[0]) &&
+                           frames[1] == next_d);
+    }
+  }
+#endif
+
+#if !ETH_OUT_CUT_THROUGH
+  // An urgent message written right behind two bulk frames of the largest
+  // standard payload is sent right after the first one, one gap after its end
+  {
+    const int BULK_PAYLOAD_BYTES = 1472;
+    hls::stream<axis_word> latency_data_in;
+    hls::stream<PayloadDescriptor> latency_desc_in;
+    hls::stream<ARPEvent> latency_arp_in;
+    hls::stream<axis_word> latency_icmp_in;
+    std::vector<TimedValue<byte_word> > latency_in;
+    for (int i = 0; i < 2 * BULK_PAYLOAD_BYTES; i++) {
+      latency_in.push_back(
+          {i, {i, i % BULK_PAYLOAD_BYTES == BULK_PAYLOAD_BYTES - 1, dst}});
+    }
+    latency_in.push_back({2 * BULK_PAYLOAD_BYTES, urgent_in});
+    for (const TimedValue<axis_word> &word : pack_words(latency_in)) {
+      latency_data_in.write(word.value);
+    }
+    std::vector<int> starts;
+    std::vector<int> ends;
+    ap_uint<1> last_txen = 0;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    ap_uint<32> queued_bulk = 0;
+    ap_uint<32> queued_urgent = 0;
+    const ap_uint<TX_QUEUE_ID_WIDTH> urgent_queue = queue_of(urgent_vlan);
+    for (int j = 0; ends.size() < 3 && j < 100000; j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(latency_data_in,
+#if ETH_OUT_CUT_THROUGH
+              latency_desc_in,
+#endif
+              latency_arp_in,
+              latency_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              0,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (txen && !last_txen) {
+        starts.push_back(j);
+      } else if (!txen && last_txen) {
+        ends.push_back(j);
+        if (ends.size() == 1) {
+          queued_bulk = queued_frames(31, 0);
+          queued_urgent = queued_frames(32 * urgent_queue + 31,
+                                        32 * urgent_queue);
+        }
+      }
+      last_txen = txen;
+    }
+    // The urgent frame is the short one
+    int cycles = ends.size() == 3 ? starts[1] - ends[0] : 0;
+    errors += report("Latency of an urgent frame behind " +
+                         std::to_string(BULK_PAYLOAD_BYTES) +
+                         " byte bulk frames",
+                     ends.size() == 3 &&
+                         ends[1] - starts[1] < ends[2] - starts[2] &&
+                         cycles == PHY_CYCLES_PER_BYTE * IPG_BYTES &&
+                         queued_bulk == 1 && queued_urgent == 1,
+                     std::to_string(cycles) + " cycles after the bulk frame");
+  }
+
+  // A message of 64 KB takes the most segments of the largest payload,
+  // larger segments are capped to it. Segments are rounded down to whole
+  // words, but hold one word at least.
+  {
+    const int LARGEST_SEGMENT_BYTES =
+        MAX_UDP_PAYLOAD_BYTES / DATAPATH_BYTES * DATAPATH_BYTES;
+    std::vector<ap_uint<8> > large_message;
+    for (int i = 0; i < 65536; i++) {
+      large_message.push_back(i);
+    }
+    errors += check_segments("Segmented message of 64 KB",
+                             large_message,
+                             LARGEST_SEGMENT_BYTES,
+                             LARGEST_SEGMENT_BYTES,
+                             loc,
+                             dst,
+                             1);
+    std::vector<ap_uint<8> > capped_message(
+        large_message.begin(),
+        large_message.begin() + 2 * MAX_UDP_PAYLOAD_BYTES + 100);
+    errors += check_segments("Segments capped at the largest UDP payload",
+                             capped_message,
+                             0xffff,
+                             LARGEST_SEGMENT_BYTES,
+                             loc,
+                             dst,
+                             2);
+    std::vector<ap_uint<8> > short_message(
+        large_message.begin(), large_message.begin() + 5 * DATAPATH_BYTES + 3);
+    errors += check_segments("Segments rounded down to whole words",
+                             short_message,
+                             2 * DATAPATH_BYTES + 1,
+                             (2 * DATAPATH_BYTES + 1) / DATAPATH_BYTES *
+                                 DATAPATH_BYTES,
+                             loc,
+                             dst,
+                             3);
+    errors += check_segments("Segments of one word at least",
+                             short_message,
+                             1,
+                             DATAPATH_BYTES,
+                             loc,
+                             dst,
+                             4);
+  }
+
+  // Urgent frames to one destination are paced to a frame per refill of its
+  // bucket, while a bulk frame to another destination goes in between
+  {
+    const int PACED_PAYLOAD_BYTES = 100;
+    const ap_uint<16> PACING_RATE = 4;
+    const int NUM_PACED_FRAMES = 4;
+    const Addresses other_dst = {dst.mac_addr, dst.ip_addr, 0x0036};
+    hls::stream<axis_word> pacing_data_in;
+    hls::stream<PayloadDescriptor> pacing_desc_in;
+    hls::stream<ARPEvent> pacing_arp_in;
+    hls::stream<axis_word> pacing_icmp_in;
+    std::vector<TimedValue<byte_word> > pacing_in;
+    for (int i = 0; i < NUM_PACED_FRAMES * PACED_PAYLOAD_BYTES; i++) {
+      byte_word paced_in(
+          i, i % PACED_PAYLOAD_BYTES == PACED_PAYLOAD_BYTES - 1, dst);
+      byte_word::set_vlan(paced_in.user, urgent_vlan);
+      pacing_in.push_back({i, paced_in});
+    }
+    pacing_in.push_back({NUM_PACED_FRAMES * PACED_PAYLOAD_BYTES,
+                         {0xaa, true, other_dst}});
+    for (const TimedValue<axis_word> &word : pack_words(pacing_in)) {
+      pacing_data_in.write(word.value);
+    }
+    std::vector<int> starts;
+    std::vector<int> lengths;
+    ap_uint<1> last_txen = 0;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    for (int j = 0; lengths.size() < NUM_PACED_FRAMES + 1 && j < 100000;
+         j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(pacing_data_in,
+#if ETH_OUT_CUT_THROUGH
+              pacing_desc_in,
+#endif
+              pacing_arp_in,
+              pacing_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              PACING_RATE,
+              PACED_PAYLOAD_BYTES,
+              queued_frames,
+              dropped_frames,
+              0,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (txen && !last_txen) {
+        starts.push_back(j);
+      } else if (!txen && last_txen) {
+        lengths.push_back(j - starts.back());
+      }
+      last_txen = txen;
+    }
+    // The bulk frame is the short one
+    int period_cycles = PACED_PAYLOAD_BYTES / PACING_RATE * TX_PACER_PERIOD;
+    int cycles = lengths.size() == NUM_PACED_FRAMES + 1
+                     ? (starts.back() - starts[2]) / (NUM_PACED_FRAMES - 2)
+                     : 0;
+    errors += report("Pacing of " + std::to_string(PACED_PAYLOAD_BYTES) +
+                         " byte payloads at " +
+                         std::to_string(PACING_RATE.to_int()) + " bytes per " +
+                         std::to_string(TX_PACER_PERIOD) + " cycles",
+                     cycles == period_cycles && lengths[1] < lengths[0] &&
+                         starts[2] - starts[0] >=
+                             period_cycles - TX_PACER_PERIOD,
+                     std::to_string(cycles) + " of " +
+                         std::to_string(period_cycles) + " cycles apart");
+  }
+
+  // Two destinations in the same queue are paced each on their own. The frame
+  // to the second one is sent while the one behind the first waits, and the
+  // frames to each follow a refill of their bucket apart. The destinations
+  // differ only above the lowest four bits of their IP address and UDP port.
+  {
+    const int PACED_PAYLOAD_BYTES = 100;
+    const ap_uint<16> PACING_RATE = 4;
+    const int NUM_PACED_FRAMES = 6;
+    const Addresses first_dst = {dst.mac_addr, dst.ip_addr, 0x0055};
+    const Addresses second_dst = {dst.mac_addr, dst.ip_addr, 0x0065};
+    hls::stream<axis_word> flows_data_in;
+    hls::stream<PayloadDescriptor> flows_desc_in;
+    hls::stream<ARPEvent> flows_arp_in;
+    hls::stream<axis_word> flows_icmp_in;
+    // Alternating between the destinations
+    std::vector<TimedValue<byte_word> > flows_in;
+    for (int i = 0; i < NUM_PACED_FRAMES * PACED_PAYLOAD_BYTES; i++) {
+      int frame = i / PACED_PAYLOAD_BYTES;
+      flows_in.push_back({i,
+                          {i,
+                           i % PACED_PAYLOAD_BYTES == PACED_PAYLOAD_BYTES - 1,
+                           frame % 2 == 0 ? first_dst : second_dst}});
+    }
+    for (const TimedValue<axis_word> &word : pack_words(flows_in)) {
+      flows_data_in.write(word.value);
+    }
+    std::vector<int> starts;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    ap_uint<1> last_txen = 0;
+    // The last frame is sent to its end so that it does not reach into the
+    // test after
+    for (int j = 0;
+         (starts.size() < NUM_PACED_FRAMES || last_txen) && j < 100000;
+         j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(flows_data_in,
+#if ETH_OUT_CUT_THROUGH
+              flows_desc_in,
+#endif
+              flows_arp_in,
+              flows_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              PACING_RATE,
+              PACED_PAYLOAD_BYTES,
+              queued_frames,
+              dropped_frames,
+              0,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (txen && !last_txen) {
+        starts.push_back(j);
+      }
+      last_txen = txen;
+    }
+    int period_cycles = PACED_PAYLOAD_BYTES / PACING_RATE * TX_PACER_PERIOD;
+    ap_uint<1> paced = starts.size() == NUM_PACED_FRAMES &&
+                       starts[1] - starts[0] < period_cycles;
+    for (int i = 4; i < starts.size(); i++) {
+      paced &= starts[i] - starts[i - 2] == period_cycles;
+    }
+    std::string note = "frames starting at";
+    for (int start : starts) {
+      note += " " + std::to_string(start);
+    }
+    errors += report("Pacing of two destinations in one queue", paced, note);
+  }
+
+  // Quanta of 400 and 100 bytes share the line 4 to 1 in payload bytes while
+  // both queues hold frames, although their frames differ in size
+  {
+    const int BULK_QUANTUM = 400;
+    const int URGENT_QUANTUM = 100;
+    const int BULK_PAYLOAD_BYTES = 200;
+    const int URGENT_PAYLOAD_BYTES = 50;
+    const int NUM_ROUNDS = 8;
+    const ap_uint<TX_QUEUE_ID_WIDTH> urgent_queue = queue_of(urgent_vlan);
+    tx_queue_quanta ratio_quanta = 0;
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+      ratio_quanta(16 * i + 15, 16 * i) =
+          i == urgent_queue ? URGENT_QUANTUM : BULK_QUANTUM;
+    }
+    hls::stream<axis_word> ratio_data_in;
+    hls::stream<PayloadDescriptor> ratio_desc_in;
+    hls::stream<ARPEvent> ratio_arp_in;
+    hls::stream<axis_word> ratio_icmp_in;
+    // Both queues are written at the rate they are sent from
+    std::vector<TimedValue<byte_word> > ratio_in;
+    for (int i = 0; i < NUM_ROUNDS; i++) {
+      for (int j = 0; j < 2 * BULK_PAYLOAD_BYTES; j++) {
+        ratio_in.push_back(
+            {ratio_in.size(),
+             {j, j % BULK_PAYLOAD_BYTES == BULK_PAYLOAD_BYTES - 1, dst}});
+      }
+      for (int j = 0; j < 2 * URGENT_PAYLOAD_BYTES; j++) {
+        byte_word ratio_urgent_in(
+            j, j % URGENT_PAYLOAD_BYTES == URGENT_PAYLOAD_BYTES - 1, dst);
+        byte_word::set_vlan(ratio_urgent_in.user, urgent_vlan);
+        ratio_in.push_back({ratio_in.size(), ratio_urgent_in});
+      }
+    }
+    for (const TimedValue<axis_word> &word : pack_words(ratio_in)) {
+      ratio_data_in.write(word.value);
+    }
+    std::vector<int> starts;
+    std::vector<int> lengths;
+    ap_uint<1> last_txen = 0;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    for (int j = 0; lengths.size() < 4 * NUM_ROUNDS && j < 200000; j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(ratio_data_in,
+#if ETH_OUT_CUT_THROUGH
+              ratio_desc_in,
+#endif
+              ratio_arp_in,
+              ratio_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              ratio_quanta,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              0,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (txen && !last_txen) {
+        starts.push_back(j);
+      } else if (!txen && last_txen) {
+        lengths.push_back(j - starts.back());
+      }
+      last_txen = txen;
+    }
+    // Up to the last urgent frame sent within the first half of the frames,
+    // both queues hold frames. The bulk frames are the long ones.
+    int bulk_bytes = 0;
+    int urgent_bytes = 0;
+    int window_bulk_bytes = 0;
+    int window_urgent_bytes = 0;
+    for (int i = 0; i < lengths.size() && i < 2 * NUM_ROUNDS; i++) {
+      if (lengths[i] > PHY_CYCLES_PER_BYTE * BULK_PAYLOAD_BYTES) {
+        bulk_bytes += BULK_PAYLOAD_BYTES;
+      } else {
+        urgent_bytes += URGENT_PAYLOAD_BYTES;
+        window_bulk_bytes = bulk_bytes;
+        window_urgent_bytes = urgent_bytes;
+      }
+    }
+    // Each queue may be a quantum and a frame ahead of its share
+    int ratio_error = window_bulk_bytes -
+                      BULK_QUANTUM / URGENT_QUANTUM * window_urgent_bytes;
+    errors += report("Deficit round robin with quanta of " +
+                         std::to_string(BULK_QUANTUM) + " and " +
+                         std::to_string(URGENT_QUANTUM) + " bytes",
+                     lengths.size() == 4 * NUM_ROUNDS &&
+                         window_urgent_bytes != 0 &&
+                         std::abs(ratio_error) <=
+                             BULK_QUANTUM + BULK_PAYLOAD_BYTES,
+                     std::to_string(window_bulk_bytes) + " to " +
+                         std::to_string(window_urgent_bytes) + " bytes");
+  }
+#endif
+
+#if ARP_RETRY_CYCLES * (ARP_MAX_REQUESTS + 1) <= 100000
+  // The frames to an address that no reply comes from are dropped once the
+  // requests for it are used up, and counted in dropped_frames of their queue.
+  // They are counted as TX_UNRESOLVED as well. The frame to another
+  // destination is sent. Only variants with few retry cycles get there in time
+  // (see build.tcl).
+  {
+    const Addresses lost = {0, 0x98765436, 0x0035};
+    hls::stream<axis_word> lost_data_in;
+    hls::stream<PayloadDescriptor> lost_desc_in;
+    hls::stream<ARPEvent> lost_arp_in;
+    hls::stream<axis_word> lost_icmp_in;
+    // Priority 7 in VLAN 5
+    const VLANTag lost_vlan = {1, 0xE005};
+    byte_word lost_urgent_in(0xbb, true, lost);
+    byte_word::set_vlan(lost_urgent_in.user, lost_vlan);
+    const std::vector<TimedValue<byte_word> > lost_in = {
+        {0, {0xaa, true, lost}},
+        {1, {0xab, true, lost}},
+        {2, lost_urgent_in},
+        {3, {0xac, true, dst}}};
+    for (const TimedValue<axis_word> &word : pack_words(lost_in)) {
+      lost_data_in.write(word.value);
+    }
+    for (const TimedValue<PayloadDescriptor> &desc : describe(lost_in, 0)) {
+      lost_desc_in.write(desc.value);
+    }
+    // A cut-through eth_out takes all frames into the first queue
+    const int urgent_queue =
+        ETH_OUT_CUT_THROUGH ? 0 : queue_of(lost_vlan).to_int();
+    std::vector<ap_uint<32> > expected(NUM_TX_QUEUES, 0);
+    expected[0] += 2;
+    expected[urgent_queue] += 1;
+    int frames = 0;
+    ap_uint<1> last_txen = 0;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    for (int j = 0; j < ARP_RETRY_CYCLES * (ARP_MAX_REQUESTS + 1) + 2000;
+         j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(lost_data_in,
+#if ETH_OUT_CUT_THROUGH
+              lost_desc_in,
+#endif
+              lost_arp_in,
+              lost_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              5,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (txen && !last_txen) {
+        frames++;
+      }
+      last_txen = txen;
+    }
+    ap_uint<1> counts_ok = queued_frames == 0;
+    for (int i = 0; i < NUM_TX_QUEUES; i++) {
+      counts_ok &= dropped_frames(32 * i + 31, 32 * i) == expected[i];
+    }
+    // The change of stats_snapshot to 5 cleared the counts of the tests before
+    ap_uint<64> unresolved = read_stats(loc, 6)[TX_UNRESOLVED];
+    errors += report("Frames dropped for a missing ARP reply",
+                     counts_ok && frames == ARP_MAX_REQUESTS + 1 &&
+                         unresolved == 3,
+                     dropped_frames.to_string(16) + " dropped, " +
+                         std::to_string(frames) + " frames sent, " +
+                         unresolved.to_string(10) + " unresolved");
+  }
+
+  // A dropped frame of the largest payload frees all of its words, which with
+  // TX_BUFFER_FRAMES of 1 are all words of its queue, so the frame behind it
+  // is sent
+  {
+    const Addresses lost = {0, 0x98765437, 0x0035};
+    const int LARGEST_PAYLOAD_BYTES =
+        MAX_UDP_PAYLOAD_BYTES / DATAPATH_BYTES * DATAPATH_BYTES;
+    hls::stream<axis_word> full_data_in;
+    hls::stream<PayloadDescriptor> full_desc_in;
+    hls::stream<ARPEvent> full_arp_in;
+    hls::stream<axis_word> full_icmp_in;
+    std::vector<TimedValue<byte_word> > full_in;
+    for (int i = 0; i < LARGEST_PAYLOAD_BYTES; i++) {
+      full_in.push_back({i, {i, i == LARGEST_PAYLOAD_BYTES - 1, lost}});
+    }
+    full_in.push_back({LARGEST_PAYLOAD_BYTES, {0xac, true, dst}});
+    for (const TimedValue<axis_word> &word : pack_words(full_in)) {
+      full_data_in.write(word.value);
+    }
+    for (const TimedValue<PayloadDescriptor> &desc : describe(full_in, 0)) {
+      full_desc_in.write(desc.value);
+    }
+    int frames = 0;
+    ap_uint<1> last_txen = 0;
+    ap_uint<32> dropped_before = 0;
+    tx_queue_counters queued_frames;
+    tx_queue_counters dropped_frames;
+    ap_uint<64> stats_value;
+    ap_uint<64> fifo_value;
+    for (int j = 0; j < ARP_RETRY_CYCLES * (ARP_MAX_REQUESTS + 1) +
+                            LARGEST_PAYLOAD_BYTES / DATAPATH_BYTES + 2000;
+         j++) {
+      phy_data txd;
+      ap_uint<1> txen;
+      eth_out(full_data_in,
+#if ETH_OUT_CUT_THROUGH
+              full_desc_in,
+#endif
+              full_arp_in,
+              full_icmp_in,
+              txd,
+              txen,
+              loc,
+              IPG_BYTES,
+              0,
+              0,
+              0,
+              0,
+              0,
+              queued_frames,
+              dropped_frames,
+              6,
+              0,
+              stats_value,
+              0,
+              fifo_value);
+      if (j == 0) {
+        dropped_before = dropped_frames(31, 0);
+      }
+      if (txen && !last_txen) {
+        frames++;
+      }
+      last_txen = txen;
+    }
+    ap_uint<32> dropped = dropped_frames(31, 0) - dropped_before;
+    errors += report("Dropped frame of the largest payload",
+                     queued_frames == 0 && dropped == 1 &&
+                         frames == ARP_MAX_REQUESTS + 1,
+                     dropped.to_string(10) + " dropped, " +
+                         std::to_string(frames) + " frames sent");
+  }
+#endif
   return errors;
 }
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_STATS_HPP
+#define TX_STATS_HPP
+#pragma once
+
+#include "../utils/FIFOMonitor.hpp"
+#include "../utils/StatCounters.hpp"
+#include "Meta.hpp"
+
+// Counters of eth_out, as selected by stats_select. Every frame sent counts in
+// TX_FRAMES, TX_BYTES and one size bucket, counted from TX_FRAMES_64 on.
+// TX_UNRESOLVED counts the frames dropped as no MAC address was found for
+// their destination.
+enum tx_stat {
+  TX_FRAMES,
+  TX_BYTES,
+  TX_UNRESOLVED,
+  TX_FRAMES_64,
+  NUM_TX_STATS = TX_FRAMES_64 + NUM_SIZE_BUCKETS
+};
+
+// FIFOs of eth_out, as selected by fifo_select (see fifo_stat_select). There
+// is one FIFO of each of the first three kinds per transmit queue, the one of
+// queue i at the index of its kind plus i. The FIFOs ahead of the data input
+// analyzers are not used with ETH_OUT_CUT_THROUGH.
+enum tx_fifo {
+  TX_QUEUE_IN_FIFO,
+  TX_BUFFER_FIFO = TX_QUEUE_IN_FIFO + NUM_TX_QUEUES,
+  TX_META_FIFO = TX_BUFFER_FIFO + NUM_TX_QUEUES,
+  TX_ECHO_BUFFER_FIFO = TX_META_FIFO + NUM_TX_QUEUES,
+  TX_ECHO_META_FIFO,
+  NUM_TX_FIFOS
+};
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PayloadWriter.hpp"
+
+void PayloadWriter::write(hls::stream<axis_word> &data_in,
+                          ap_uint<64> *mem,
+                          const ap_uint<32> &base) {
+#pragma HLS INLINE
+
+  // Frames start at a word boundary and only their last word may have bytes
+  // missing, so every stream word fills up at most one memory word.
+  ap_uint<64> mem_word = 0;
+  ap_uint<bit_width<RX_DMA_WORD_BYTES>::value> mem_byte_cnt = 0;
+  ap_uint<32> addr = base;
+  ap_uint<16> byte_cnt = 0;
+  ap_uint<1> cut_off = false;
+  axis_word word;
+  do {
+#pragma HLS PIPELINE
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = 1472
+    word = data_in.read();
+    for (int i = 0; i < DATAPATH_BYTES; i++) {
+#pragma HLS UNROLL
+      if (word.keep[i]) {
+        if (byte_cnt < RX_DMA_BUFFER_BYTES) {
+          mem_word(8 * mem_byte_cnt + 7, 8 * mem_byte_cnt) = word.get_byte(i);
+          mem_byte_cnt++;
+          byte_cnt++;
+        } else {
+          cut_off = true;
+        }
+      }
+    }
+    if (mem_byte_cnt == RX_DMA_WORD_BYTES || (word.last && mem_byte_cnt != 0)) {
+      mem[addr] = mem_word;
+      addr++;
+      mem_word = 0;
+      mem_byte_cnt = 0;
+    }
+  } while (!word.last);
+  this->length = byte_cnt;
+  this->cut_off = cut_off;
+  this->user = word.user;
+}
+
+void PayloadWriter::skip(hls::stream<axis_word> &data_in) {
+#pragma HLS INLINE
+
+  axis_word word;
+  do {
+#pragma HLS PIPELINE
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = 1472
+    word = data_in.read();
+  } while (!word.last);
+}
+
+ap_uint<16> PayloadWriter::get_length() const { return this->length; }
+
+ap_uint<1> PayloadWriter::truncated() const { return this->cut_off; }
+
+ap_uint<AXIS_USER_WIDTH> PayloadWriter::get_user() const { return this->user; }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PAYLOAD_WRITER_HPP
+#define PAYLOAD_WRITER_HPP
+#pragma once
+
+#include "../utils/axis_word.hpp"
+#include "../utils/bit_width.hpp"
+#include "RXCompletion.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Writes the payload of the next frame of data_in into memory in bursts,
+// starting at word base. Bytes beyond RX_DMA_BUFFER_BYTES are dropped. The
+// user field of the frame is taken from its last word.
+class PayloadWriter {
+public:
+  void write(hls::stream<axis_word> &data_in,
+             ap_uint<64> *mem,
+             const ap_uint<32> &base);
+  void skip(hls::stream<axis_word> &data_in);
+  ap_uint<16> get_length() const;
+  ap_uint<1> truncated() const;
+  ap_uint<AXIS_USER_WIDTH> get_user() const;
+
+private:
+  ap_uint<16> length;
+  ap_uint<1> cut_off;
+  ap_uint<AXIS_USER_WIDTH> user;
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RX_COMPLETION_HPP
+#define RX_COMPLETION_HPP
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/frame_size.hpp"
+#include <ap_int.h>
+
+// Bytes of a word of the memory rx_dma writes to
+const int RX_DMA_WORD_BYTES = 8;
+
+// Size of each buffer of the ring. Longer payload is cut off.
+#ifndef RX_DMA_BUFFER_BYTES
+#if MAX_FRAME_BYTES > 2048
+#define RX_DMA_BUFFER_BYTES 16384
+#else
+#define RX_DMA_BUFFER_BYTES 2048
+#endif
+#endif
+
+// Words of a completion entry in memory. Word 0 holds the source MAC address
+// at bits 47 to 0 and the UDP port at bits 63 to 48. Word 1 holds the source
+// IP address at bits 31 to 0, the payload length at bits 47 to 32 and the
+// status at bits 63 to 48. Word 2 holds the timestamp.
+const int RX_COMPLETION_WORDS = 3;
+
+// Bits of the status. Valid is set for every entry written, the queue ID is
+// the one eth_in tagged the payload with.
+const int RX_STATUS_VALID_BIT = 0;
+const int RX_STATUS_ERROR_BIT = 1;
+const int RX_STATUS_TRUNCATED_BIT = 2;
+const int RX_STATUS_QUEUE_LOW = 8;
+
+struct RXCompletion {
+  Addresses src;
+  ap_uint<16> length;
+  ap_uint<16> status;
+  ap_uint<64> timestamp;
+  void write(ap_uint<64> *mem, const ap_uint<32> &base) const;
+};
+
+#endif
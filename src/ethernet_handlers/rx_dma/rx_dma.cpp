@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "rx_dma.hpp"
+
+void rx_dma(hls::stream<axis_word> &data_in,
+            ap_uint<64> *mem,
+            const ap_uint<32> &buffer_addr,
+            const ap_uint<32> &completion_addr,
+            const ap_uint<16> &ring_size,
+            const ap_uint<16> &head,
+            ap_uint<16> &tail,
+            const ap_uint<16> &coalesce_count,
+            const ap_uint<32> &coalesce_time,
+            const ap_uint<64> &timestamp,
+            ap_uint<32> &dropped_frames,
+            hls::stream<ap_uint<16> > &completion_out) {
+#pragma HLS INTERFACE axis port = data_in
+#pragma HLS INTERFACE m_axi port = mem offset = slave depth = 1024
+#pragma HLS INTERFACE s_axilite port = buffer_addr
+#pragma HLS INTERFACE s_axilite port = completion_addr
+#pragma HLS INTERFACE s_axilite port = ring_size
+#pragma HLS INTERFACE s_axilite port = head
+#pragma HLS INTERFACE s_axilite port = tail
+#pragma HLS INTERFACE s_axilite port = coalesce_count
+#pragma HLS INTERFACE s_axilite port = coalesce_time
+#pragma HLS INTERFACE s_axilite port = dropped_frames
+#pragma HLS INTERFACE s_axilite port = return
+#pragma HLS INTERFACE axis port = completion_out
+
+  static ap_uint<16> next_index = 0;
+  static ap_uint<32> dropped_frame_cnt = 0;
+  static PayloadWriter payloadWriter;
+  static CompletionCoalescer completionCoalescer;
+
+  if (!data_in.empty()) {
+    ap_uint<16> following_index = next_index + 1;
+    if (following_index == ring_size) {
+      following_index = 0;
+    }
+    if (following_index == head) {
+      payloadWriter.skip(data_in);
+      dropped_frame_cnt++;
+    } else {
+      payloadWriter.write(
+          data_in,
+          mem,
+          buffer_addr / RX_DMA_WORD_BYTES +
+              next_index * (RX_DMA_BUFFER_BYTES / RX_DMA_WORD_BYTES));
+      ap_uint<AXIS_USER_WIDTH> user = payloadWriter.get_user();
+      RXCompletion completion;
+      completion.src = {user(47, 0), user(79, 48), user(95, 80)};
+      completion.length = payloadWriter.get_length();
+      completion.status = 0;
+      completion.status[RX_STATUS_VALID_BIT] = 1;
+      completion.status[RX_STATUS_ERROR_BIT] = user[USER_ERROR_BIT];
+      completion.status[RX_STATUS_TRUNCATED_BIT] = payloadWriter.truncated();
+      completion.status(RX_STATUS_QUEUE_LOW + QUEUE_ID_WIDTH - 1,
+                        RX_STATUS_QUEUE_LOW) =
+          user(USER_QUEUE_HIGH, USER_QUEUE_LOW);
+      completion.timestamp = timestamp;
+      completion.write(mem,
+                       completion_addr / RX_DMA_WORD_BYTES +
+                           next_index * RX_COMPLETION_WORDS);
+      next_index = following_index;
+      completionCoalescer.complete(
+          next_index, coalesce_count, timestamp, completion_out);
+    }
+  }
+  completionCoalescer.expire(
+      next_index, timestamp, coalesce_time, completion_out);
+  tail = next_index;
+  dropped_frames = dropped_frame_cnt;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RX_DMA_HPP
+#define RX_DMA_HPP
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/CompletionCoalescer.hpp"
+#include "../utils/axis_word.hpp"
+#include "PayloadWriter.hpp"
+#include "RXCompletion.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Back end of eth_in. Every call with a frame waiting in data_in writes its
+// payload into the buffer of the ring entry at tail, in place for the host to
+// read. The buffers of ring_size entries of RX_DMA_BUFFER_BYTES each start at
+// byte address buffer_addr of mem, the completion entries (see RXCompletion)
+// at completion_addr. Once the completion entry is written, tail moves on.
+// The host hands entries back by moving head past them. Frames arriving while
+// only the entry before head is left are dropped and counted in
+// dropped_frames. Completions are reported over completion_out as coalesced by
+// CompletionCoalescer, with the time taken from timestamp.
+
+void rx_dma(hls::stream<axis_word> &data_in,
+            ap_uint<64> *mem,
+            const ap_uint<32> &buffer_addr,
+            const ap_uint<32> &completion_addr,
+            const ap_uint<16> &ring_size,
+            const ap_uint<16> &head,
+            ap_uint<16> &tail,
+            const ap_uint<16> &coalesce_count,
+            const ap_uint<32> &coalesce_time,
+            const ap_uint<64> &timestamp,
+            ap_uint<32> &dropped_frames,
+            hls::stream<ap_uint<16> > &completion_out);
+
+#endif
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "../utils/Addresses.hpp"
+#include "../utils/axis_word.hpp"
+#include "../utils/test/Comparison.hpp"
+#include "../utils/test/ITest.hpp"
+#include "../utils/test/OutputStreamStore.hpp"
+#include "../utils/test/StreamContainer.hpp"
+#include "../utils/test/TimedValue.hpp"
+#include "../utils/test/pack_words.hpp"
+#include "rx_dma.hpp"
+#include <ap_int.h>
+#include <string>
+#include <vector>
+
+// Memory as seen through the m_axi port, with the completion entries at its
+// start and the buffers behind them
+const int MEM_WORDS = 8 * RX_DMA_BUFFER_BYTES / RX_DMA_WORD_BYTES + 64;
+const ap_uint<32> COMPLETION_ADDR = 0;
+const ap_uint<32> BUFFER_ADDR = 512;
+const ap_uint<16> RING_SIZE = 8;
+ap_uint<64> mem[MEM_WORDS];
+
+// Frame handed over by eth_in at step, together with the entry it is expected
+// in or -1 if it is dropped
+struct RXFrame {
+  int step;
+  Addresses src;
+  int queue;
+  bool error;
+  std::vector<ap_uint<8> > payload;
+  int entry;
+};
+
+class RxDmaTest : public ITest {
+public:
+  OutputStreamStore<ap_uint<16> > completion_out_store;
+  ap_uint<16> head;
+  ap_uint<16> coalesce_count;
+  ap_uint<32> coalesce_time;
+  ap_uint<32> dropped_frames;
+  RxDmaTest(const std::string &title,
+            const std::vector<RXFrame> &frames,
+            const ap_uint<16> &head,
+            const ap_uint<16> &coalesce_count,
+            const ap_uint<32> &coalesce_time,
+            const std::vector<TimedValue<ap_uint<16> > > &completion_out_tv,
+            const ap_uint<32> &dropped_frames_ref)
+      : ITest(title),
+        completion_out_store("COMPLETION_OUT", completion_out_tv, 1),
+        head(head), coalesce_count(coalesce_count),
+        coalesce_time(coalesce_time), dropped_frames(0),
+        dropped_frames_ref(dropped_frames_ref), frames(frames) {}
+  void feed_inputs(int step_index) override {
+    for (const RXFrame &frame : this->frames) {
+      if (frame.step == step_index) {
+        for (const TimedValue<axis_word> &word : pack_words(get_bytes(frame))) {
+          this->data_in.stream.write(word.value);
+        }
+      }
+    }
+  }
+  void store_outputs(int step_index) override {
+    this->completion_out_store.store(step_index);
+  }
+  StreamContainer<axis_word> data_in;
+
+private:
+  ap_uint<32> dropped_frames_ref;
+  std::vector<RXFrame> frames;
+  std::vector<Comparison> get_comparisons() override {
+    std::vector<ap_uint<64> > entry_refs;
+    std::vector<ap_uint<64> > entry_values;
+    std::vector<ap_uint<8> > buffer_refs;
+    std::vector<ap_uint<8> > buffer_values;
+    for (const RXFrame &frame : this->frames) {
+      if (frame.entry < 0) {
+        continue;
+      }
+      int length = std::min<int>(frame.payload.size(), RX_DMA_BUFFER_BYTES);
+      ap_uint<16> status = 1 << RX_STATUS_VALID_BIT;
+      status[RX_STATUS_ERROR_BIT] = frame.error;
+      status[RX_STATUS_TRUNCATED_BIT] = length < frame.payload.size();
+      status(15, RX_STATUS_QUEUE_LOW) = frame.queue;
+      ap_uint<64> word = 0;
+      word(47, 0) = frame.src.mac_addr;
+      word(63, 48) = frame.src.udp_port;
+      entry_refs.push_back(word);
+      word(31, 0) = frame.src.ip_addr;
+      word(47, 32) = length;
+      word(63, 48) = status;
+      entry_refs.push_back(word);
+      entry_refs.push_back(frame.step);
+      int entry_base = COMPLETION_ADDR / RX_DMA_WORD_BYTES +
+                       frame.entry * RX_COMPLETION_WORDS;
+      for (int i = 0; i < RX_COMPLETION_WORDS; i++) {
+        entry_values.push_back(mem[entry_base + i]);
+      }
+      int buffer_base = BUFFER_ADDR + frame.entry * RX_DMA_BUFFER_BYTES;
+      for (int i = 0; i < length; i++) {
+        buffer_refs.push_back(frame.payload[i]);
+        int addr = buffer_base + i;
+        int byte = addr % RX_DMA_WORD_BYTES;
+        buffer_values.push_back(
+            mem[addr / RX_DMA_WORD_BYTES](8 * byte + 7, 8 * byte));
+      }
+    }
+    return {this->completion_out_store.get_comparison(),
+            Comparison("ENTRIES", entry_refs, entry_values, 3),
+            Comparison("BUFFERS", buffer_refs, buffer_values, 8),
+            Comparison("DROPPED_FRAMES",
+                       std::vector<ap_uint<32> >{this->dropped_frames_ref},
+                       std::vector<ap_uint<32> >{this->dropped_frames},
+                       1)};
+  }
+  static std::vector<TimedValue<byte_word> > get_bytes(const RXFrame &frame) {
+    ap_uint<AXIS_USER_WIDTH> user = axis_word::to_user(frame.src);
+    user[USER_ERROR_BIT] = frame.error;
+    user(USER_QUEUE_HIGH, USER_QUEUE_LOW) = frame.queue;
+    std::vector<TimedValue<byte_word> > bytes;
+    for (int i = 0; i < frame.payload.size(); i++) {
+      bool last = i == frame.payload.size() - 1;
+      bytes.push_back({frame.step, {frame.payload[i], last, user}});
+    }
+    return bytes;
+  }
+};
+
+int main() {
+  const int NUM_STEPS = 60;
+  std::vector<RxDmaTest> tests;
+  int errors = 0;
+
+  const Addresses src = {0x123456789abc, 0x13579bdf, 0xde60};
+  const Addresses other_src = {0x0a0b0c0d0e0f, 0x98765433, 0x1234};
+
+  std::vector<ap_uint<8> > payload;
+  for (int i = 0; i < 21; i++) {
+    payload.push_back(i);
+  }
+  tests.push_back({"Single payload",
+                   {{2, src, 1, false, payload, 0}},
+                   0,
+                   1,
+                   1000,
+                   {{2, 1}},
+                   0});
+
+  tests.push_back({"Completions coalesced by count",
+                   {{2, src, 0, false, payload, 1},
+                    {3, other_src, 2, true, {0xaa}, 2}},
+                   0,
+                   2,
+                   1000,
+                   {{3, 3}},
+                   0});
+
+  tests.push_back({"Completions coalesced by time",
+                   {{2, src, 0, false, payload, 3},
+                    {10, src, 0, false, {0xbb, 0xcc}, 4}},
+                   0,
+                   4,
+                   20,
+                   {{22, 5}},
+                   0});
+
+  // Only the entries up to the one before head may be written
+  tests.push_back({"Full ring",
+                   {{2, src, 0, false, {0x01}, 5},
+                    {3, src, 0, false, {0x02}, 6},
+                    {4, src, 0, false, {0x03}, -1},
+                    {5, src, 0, false, {0x04}, -1}},
+                   0,
+                   1,
+                   1000,
+                   {{2, 6}, {3, 7}},
+                   2});
+
+  std::vector<ap_uint<8> > long_payload;
+  for (int i = 0; i < RX_DMA_BUFFER_BYTES + 10; i++) {
+    long_payload.push_back(i * 7);
+  }
+  // The count of dropped frames carries on from the test before
+  tests.push_back({"Truncated payload",
+                   {{2, src, 0, false, long_payload, 7}},
+                   1,
+                   1,
+                   1000,
+                   {{2, 0}},
+                   2});
+
+  for (int i = 0; i < tests.size(); i++) {
+    for (int j = 0; j < NUM_STEPS; j++) {
+      tests[i].feed_inputs(j);
+      ap_uint<16> tail;
+      rx_dma(tests[i].data_in.stream,
+             mem,
+             BUFFER_ADDR,
+             COMPLETION_ADDR,
+             RING_SIZE,
+             tests[i].head,
+             tail,
+             tests[i].coalesce_count,
+             tests[i].coalesce_time,
+             j,
+             tests[i].dropped_frames,
+             tests[i].completion_out_store.stream);
+      tests[i].store_outputs(j);
+    }
+    errors += tests[i].get_result();
+  }
+  return errors;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FragmentReader.hpp"
+
+void FragmentReader::read(ap_uint<64> *mem,
+                          const ap_uint<32> &addr,
+                          const ap_uint<16> &length,
+                          const ap_uint<1> &last,
+                          const ap_uint<AXIS_USER_WIDTH> &user,
+                          hls::stream<axis_word> &data_out) {
+#pragma HLS INLINE
+
+  ap_uint<32> first_word = addr / TX_DMA_WORD_BYTES;
+  ap_uint<14> num_words = (length + TX_DMA_WORD_BYTES - 1) / TX_DMA_WORD_BYTES;
+  for (ap_uint<14> i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = 190
+    ap_uint<64> data = mem[first_word + i];
+    ap_uint<16> num_bytes = length - TX_DMA_WORD_BYTES * i;
+    for (int j = 0; j < TX_DMA_WORD_BYTES; j++) {
+#pragma HLS UNROLL
+      if (j < num_bytes) {
+        ap_uint<1> last_byte = last && j == num_bytes - 1;
+        this->word.set_byte(this->byte_cnt, data(8 * j + 7, 8 * j));
+        this->word.keep[this->byte_cnt] = 1;
+        if (this->byte_cnt == DATAPATH_BYTES - 1 || last_byte) {
+          this->word.last = last_byte;
+          this->word.user = user;
+          data_out.write(this->word);
+          this->word = axis_word(0, 0, false, 0);
+          this->byte_cnt = 0;
+        } else {
+          this->byte_cnt++;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FRAGMENT_READER_HPP
+#define FRAGMENT_READER_HPP
+#pragma once
+
+#include "../utils/axis_word.hpp"
+#include "../utils/bit_width.hpp"
+#include "TXDescriptor.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Reads fragments from memory in bursts and packs their bytes into the words
+// of data_out. A word is only written once it is full or the fragment ends the
+// frame, so the fragments of a frame are passed on back to back.
+class FragmentReader {
+public:
+  FragmentReader() : word(0, 0, false, 0), byte_cnt(0) {}
+  void read(ap_uint<64> *mem,
+            const ap_uint<32> &addr,
+            const ap_uint<16> &length,
+            const ap_uint<1> &last,
+            const ap_uint<AXIS_USER_WIDTH> &user,
+            hls::stream<axis_word> &data_out);
+
+private:
+  axis_word word;
+  ap_uint<bit_width<DATAPATH_BYTES>::value> byte_cnt;
+};
+
+#endif
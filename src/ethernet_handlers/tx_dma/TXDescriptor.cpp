@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TXDescriptor.hpp"
+
+void TXDescriptor::read(ap_uint<64> *mem, const ap_uint<32> &base) {
+#pragma HLS INLINE
+
+  for (int i = 0; i < TX_DESCRIPTOR_WORDS; i++) {
+#pragma HLS PIPELINE II = 1
+    this->words[i] = mem[base + i];
+  }
+}
+
+void TXDescriptor::complete(ap_uint<64> *mem,
+                            const ap_uint<32> &base,
+                            const ap_uint<1> &error) {
+#pragma HLS INLINE
+
+  ap_uint<64> status = this->words[1];
+  status[TX_DESCRIPTOR_ERROR_BIT] = error;
+  status[TX_DESCRIPTOR_DONE_BIT] = 1;
+  mem[base + 1] = status;
+}
+
+Addresses TXDescriptor::get_dst() const {
+  return {this->words[0](47, 0), this->words[1](31, 0), this->words[0](63, 48)};
+}
+
+PayloadDescriptor TXDescriptor::get_payload_descriptor() const {
+  ap_uint<16> length = 0;
+  for (int i = 0; i < TX_DMA_MAX_FRAGMENTS; i++) {
+#pragma HLS UNROLL
+    if (i < this->get_num_fragments()) {
+      length += this->get_fragment_length(i);
+    }
+  }
+  return {length, this->words[1](55, 40), this->words[1][62]};
+}
+
+ap_uint<8> TXDescriptor::get_num_fragments() const {
+  ap_uint<8> num_fragments = this->words[1](39, 32);
+  return num_fragments > TX_DMA_MAX_FRAGMENTS ? ap_uint<8>(TX_DMA_MAX_FRAGMENTS)
+                                              : num_fragments;
+}
+
+ap_uint<32> TXDescriptor::get_fragment_addr(int i) const {
+  return this->words[2 + i](31, 0);
+}
+
+ap_uint<16> TXDescriptor::get_fragment_length(int i) const {
+  return this->words[2 + i](47, 32);
+}
+
+// Whether all fragments with bytes in them start at a word boundary
+ap_uint<1> TXDescriptor::is_aligned() const {
+  ap_uint<1> aligned = true;
+  for (int i = 0; i < TX_DMA_MAX_FRAGMENTS; i++) {
+#pragma HLS UNROLL
+    if (i < this->get_num_fragments() && this->get_fragment_length(i) != 0 &&
+        this->get_fragment_addr(i) % TX_DMA_WORD_BYTES != 0) {
+      aligned = false;
+    }
+  }
+  return aligned;
+}
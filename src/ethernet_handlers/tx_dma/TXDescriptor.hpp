@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_DESCRIPTOR_HPP
+#define TX_DESCRIPTOR_HPP
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/PayloadDescriptor.hpp"
+#include <ap_int.h>
+
+// Bytes of a word of the memory tx_dma reads from
+const int TX_DMA_WORD_BYTES = 8;
+
+// Most fragments one frame may be gathered from
+const int TX_DMA_MAX_FRAGMENTS = 6;
+
+// Words of a descriptor in memory. Word 0 holds the destination MAC address at
+// bits 47 to 0 and the UDP port at bits 63 to 48. Word 1 holds the destination
+// IP address at bits 31 to 0, the number of fragments at bits 39 to 32, the
+// checksum of the payload at bits 55 to 40, the error flag at bit 61,
+// no_checksum at bit 62 and the done flag at bit 63. Each of the words that
+// follow describes one fragment, with its byte address at bits 31 to 0 and its
+// length at bits 47 to 32. Fragments have to start at a word boundary, a frame
+// with a fragment that does not is completed with the error flag set instead of
+// being sent.
+const int TX_DESCRIPTOR_WORDS = 2 + TX_DMA_MAX_FRAGMENTS;
+const int TX_DESCRIPTOR_ERROR_BIT = 61;
+const int TX_DESCRIPTOR_DONE_BIT = 63;
+
+class TXDescriptor {
+public:
+  void read(ap_uint<64> *mem, const ap_uint<32> &base);
+  void complete(ap_uint<64> *mem,
+                const ap_uint<32> &base,
+                const ap_uint<1> &error);
+  Addresses get_dst() const;
+  PayloadDescriptor get_payload_descriptor() const;
+  ap_uint<8> get_num_fragments() const;
+  ap_uint<32> get_fragment_addr(int i) const;
+  ap_uint<16> get_fragment_length(int i) const;
+  ap_uint<1> is_aligned() const;
+
+private:
+  ap_uint<64> words[TX_DESCRIPTOR_WORDS];
+};
+
+#endif
@@ -0,0 +1,40 @@
+set design_files {
+  tx_dma.cpp
+  FragmentReader.cpp
+  TXDescriptor.cpp
+  ../utils/CompletionCoalescer.cpp
+  ../utils/axis_word.cpp
+}
+set tb_files {
+  tx_dma_test.cpp
+  ../utils/test/calculate_checksum.cpp
+  ../utils/Addresses.cpp
+  ../utils/PayloadDescriptor.cpp
+}
+
+# IP name and compiler flags of every variant
+set variants {
+  tx_dma {}
+  tx_dma_4byte {-DDATAPATH_BYTES=4}
+  tx_dma_8byte {-DDATAPATH_BYTES=8}
+}
+
+foreach {ip_name cflags} $variants {
+  open_project proj_$ip_name -reset
+  set_top tx_dma
+  foreach file $design_files {
+    add_files $file -cflags $cflags
+  }
+  foreach file $tb_files {
+    add_files -tb $file -cflags $cflags
+  }
+  open_solution "solution1"
+  set_part {xc7a100tcsg324-1}
+  create_clock -period 20 -name default
+  set_clock_uncertainty 1
+  config_rtl -module_auto_prefix -reset all -reset_level high
+  csim_design
+  csynth_design
+  cosim_design -rtl verilog -tool xsim
+  export_design -format ip_catalog -flow impl -ipname $ip_name -library eth -output ../../ip/$ip_name -rtl verilog -vendor ME -version 1.0.0
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tx_dma.hpp"
+
+void tx_dma(ap_uint<64> *mem,
+            const ap_uint<32> &ring_addr,
+            const ap_uint<16> &ring_size,
+            const ap_uint<16> &head,
+            ap_uint<16> &tail,
+            const ap_uint<16> &coalesce_count,
+            hls::stream<axis_word> &data_out,
+            hls::stream<PayloadDescriptor> &desc_out,
+            hls::stream<ap_uint<16> > &completion_out) {
+#pragma HLS INTERFACE m_axi port = mem offset = slave depth = 1024
+#pragma HLS INTERFACE s_axilite port = ring_addr
+#pragma HLS INTERFACE s_axilite port = ring_size
+#pragma HLS INTERFACE s_axilite port = head
+#pragma HLS INTERFACE s_axilite port = tail
+#pragma HLS INTERFACE s_axilite port = coalesce_count
+#pragma HLS INTERFACE s_axilite port = return
+#pragma HLS INTERFACE axis port = data_out
+#pragma HLS INTERFACE axis port = desc_out
+#pragma HLS INTERFACE axis port = completion_out
+
+  static ap_uint<16> next_index = 0;
+  static FragmentReader fragmentReader;
+  static CompletionCoalescer completionCoalescer;
+
+  if (next_index != head) {
+    ap_uint<32> base =
+        ring_addr / TX_DMA_WORD_BYTES + next_index * TX_DESCRIPTOR_WORDS;
+    TXDescriptor desc;
+    desc.read(mem, base);
+    PayloadDescriptor payload_desc = desc.get_payload_descriptor();
+    ap_uint<1> aligned = desc.is_aligned();
+    if (aligned && payload_desc.length != 0) {
+      ap_uint<AXIS_USER_WIDTH> user = axis_word::to_user(desc.get_dst());
+      desc_out.write(payload_desc);
+      // The last fragment with bytes in it ends the frame
+      ap_uint<8> last_fragment = 0;
+      for (int i = 0; i < TX_DMA_MAX_FRAGMENTS; i++) {
+#pragma HLS UNROLL
+        if (i < desc.get_num_fragments() && desc.get_fragment_length(i) != 0) {
+          last_fragment = i;
+        }
+      }
+      for (int i = 0; i < TX_DMA_MAX_FRAGMENTS; i++) {
+        if (i <= last_fragment) {
+          fragmentReader.read(mem,
+                              desc.get_fragment_addr(i),
+                              desc.get_fragment_length(i),
+                              i == last_fragment,
+                              user,
+                              data_out);
+        }
+      }
+    }
+    desc.complete(mem, base, !aligned);
+    if (next_index == ring_size - 1) {
+      next_index = 0;
+    } else {
+      next_index++;
+    }
+    completionCoalescer.complete(next_index, coalesce_count, completion_out);
+  } else {
+    completionCoalescer.flush(next_index, completion_out);
+  }
+  tail = next_index;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_DMA_HPP
+#define TX_DMA_HPP
+#pragma once
+
+#include "../utils/Addresses.hpp"
+#include "../utils/CompletionCoalescer.hpp"
+#include "../utils/PayloadDescriptor.hpp"
+#include "../utils/axis_word.hpp"
+#include "FragmentReader.hpp"
+#include "TXDescriptor.hpp"
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Front end of an eth_out built with ETH_OUT_CUT_THROUGH. The ring of
+// ring_size descriptors at byte address ring_addr of mem (see TXDescriptor)
+// is filled by the host up to the entry before head. Every call sends the
+// frame of the entry at tail, if any, gathered from its fragments. The entry
+// is then marked done in memory and tail moves on. Completions are reported
+// over completion_out as coalesced by CompletionCoalescer. Frames without
+// payload are completed without being sent, as are those with a fragment off
+// a word boundary, with the error flag set.
+//
+// Each fragment is read in one burst, so the words of a frame pause for the
+// read latency of mem at the start of every fragment. A cut-through eth_out
+// starts sending with the first word of a frame and needs the rest at line
+// rate, a frame falling behind is sent with a wrong FCS and lost (see eth_out).
+// The pauses after the first fragment therefore have to add up to less than
+// the PHY takes for the 50 bytes of preamble and headers and the payload of all
+// fragments but the last, 8 ns a byte with GMII and 80 ns with RMII.
+
+void tx_dma(ap_uint<64> *mem,
+            const ap_uint<32> &ring_addr,
+            const ap_uint<16> &ring_size,
+            const ap_uint<16> &head,
+            ap_uint<16> &tail,
+            const ap_uint<16> &coalesce_count,
+            hls::stream<axis_word> &data_out,
+            hls::stream<PayloadDescriptor> &desc_out,
+            hls::stream<ap_uint<16> > &completion_out);
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "../utils/Addresses.hpp"
+#include "../utils/PayloadDescriptor.hpp"
+#include "../utils/axis_word.hpp"
+#include "../utils/test/Comparison.hpp"
+#include "../utils/test/ITest.hpp"
+#include "../utils/test/OutputStreamStore.hpp"
+#include "../utils/test/TimedValue.hpp"
+#include "../utils/test/calculate_checksum.hpp"
+#include "../utils/test/pack_words.hpp"
+#include "tx_dma.hpp"
+#include <ap_int.h>
+#include <string>
+#include <vector>
+
+// Memory as seen through the m_axi port, with the descriptor ring at its start
+// and the fragments behind it
+const int MEM_WORDS = 1024;
+const ap_uint<32> RING_ADDR = 0;
+const ap_uint<16> RING_SIZE = 4;
+const int FIRST_FRAGMENT_WORD = RING_SIZE * TX_DESCRIPTOR_WORDS;
+ap_uint<64> mem[MEM_WORDS];
+
+struct TXFrame {
+  Addresses dst;
+  std::vector<std::vector<ap_uint<8> > > fragments;
+  ap_uint<1> no_checksum;
+  // The fragments start a byte after a word boundary
+  ap_uint<1> unaligned;
+};
+
+class TxDmaTest : public ITest {
+public:
+  OutputStreamStore<axis_word> data_out_store;
+  OutputStreamStore<PayloadDescriptor> desc_out_store;
+  OutputStreamStore<ap_uint<16> > completion_out_store;
+  ap_uint<16> head;
+  ap_uint<16> coalesce_count;
+  TxDmaTest(const std::string &title,
+            int first_index,
+            const std::vector<TXFrame> &frames,
+            const ap_uint<16> &coalesce_count,
+            const std::vector<ap_uint<16> > &completions)
+      : ITest(title), data_out_store("DATA_OUT", expect_data(frames), 1, false),
+        desc_out_store("DESC_OUT", expect_desc(frames), 1, false),
+        completion_out_store(
+            "COMPLETION_OUT", timeless(completions), 1, false),
+        head((first_index + frames.size()) % RING_SIZE),
+        coalesce_count(coalesce_count), first_index(first_index),
+        frames(frames) {}
+  // The frames are put into memory before the first step
+  void feed_inputs(int step_index) override {
+    if (step_index == 0) {
+      int fragment_word = FIRST_FRAGMENT_WORD;
+      for (int i = 0; i < this->frames.size(); i++) {
+        const TXFrame &frame = this->frames[i];
+        int base = this->get_base(i);
+        mem[base](47, 0) = frame.dst.mac_addr;
+        mem[base](63, 48) = frame.dst.udp_port;
+        mem[base + 1] = 0;
+        mem[base + 1](31, 0) = frame.dst.ip_addr;
+        mem[base + 1](39, 32) = frame.fragments.size();
+        mem[base + 1][62] = frame.no_checksum;
+        for (int j = 0; j < frame.fragments.size(); j++) {
+          const std::vector<ap_uint<8> > &bytes = frame.fragments[j];
+          mem[base + 2 + j] = 0;
+          mem[base + 2 + j](31, 0) =
+              TX_DMA_WORD_BYTES * fragment_word + frame.unaligned;
+          mem[base + 2 + j](47, 32) = bytes.size();
+          for (int k = 0; k < bytes.size(); k++) {
+            int word = fragment_word + k / TX_DMA_WORD_BYTES;
+            int byte = k % TX_DMA_WORD_BYTES;
+            mem[word](8 * byte + 7, 8 * byte) = bytes[k];
+          }
+          fragment_word += bytes.size() / TX_DMA_WORD_BYTES + 1;
+        }
+        ap_uint<16> checksum = calculate_checksum(join(frame.fragments));
+        checksum.b_not();
+        mem[base + 1](55, 40) = checksum;
+      }
+    }
+  }
+  void store_outputs(int step_index) override {
+    while (!this->data_out_store.stream.empty()) {
+      this->data_out_store.store(step_index);
+    }
+    while (!this->desc_out_store.stream.empty()) {
+      this->desc_out_store.store(step_index);
+    }
+    while (!this->completion_out_store.stream.empty()) {
+      this->completion_out_store.store(step_index);
+    }
+  }
+
+private:
+  int first_index;
+  std::vector<TXFrame> frames;
+  int get_base(int i) const {
+    return RING_ADDR / TX_DMA_WORD_BYTES +
+           (this->first_index + i) % RING_SIZE * TX_DESCRIPTOR_WORDS;
+  }
+  std::vector<Comparison> get_comparisons() override {
+    std::vector<int> done_refs(this->frames.size(), 1);
+    std::vector<int> done_values;
+    std::vector<int> error_refs;
+    std::vector<int> error_values;
+    for (int i = 0; i < this->frames.size(); i++) {
+      ap_uint<64> status = mem[this->get_base(i) + 1];
+      done_values.push_back(status[TX_DESCRIPTOR_DONE_BIT]);
+      error_refs.push_back(this->frames[i].unaligned);
+      error_values.push_back(status[TX_DESCRIPTOR_ERROR_BIT]);
+    }
+    return {this->data_out_store.get_comparison(),
+            this->desc_out_store.get_comparison(),
+            this->completion_out_store.get_comparison(),
+            Comparison("DONE", done_refs, done_values, 1),
+            Comparison("ERROR", error_refs, error_values, 1)};
+  }
+  static std::vector<TimedValue<axis_word> >
+  expect_data(const std::vector<TXFrame> &frames) {
+    std::vector<TimedValue<byte_word> > bytes;
+    for (const TXFrame &frame : frames) {
+      if (frame.unaligned) {
+        continue;
+      }
+      std::vector<ap_uint<8> > payload = join(frame.fragments);
+      for (int i = 0; i < payload.size(); i++) {
+        bytes.push_back({0, {payload[i], i == payload.size() - 1, frame.dst}});
+      }
+    }
+    return pack_words(bytes);
+  }
+  static std::vector<TimedValue<PayloadDescriptor> >
+  expect_desc(const std::vector<TXFrame> &frames) {
+    std::vector<TimedValue<PayloadDescriptor> > ret;
+    for (const TXFrame &frame : frames) {
+      if (frame.unaligned) {
+        continue;
+      }
+      std::vector<ap_uint<8> > payload = join(frame.fragments);
+      ap_uint<16> checksum = calculate_checksum(payload);
+      checksum.b_not();
+      ret.push_back({0, {payload.size(), checksum, frame.no_checksum}});
+    }
+    return ret;
+  }
+  static std::vector<ap_uint<8> >
+  join(const std::vector<std::vector<ap_uint<8> > > &fragments) {
+    std::vector<ap_uint<8> > ret;
+    for (const std::vector<ap_uint<8> > &fragment : fragments) {
+      ret.insert(ret.end(), fragment.begin(), fragment.end());
+    }
+    return ret;
+  }
+  static std::vector<TimedValue<ap_uint<16> > >
+  timeless(const std::vector<ap_uint<16> > &values) {
+    std::vector<TimedValue<ap_uint<16> > > ret;
+    for (const ap_uint<16> &value : values) {
+      ret.push_back({0, value});
+    }
+    return ret;
+  }
+};
+
+int main() {
+  const int NUM_CALLS = 8;
+  std::vector<TxDmaTest> tests;
+  int errors = 0;
+
+  const Addresses dst = {0xfedcba987654, 0x98765432, 0x0035};
+  const Addresses other_dst = {0x0a0b0c0d0e0f, 0x98765433, 0x1234};
+
+  std::vector<ap_uint<8> > payload;
+  for (int i = 0; i < 20; i++) {
+    payload.push_back(i);
+  }
+  tests.push_back(
+      {"Single fragment", 0, {{dst, {payload}, false, false}}, 1, {1}});
+
+  const std::vector<ap_uint<8> > header{0xca, 0xfe, 0xba, 0xbe, 0x01};
+  std::vector<ap_uint<8> > body;
+  for (int i = 0; i < 30; i++) {
+    body.push_back(0x80 + i);
+  }
+  tests.push_back({"Header and payload fragments",
+                   1,
+                   {{dst, {header, body}, true, false}},
+                   1,
+                   {2}});
+
+  // The last two entries wrap around the end of the ring
+  tests.push_back({"Coalesced completions",
+                   2,
+                   {{dst, {{0x11}, {0x22}, body}, false, false},
+                    {other_dst, {payload, {}}, false, false},
+                    {dst, {header}, false, false}},
+                   2,
+                   {0, 1}});
+  // The frame of the unaligned fragments is completed without being sent
+  tests.push_back({"Unaligned fragment",
+                   1,
+                   {{dst, {header, body}, false, true},
+                    {other_dst, {payload}, false, false}},
+                   1,
+                   {2, 3}});
+
+  for (int i = 0; i < tests.size(); i++) {
+    for (int j = 0; j < NUM_CALLS; j++) {
+      tests[i].feed_inputs(j);
+      ap_uint<16> tail;
+      tx_dma(mem,
+             RING_ADDR,
+             RING_SIZE,
+             tests[i].head,
+             tail,
+             tests[i].coalesce_count,
+             tests[i].data_out_store.stream,
+             tests[i].desc_out_store.stream,
+             tests[i].completion_out_store.stream);
+      tests[i].store_outputs(j);
+    }
+    errors += tests[i].get_result();
+  }
+  return errors;
+}
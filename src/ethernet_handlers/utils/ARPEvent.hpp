@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARP_EVENT_HPP
+#define ARP_EVENT_HPP
+#pragma once
+
+#include "VLANTag.hpp"
+#include <ap_int.h>
+#include <iostream>
+
+// ARP packet received by eth_in, in the VLAN of vlan. eth_out learns the
+// sender from it and answers requests for its own IP address in the same VLAN.
+struct ARPEvent {
+  ap_uint<16> operation;
+  ap_uint<48> sender_mac_addr;
+  ap_uint<32> sender_ip_addr;
+  ap_uint<32> target_ip_addr;
+  VLANTag vlan;
+  bool operator==(const ARPEvent other) const {
+    return this->operation == other.operation &&
+           this->sender_mac_addr == other.sender_mac_addr &&
+           this->sender_ip_addr == other.sender_ip_addr &&
+           this->target_ip_addr == other.target_ip_addr &&
+           this->vlan.tagged == other.vlan.tagged &&
+           this->vlan.tci == other.vlan.tci;
+  }
+  bool operator!=(const ARPEvent other) const { return !(*this == other); }
+};
+
+std::ostream &operator<<(std::ostream &os, const ARPEvent &event);
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CompletionCoalescer.hpp"
+
+void CompletionCoalescer::complete(const ap_uint<16> &index,
+                                   const ap_uint<16> &coalesce_count,
+                                   hls::stream<ap_uint<16> > &completion_out) {
+#pragma HLS INLINE
+
+  this->pending++;
+  if (this->pending >= coalesce_count) {
+    completion_out.write(index);
+    this->pending = 0;
+  }
+}
+
+void CompletionCoalescer::complete(const ap_uint<16> &index,
+                                   const ap_uint<16> &coalesce_count,
+                                   const ap_uint<64> &now,
+                                   hls::stream<ap_uint<16> > &completion_out) {
+#pragma HLS INLINE
+
+  if (this->pending == 0) {
+    this->first_time = now;
+  }
+  this->complete(index, coalesce_count, completion_out);
+}
+
+void CompletionCoalescer::flush(const ap_uint<16> &index,
+                                hls::stream<ap_uint<16> > &completion_out) {
+#pragma HLS INLINE
+
+  if (this->pending != 0) {
+    completion_out.write(index);
+    this->pending = 0;
+  }
+}
+
+void CompletionCoalescer::expire(const ap_uint<16> &index,
+                                 const ap_uint<64> &now,
+                                 const ap_uint<32> &coalesce_time,
+                                 hls::stream<ap_uint<16> > &completion_out) {
+#pragma HLS INLINE
+
+  if (now - this->first_time >= coalesce_time) {
+    this->flush(index, completion_out);
+  }
+}
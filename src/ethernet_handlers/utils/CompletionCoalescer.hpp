@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef COMPLETION_COALESCER_HPP
+#define COMPLETION_COALESCER_HPP
+#pragma once
+
+#include <ap_int.h>
+#include <hls_stream.h>
+
+// Reports the index of the ring entry following the last one completed. A
+// report is only written once coalesce_count entries completed since the last
+// one. Completions left unreported are flushed when the ring ran empty, or
+// expire coalesce_time after the first of them, as measured by now.
+class CompletionCoalescer {
+public:
+  CompletionCoalescer() : pending(0), first_time(0) {}
+  void complete(const ap_uint<16> &index,
+                const ap_uint<16> &coalesce_count,
+                hls::stream<ap_uint<16> > &completion_out);
+  void complete(const ap_uint<16> &index,
+                const ap_uint<16> &coalesce_count,
+                const ap_uint<64> &now,
+                hls::stream<ap_uint<16> > &completion_out);
+  void flush(const ap_uint<16> &index,
+             hls::stream<ap_uint<16> > &completion_out);
+  void expire(const ap_uint<16> &index,
+              const ap_uint<64> &now,
+              const ap_uint<32> &coalesce_time,
+              hls::stream<ap_uint<16> > &completion_out);
+
+private:
+  ap_uint<16> pending;
+  ap_uint<64> first_time;
+};
+
+#endif
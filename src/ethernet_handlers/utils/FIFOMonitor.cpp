@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FIFOMonitor.hpp"
+
+ap_uint<8> fifo_stat_select(int fifo, fifo_stat stat) {
+#pragma HLS INLINE
+
+  return NUM_FIFO_STATS * fifo + stat;
+}
+
+void FIFOMonitor::update(const ap_uint<16> &level, const ap_uint<1> &full) {
+#pragma HLS INLINE
+
+  this->level = level;
+  if (level > this->peak) {
+    this->peak = level;
+  }
+  if (full) {
+    this->full_cycles++;
+  }
+  if (level == 0) {
+    this->empty_cycles++;
+  }
+}
+
+// The peak starts over from the current level
+void FIFOMonitor::take_snapshot() {
+#pragma HLS INLINE
+
+  this->peak_snapshot = this->peak;
+  this->full_cycles_snapshot = this->full_cycles;
+  this->empty_cycles_snapshot = this->empty_cycles;
+  this->peak = this->level;
+  this->full_cycles = 0;
+  this->empty_cycles = 0;
+}
+
+ap_uint<64> FIFOMonitor::get(const ap_uint<8> &stat) const {
+#pragma HLS INLINE
+
+  switch (stat) {
+  case FIFO_LEVEL:
+    return this->level;
+  case FIFO_PEAK:
+    return this->peak_snapshot;
+  case FIFO_FULL_CYCLES:
+    return this->full_cycles_snapshot;
+  case FIFO_EMPTY_CYCLES:
+    return this->empty_cycles_snapshot;
+  default:
+    return 0;
+  }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FIFO_MONITOR_HPP
+#define FIFO_MONITOR_HPP
+#pragma once
+
+#include <ap_int.h>
+
+// Values kept for each FIFO, selected by fifo_select together with the FIFO
+// (see fifo_stat_select):
+// - FIFO_LEVEL: words in the FIFO right now
+// - FIFO_PEAK: most words in the FIFO at once
+// - FIFO_FULL_CYCLES: cycles the FIFO was full, so its writer had to wait
+// - FIFO_EMPTY_CYCLES: cycles the FIFO was empty, so its reader had to wait
+// All but FIFO_LEVEL start over with each snapshot of the StatCounters.
+enum fifo_stat {
+  FIFO_LEVEL,
+  FIFO_PEAK,
+  FIFO_FULL_CYCLES,
+  FIFO_EMPTY_CYCLES,
+  NUM_FIFO_STATS
+};
+
+// Watches the fill level of a FIFO between two stages. An hls::stream does
+// not tell its level in hardware, so it is handed in once per cycle, mostly as
+// the words written less the words read so far. The C simulation does not
+// limit the depth of an hls::stream, so a peak above the depth of a FIFO there
+// is the number of words it would have needed to never stall its writer.
+class FIFOMonitor {
+public:
+  FIFOMonitor()
+      : level(0), peak(0), full_cycles(0), empty_cycles(0), peak_snapshot(0),
+        full_cycles_snapshot(0), empty_cycles_snapshot(0) {}
+  void update(const ap_uint<16> &level, const ap_uint<1> &full);
+  void take_snapshot();
+  ap_uint<64> get(const ap_uint<8> &stat) const;
+
+private:
+  ap_uint<16> level;
+  ap_uint<16> peak;
+  ap_uint<48> full_cycles;
+  ap_uint<48> empty_cycles;
+  ap_uint<16> peak_snapshot;
+  ap_uint<48> full_cycles_snapshot;
+  ap_uint<48> empty_cycles_snapshot;
+};
+
+// Value of fifo_select for stat of the FIFO with index fifo
+ap_uint<8> fifo_stat_select(int fifo, fifo_stat stat);
+
+// Takes a snapshot of all N monitors if snapshot_taken is set and sets value
+// to the value fifo_select stands for
+template <int N>
+void publish_fifos(FIFOMonitor monitors[N],
+                   const ap_uint<1> &snapshot_taken,
+                   const ap_uint<8> &fifo_select,
+                   ap_uint<64> &value) {
+#pragma HLS INLINE
+
+  value = 0;
+  for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+    if (snapshot_taken) {
+      monitors[i].take_snapshot();
+    }
+    if (i == fifo_select.to_int() / NUM_FIFO_STATS) {
+      value = monitors[i].get(fifo_select % NUM_FIFO_STATS);
+    }
+  }
+}
+
+#endif
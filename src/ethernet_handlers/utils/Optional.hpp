@@ -44,6 +44,7 @@ public:
   ap_uint<1> is_none() const { return type == None; }
 };
 
-const Optional<axis_word> NOTHING = {None, {0, false, 0}};
+const Optional<byte_word> NOTHING = {None, {0, false, 0}};
+const Optional<axis_word> NO_WORD = {None, {0, false, 0}};
 
 #endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PAYLOAD_DESCRIPTOR_HPP
+#define PAYLOAD_DESCRIPTOR_HPP
+#pragma once
+
+#include <ap_int.h>
+#include <iostream>
+
+// Announces a frame of data_in to a cut-through eth_out ahead of its payload.
+// checksum is the ones' complement sum of the payload alone, as summed up by
+// Checksum. With no_checksum set, the UDP checksum is sent as 0 instead.
+struct PayloadDescriptor {
+  ap_uint<16> length;
+  ap_uint<16> checksum;
+  ap_uint<1> no_checksum;
+  bool operator==(const PayloadDescriptor other) const {
+    return this->length == other.length && this->checksum == other.checksum &&
+           this->no_checksum == other.no_checksum;
+  }
+  bool operator!=(const PayloadDescriptor other) const {
+    return !(*this == other);
+  }
+};
+
+std::ostream &operator<<(std::ostream &os, const PayloadDescriptor &desc);
+
+#endif
@@ -27,20 +27,24 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "DataGate.hpp"
+#include "StatCounters.hpp"
 
-void DataGate::handle(hls::stream<axis_word> &data_buffer,
-                      hls::stream<ap_uint<1> > &valid_buffer,
-                      hls::stream<axis_word> &data_out) {
-  if (!valid_buffer.empty()) {
-    working = true;
-    sending = valid_buffer.read();
-  }
-  if (working) {
-    axis_word word = data_buffer.read();
-    if (sending) {
-      data_out.write(word);
-    }
-    working = !word.last;
+ap_uint<3> size_bucket(const ap_uint<16> &frame_bytes) {
+#pragma HLS INLINE
+
+  if (frame_bytes <= 64) {
+    return 0;
+  } else if (frame_bytes < 128) {
+    return 1;
+  } else if (frame_bytes < 256) {
+    return 2;
+  } else if (frame_bytes < 512) {
+    return 3;
+  } else if (frame_bytes < 1024) {
+    return 4;
+  } else if (frame_bytes <= 1518) {
+    return 5;
+  } else {
+    return 6;
   }
 }
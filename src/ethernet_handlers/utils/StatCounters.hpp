@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef STAT_COUNTERS_HPP
+#define STAT_COUNTERS_HPP
+#pragma once
+
+#include <ap_int.h>
+
+// Frame size buckets of RMON: up to 64, 65 to 127, 128 to 255, 256 to 511,
+// 512 to 1023, 1024 to 1518 and 1519 bytes or more, counted from the
+// destination MAC address to the frame check sequence
+const int NUM_SIZE_BUCKETS = 7;
+
+ap_uint<3> size_bucket(const ap_uint<16> &frame_bytes);
+
+// N counters of 64 bits behind a register map. A change of snapshot copies
+// all counters to their snapshots and clears them in the same cycle, so no
+// event is missed or counted twice from one snapshot to the next. value
+// holds the snapshot of counter select. publish returns whether a snapshot
+// was taken, so other values can be kept from one snapshot to the next too.
+template <int N> class StatCounters {
+public:
+  StatCounters() : last_snapshot(0) {
+    for (int i = 0; i < N; i++) {
+      this->counts[i] = 0;
+      this->snapshots[i] = 0;
+    }
+  }
+  void add(const ap_uint<8> &counter, const ap_uint<16> &amount) {
+#pragma HLS INLINE
+
+    for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+      if (i == counter.to_int()) {
+        this->counts[i] += amount;
+      }
+    }
+  }
+  ap_uint<1> publish(const ap_uint<8> &snapshot,
+                     const ap_uint<8> &select,
+                     ap_uint<64> &value) {
+#pragma HLS INLINE
+
+    ap_uint<1> snapshot_taken = snapshot != this->last_snapshot;
+    if (snapshot_taken) {
+      for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+        this->snapshots[i] = this->counts[i];
+        this->counts[i] = 0;
+      }
+      this->last_snapshot = snapshot;
+    }
+    value = 0;
+    for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+      if (i == select.to_int()) {
+        value = this->snapshots[i];
+      }
+    }
+    return snapshot_taken;
+  }
+
+private:
+  ap_uint<64> counts[N];
+  ap_uint<64> snapshots[N];
+  ap_uint<8> last_snapshot;
+};
+
+#endif
@@ -29,8 +29,17 @@
 
 #include "axis_word.hpp"
 
-std::ostream &operator<<(std::ostream &os, const axis_word &word) {
-  os << (word.last ? "[" : "") << std::hex << word.data << "|" << word.user
-     << std::dec << (word.last ? "]" : "");
+template <int N>
+std::ostream &operator<<(std::ostream &os, const axis_word_n<N> &word) {
+  os << (word.last ? "[" : "") << std::hex << word.data;
+  if (N > 1) {
+    os << "/" << word.keep;
+  }
+  os << "|" << word.user << std::dec << (word.last ? "]" : "");
   return os;
 }
+
+template std::ostream &operator<<(std::ostream &os, const byte_word &word);
+#if DATAPATH_BYTES != 1
+template std::ostream &operator<<(std::ostream &os, const axis_word &word);
+#endif
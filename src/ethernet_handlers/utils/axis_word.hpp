@@ -32,39 +32,102 @@
 #pragma once
 
 #include "Addresses.hpp"
+#include "bit_width.hpp"
+#include "VLANTag.hpp"
+#include "port_table.hpp"
 #include <ap_int.h>
 #include <iostream>
 
-struct axis_word {
-  ap_uint<8> data;
+// Number of bytes moved per clock cycle on the streams of eth_in and eth_out.
+// The protocol stages work on single bytes and are run once per byte lane.
+#ifndef DATAPATH_BYTES
+#define DATAPATH_BYTES 1
+#endif
+
+// Bits 95 to 0 of the user field carry the addresses of the remote end (see
+// to_user), bit 96 flags a frame that failed a check and the bits above carry
+// the queue ID of the local UDP port the payload was sent to. The VLAN tag of
+// the frame follows (see get_vlan).
+const int USER_ERROR_BIT = 96;
+const int USER_QUEUE_LOW = 97;
+const int USER_QUEUE_HIGH = USER_QUEUE_LOW + QUEUE_ID_WIDTH - 1;
+const int USER_VLAN_BIT = USER_QUEUE_HIGH + 1;
+const int USER_TCI_LOW = USER_VLAN_BIT + 1;
+const int USER_TCI_HIGH = USER_TCI_LOW + 15;
+const int AXIS_USER_WIDTH = USER_TCI_HIGH + 1;
+
+// Stream word of N bytes. Byte i is stored at data(8 * i + 7, 8 * i) and is
+// valid if keep[i] is set. Only the last word of a frame may have bytes
+// missing.
+template <int N> struct axis_word_n {
+  ap_uint<8 * N> data;
+  ap_uint<N> keep;
   ap_uint<1> last;
-  ap_uint<96> user;
-  axis_word() : data(0), last(false), user(0) {}
-  axis_word(const ap_uint<8> &data,
-            const ap_uint<1> &last,
-            const ap_uint<96> &user)
-      : data(data), last(last), user(user) {}
-  axis_word(const ap_uint<8> &data,
-            const ap_uint<1> &last,
-            const Addresses &addr)
-      : data(data), last(last), user(to_user(addr)) {}
-  bool operator==(const axis_word other) const {
-    return this->data == other.data && this->last == other.last &&
-           this->user == other.user;
+  ap_uint<AXIS_USER_WIDTH> user;
+  axis_word_n() : data(0), keep(0), last(false), user(0) { keep.b_not(); }
+  axis_word_n(const ap_uint<8 * N> &data,
+              const ap_uint<1> &last,
+              const ap_uint<AXIS_USER_WIDTH> &user)
+      : data(data), keep(0), last(last), user(user) {
+    keep.b_not();
+  }
+  axis_word_n(const ap_uint<8 * N> &data,
+              const ap_uint<1> &last,
+              const Addresses &addr)
+      : data(data), keep(0), last(last), user(to_user(addr)) {
+    keep.b_not();
+  }
+  axis_word_n(const ap_uint<8 * N> &data,
+              const ap_uint<N> &keep,
+              const ap_uint<1> &last,
+              const ap_uint<AXIS_USER_WIDTH> &user)
+      : data(data), keep(keep), last(last), user(user) {}
+  bool operator==(const axis_word_n<N> other) const {
+    return this->data == other.data && this->keep == other.keep &&
+           this->last == other.last && this->user == other.user;
+  }
+  bool operator!=(const axis_word_n<N> other) const {
+    return (this->data != other.data) || (this->keep != other.keep) ||
+           (this->last != other.last) || (this->user != other.user);
   }
-  bool operator!=(const axis_word other) const {
-    return (this->data != other.data) || (this->last != other.last) ||
-           (this->user != other.user);
+  ap_uint<8> get_byte(int i) const { return this->data(8 * i + 7, 8 * i); }
+  void set_byte(int i, const ap_uint<8> &byte) {
+    this->data(8 * i + 7, 8 * i) = byte;
   }
-  static ap_uint<96> to_user(const Addresses &addr) {
-    ap_uint<96> ret;
+  ap_uint<bit_width<N>::value> num_bytes() const {
+#pragma HLS INLINE
+    ap_uint<bit_width<N>::value> ret = 0;
+    for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+      ret += this->keep[i];
+    }
+    return ret;
+  }
+  Addresses get_addresses() const {
+    return {this->user(47, 0), this->user(79, 48), this->user(95, 80)};
+  }
+  static ap_uint<AXIS_USER_WIDTH> to_user(const Addresses &addr) {
+    ap_uint<AXIS_USER_WIDTH> ret = 0;
     ret(95, 80) = addr.udp_port;
     ret(79, 48) = addr.ip_addr;
     ret(47, 0) = addr.mac_addr;
     return ret;
   }
+  VLANTag get_vlan() const {
+    return {this->user[USER_VLAN_BIT], this->user(USER_TCI_HIGH, USER_TCI_LOW)};
+  }
+  static void set_vlan(ap_uint<AXIS_USER_WIDTH> &user, const VLANTag &vlan) {
+    user[USER_VLAN_BIT] = vlan.tagged;
+    user(USER_TCI_HIGH, USER_TCI_LOW) = vlan.tci;
+  }
 };
 
-std::ostream &operator<<(std::ostream &os, const axis_word &word);
+// Single byte as handled by the protocol stages
+typedef axis_word_n<1> byte_word;
+// Word of the streams
+typedef axis_word_n<DATAPATH_BYTES> axis_word;
+
+template <int N>
+std::ostream &operator<<(std::ostream &os, const axis_word_n<N> &word);
 
 #endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BUFFER_WORD_HPP
+#define BUFFER_WORD_HPP
+#pragma once
+
+#include "axis_word.hpp"
+#include <ap_int.h>
+
+// Word of the frame buffers. The user field is the same for all words of a
+// frame, so it is passed once per frame next to the buffer instead.
+struct buffer_word {
+  ap_uint<8 * DATAPATH_BYTES> data;
+  ap_uint<DATAPATH_BYTES> keep;
+  ap_uint<1> last;
+  buffer_word() : data(0), keep(0), last(false) {}
+  buffer_word(const axis_word &word)
+      : data(word.data), keep(word.keep), last(word.last) {}
+  axis_word with_user(const ap_uint<AXIS_USER_WIDTH> &user) const {
+    return axis_word(this->data, this->keep, this->last, user);
+  }
+  ap_uint<8> get_byte(int i) const { return this->data(8 * i + 7, 8 * i); }
+};
+
+#endif
@@ -29,58 +29,18 @@
 
 #include "CRC32.hpp"
 
-ap_uint<32> crc32_preview(const ap_uint<8> &next,
-                          const ap_uint<32> &prev_crc32,
-                          const ap_uint<3> &add_cnt) {
+ap_uint<32> crc32_multiply(const ap_uint<32> &a, const ap_uint<32> &b) {
 #pragma HLS INLINE
 
-  ap_uint<32> c = prev_crc32;
-  ap_uint<8> d = next;
-  if (add_cnt < 4) {
-    d.b_not();
+  ap_uint<32> product = 0;
+  for (int i = 31; i >= 0; i--) {
+#pragma HLS UNROLL
+    product = crc32_next<1>(0, product);
+    if (b[i]) {
+      product ^= a;
+    }
   }
-  ap_uint<32> n;
-  n[0] = d[6] ^ d[0] ^ c[24] ^ c[30];
-  n[1] = d[7] ^ d[6] ^ d[1] ^ d[0] ^ c[24] ^ c[25] ^ c[30] ^ c[31];
-  n[2] =
-      d[7] ^ d[6] ^ d[2] ^ d[1] ^ d[0] ^ c[24] ^ c[25] ^ c[26] ^ c[30] ^ c[31];
-  n[3] = d[7] ^ d[3] ^ d[2] ^ d[1] ^ c[25] ^ c[26] ^ c[27] ^ c[31];
-  n[4] =
-      d[6] ^ d[4] ^ d[3] ^ d[2] ^ d[0] ^ c[24] ^ c[26] ^ c[27] ^ c[28] ^ c[30];
-  n[5] = d[7] ^ d[6] ^ d[5] ^ d[4] ^ d[3] ^ d[1] ^ d[0] ^ c[24] ^ c[25] ^
-         c[27] ^ c[28] ^ c[29] ^ c[30] ^ c[31];
-  n[6] = d[7] ^ d[6] ^ d[5] ^ d[4] ^ d[2] ^ d[1] ^ c[25] ^ c[26] ^ c[28] ^
-         c[29] ^ c[30] ^ c[31];
-  n[7] =
-      d[7] ^ d[5] ^ d[3] ^ d[2] ^ d[0] ^ c[24] ^ c[26] ^ c[27] ^ c[29] ^ c[31];
-  n[8] = d[4] ^ d[3] ^ d[1] ^ d[0] ^ c[0] ^ c[24] ^ c[25] ^ c[27] ^ c[28];
-  n[9] = d[5] ^ d[4] ^ d[2] ^ d[1] ^ c[1] ^ c[25] ^ c[26] ^ c[28] ^ c[29];
-  n[10] = d[5] ^ d[3] ^ d[2] ^ d[0] ^ c[2] ^ c[24] ^ c[26] ^ c[27] ^ c[29];
-  n[11] = d[4] ^ d[3] ^ d[1] ^ d[0] ^ c[3] ^ c[24] ^ c[25] ^ c[27] ^ c[28];
-  n[12] = d[6] ^ d[5] ^ d[4] ^ d[2] ^ d[1] ^ d[0] ^ c[4] ^ c[24] ^ c[25] ^
-          c[26] ^ c[28] ^ c[29] ^ c[30];
-  n[13] = d[7] ^ d[6] ^ d[5] ^ d[3] ^ d[2] ^ d[1] ^ c[5] ^ c[25] ^ c[26] ^
-          c[27] ^ c[29] ^ c[30] ^ c[31];
-  n[14] = d[7] ^ d[6] ^ d[4] ^ d[3] ^ d[2] ^ c[6] ^ c[26] ^ c[27] ^ c[28] ^
-          c[30] ^ c[31];
-  n[15] = d[7] ^ d[5] ^ d[4] ^ d[3] ^ c[7] ^ c[27] ^ c[28] ^ c[29] ^ c[31];
-  n[16] = d[5] ^ d[4] ^ d[0] ^ c[8] ^ c[24] ^ c[28] ^ c[29];
-  n[17] = d[6] ^ d[5] ^ d[1] ^ c[9] ^ c[25] ^ c[29] ^ c[30];
-  n[18] = d[7] ^ d[6] ^ d[2] ^ c[10] ^ c[26] ^ c[30] ^ c[31];
-  n[19] = d[7] ^ d[3] ^ c[11] ^ c[27] ^ c[31];
-  n[20] = d[4] ^ c[12] ^ c[28];
-  n[21] = d[5] ^ c[13] ^ c[29];
-  n[22] = d[0] ^ c[14] ^ c[24];
-  n[23] = d[6] ^ d[1] ^ d[0] ^ c[15] ^ c[24] ^ c[25] ^ c[30];
-  n[24] = d[7] ^ d[2] ^ d[1] ^ c[16] ^ c[25] ^ c[26] ^ c[31];
-  n[25] = d[3] ^ d[2] ^ c[17] ^ c[26] ^ c[27];
-  n[26] = d[6] ^ d[4] ^ d[3] ^ d[0] ^ c[18] ^ c[24] ^ c[27] ^ c[28] ^ c[30];
-  n[27] = d[7] ^ d[5] ^ d[4] ^ d[1] ^ c[19] ^ c[25] ^ c[28] ^ c[29] ^ c[31];
-  n[28] = d[6] ^ d[5] ^ d[2] ^ c[20] ^ c[26] ^ c[29] ^ c[30];
-  n[29] = d[7] ^ d[6] ^ d[3] ^ c[21] ^ c[27] ^ c[30] ^ c[31];
-  n[30] = d[7] ^ d[4] ^ c[22] ^ c[28] ^ c[31];
-  n[31] = d[5] ^ c[23] ^ c[29];
-  return n;
+  return product;
 }
 
 ap_uint<32> CRC32::get_value() const {
@@ -104,18 +64,10 @@ ap_uint<32> CRC32::get_value() const {
 void CRC32::add(const ap_uint<8> &next) {
 #pragma HLS INLINE
 
-  ap_uint<8> rev_next = next;
-  rev_next.reverse();
-  this->accumulator = crc32_preview(rev_next, this->accumulator, this->add_cnt);
-  if (this->add_cnt < 4) {
-    this->add_cnt++;
-  }
+  this->accumulator = crc32_next<8>(next, this->accumulator);
 }
 
-void CRC32::reset() {
-  IChecksum::reset();
-  this->add_cnt = 0;
-}
+void CRC32::reset() { this->accumulator = CRC32_INIT; }
 
 ap_uint<32> CRC32::operator()(int high, int low) {
   ap_uint<32> checksum = this->get_value();
@@ -31,27 +31,95 @@
 #define CHECKSUMS_CRC32_HPP
 #pragma once
 
+#include "../bit_width.hpp"
 #include "IChecksum.hpp"
 #include <ap_int.h>
 
+const ap_uint<32> CRC32_POLYNOMIAL = 0x04C11DB7;
+const ap_uint<32> CRC32_INIT = 0xFFFFFFFF;
 const ap_uint<32> CRC32_RESIDUE = 0x1CDF4421;
 const ap_uint<32> CRC32_RESIDUE_INV_BREV = 0xC704DD7B;
 
-ap_uint<32> crc32_preview(const ap_uint<8> &next,
-                          const ap_uint<32> &prev_crc32,
-                          const ap_uint<3> &add_cnt);
+// Returns the CRC register after W more bits of data, lowest bit first as
+// they are sent on the wire. The loop is unrolled, so synthesis reduces it to
+// the XOR matrix of a W bit wide input.
+template <int W>
+ap_uint<32> crc32_next(const ap_uint<W> &data, const ap_uint<32> &crc) {
+#pragma HLS INLINE
+
+  ap_uint<32> c = crc;
+  for (int i = 0; i < W; i++) {
+#pragma HLS UNROLL
+    ap_uint<1> feedback = c[31] ^ data[i];
+    c <<= 1;
+    if (feedback) {
+      c ^= CRC32_POLYNOMIAL;
+    }
+  }
+  return c;
+}
+
+// Product of two registers modulo the polynomial
+ap_uint<32> crc32_multiply(const ap_uint<32> &a, const ap_uint<32> &b);
+
+// Returns the CRC register after num_bytes more zero bytes. The powers of x
+// only depend on the loop index, so every step is a constant XOR matrix.
+template <int L>
+ap_uint<32> crc32_shift(const ap_uint<32> &crc, const ap_uint<L> &num_bytes) {
+#pragma HLS INLINE
+
+  ap_uint<32> c = crc;
+  ap_uint<32> power = 0x100; // x^8
+  for (int i = 0; i < L; i++) {
+#pragma HLS UNROLL
+    if (num_bytes[i]) {
+      c = crc32_multiply(c, power);
+    }
+    power = crc32_multiply(power, power);
+  }
+  return c;
+}
+
+// Merges the register of data A with the register of data B, which has been
+// computed starting from zero, into the register of A followed by B.
+template <int L>
+ap_uint<32> crc32_combine(const ap_uint<32> &crc_a,
+                          const ap_uint<32> &crc_b,
+                          const ap_uint<L> &len_b) {
+#pragma HLS INLINE
+
+  return crc32_shift(crc_a, len_b) ^ crc_b;
+}
 
 class CRC32 : public IChecksum<32, 32> {
 public:
-  CRC32() : IChecksum(), add_cnt(0){};
+  CRC32() : IChecksum(CRC32_INIT){};
   ap_uint<32> get_value() const;
   void add(const ap_uint<8> &next);
+  template <int N>
+  void add(const ap_uint<8 * N> &data, const ap_uint<N> &keep);
   void reset();
   ap_uint<32> operator()(int high, int low);
   ap_uint<1> operator==(const ap_uint<32> &value);
-
-private:
-  ap_uint<3> add_cnt;
 };
 
+// Adds the bytes of all lanes set in keep, which have to be the lowest lanes.
+// The bytes are moved to the top lanes, so the zeros in front of them do not
+// change a register starting from zero, and are combined with the register.
+template <int N>
+void CRC32::add(const ap_uint<8 * N> &data, const ap_uint<N> &keep) {
+#pragma HLS INLINE
+
+  ap_uint<bit_width<N>::value> num_bytes = 0;
+  for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+    if (keep[i]) {
+      num_bytes++;
+    }
+  }
+  ap_uint<8 * N> aligned = data << (8 * (N - num_bytes));
+  this->accumulator = crc32_combine(
+      this->accumulator, crc32_next<8 * N>(aligned, 0), num_bytes);
+}
+
 #endif
@@ -30,26 +30,26 @@
 #include "Checksum.hpp"
 
 ap_uint<16> Checksum::get_value() const {
-  ap_uint<16> ret = accumulator(26, 16) + accumulator(15, 0);
+  ap_uint<16> ret = this->get_sum();
   ret.b_not();
   return ret;
 }
 
+ap_uint<16> Checksum::get_sum() const {
+  ap_uint<CHECKSUM_WIDTH> sum = this->accumulator;
+  for (int i = 16; i < CHECKSUM_WIDTH; i += 16) {
+#pragma HLS UNROLL
+    sum = sum(15, 0) + (sum >> 16);
+  }
+  return sum(15, 0) + (sum >> 16);
+}
+
 void Checksum::add(const ap_uint<16> &next) { this->accumulator += next; }
 
 void Checksum::add(const Checksum &other) {
   this->accumulator += other.accumulator;
 }
 
-void Checksum::add_half(const ap_uint<8> &next) {
-  ap_uint<16> full_next = next;
-  if (this->next_byte_high) {
-    full_next <<= 8;
-  }
-  this->add(full_next);
-  this->next_byte_high = !this->next_byte_high;
-}
-
 void Checksum::reset() {
   IChecksum::reset();
   this->next_byte_high = true;
@@ -31,18 +31,29 @@
 #define CHECKSUMS_CHECKSUM_HPP
 #pragma once
 
+#include "../bit_width.hpp"
+#include "../frame_size.hpp"
 #include "IChecksum.hpp"
 #include <ap_int.h>
 
-// log2((16^4 - 1) * 1536) = 26,5... = 27 Maximum number of bits of maximum sum
-class Checksum : public IChecksum<16, 27> {
+// Maximum number of bytes summed up into one checksum
+const unsigned long long CHECKSUM_MAX_BYTES = MAX_FRAME_BYTES;
+
+// Every byte adds at most one 16 bit word, so the sum of a frame fits into
+// this many bits and only has to be folded once the value is needed.
+const int CHECKSUM_WIDTH = bit_width<0xFFFF * CHECKSUM_MAX_BYTES>::value;
+
+class Checksum : public IChecksum<16, CHECKSUM_WIDTH> {
 public:
   Checksum() : IChecksum(), next_byte_high(true){};
-  Checksum(const ap_uint<27> &accu) : IChecksum(accu), next_byte_high(true) {}
+  Checksum(const ap_uint<CHECKSUM_WIDTH> &accu)
+      : IChecksum(accu), next_byte_high(true) {}
   ap_uint<16> get_value() const;
+  ap_uint<16> get_sum() const;
   void add(const ap_uint<16> &next);
   void add(const Checksum &other);
-  void add_half(const ap_uint<8> &next);
+  template <int N>
+  void add(const ap_uint<8 * N> &data, const ap_uint<N> &keep);
   void reset();
   ap_uint<16> operator()(int high, int low) const;
   ap_uint<1> operator==(const ap_uint<16> &other) const;
@@ -53,4 +64,31 @@ private:
   ap_uint<1> next_byte_high;
 };
 
+// Adds the bytes of all lanes set in keep as continuation of the bytes added
+// before, so a word may start with the low byte of a 16 bit word. High and
+// low bytes are summed up separately and added to the accumulator once.
+template <int N>
+void Checksum::add(const ap_uint<8 * N> &data, const ap_uint<N> &keep) {
+#pragma HLS INLINE
+
+  ap_uint<8 + bit_width<N>::value> high_sum = 0;
+  ap_uint<8 + bit_width<N>::value> low_sum = 0;
+  ap_uint<1> byte_high = this->next_byte_high;
+  for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+    if (keep[i]) {
+      ap_uint<8> next = data(8 * i + 7, 8 * i);
+      if (byte_high) {
+        high_sum += next;
+      } else {
+        low_sum += next;
+      }
+      byte_high = !byte_high;
+    }
+  }
+  ap_uint<CHECKSUM_WIDTH> full_high_sum = high_sum;
+  this->accumulator += (full_high_sum << 8) + low_sum;
+  this->next_byte_high = byte_high;
+}
+
 #endif
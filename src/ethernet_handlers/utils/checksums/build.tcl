@@ -0,0 +1,36 @@
+set design_files {
+  crc32_engine.cpp
+  CRC32.cpp
+  ../axis_word.cpp
+}
+set tb_files {
+  crc32_engine_test.cpp
+  ../test/ETHPacket.cpp
+  ../Addresses.cpp
+}
+
+# Project name and compiler flags of every variant
+set variants {
+  crc32_engine {}
+  crc32_engine_4byte {-DDATAPATH_BYTES=4}
+  crc32_engine_8byte {-DDATAPATH_BYTES=8}
+  crc32_engine_16byte {-DDATAPATH_BYTES=16}
+}
+
+foreach {proj_name cflags} $variants {
+  open_project proj_$proj_name -reset
+  set_top crc32_engine
+  foreach file $design_files {
+    add_files $file -cflags $cflags
+  }
+  foreach file $tb_files {
+    add_files -tb $file -cflags $cflags
+  }
+  open_solution "solution1"
+  set_part {xc7a100tcsg324-1}
+  create_clock -period 20 -name default
+  set_clock_uncertainty 1
+  config_rtl -module_auto_prefix -reset all -reset_level high
+  csim_design
+  csynth_design
+}
@@ -27,33 +27,22 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "PayloadWordGenerator.hpp"
+#include "crc32_engine.hpp"
 
-axis_word PayloadWordGenerator::get_next_word(hls::stream<axis_word> &buffer) {
-#pragma HLS INLINE
+void crc32_engine(hls::stream<axis_word> &data_in,
+                  hls::stream<ap_uint<32> > &fcs_out) {
+#pragma HLS INTERFACE axis port = data_in
+#pragma HLS INTERFACE axis port = fcs_out
+#pragma HLS PIPELINE II = 1
 
-  axis_word word;
-  switch (state) {
-  case READING_BUFFER:
-    buffer.read(word);
+  static CRC32 fcs;
+
+  if (!data_in.empty()) {
+    axis_word word = data_in.read();
+    fcs.add<DATAPATH_BYTES>(word.data, word.keep);
     if (word.last) {
-      if (word_cnt >= min_payload_byte_size - 1) {
-        return counted(word.data, word_cnt, true);
-      }
-      state = FILLING_OUTPUT;
+      fcs_out.write(fcs.get_value());
+      fcs.reset();
     }
-    return counted(word.data, word_cnt);
-    break;
-  case FILLING_OUTPUT:
-    return counted(0, word_cnt, word_cnt == min_payload_byte_size - 1);
-    break;
-  default:
-    return {true, 0, 0};
-    break;
   }
 }
-
-void PayloadWordGenerator::reset() {
-  word_cnt = 0;
-  state = READING_BUFFER;
-}
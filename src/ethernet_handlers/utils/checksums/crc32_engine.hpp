@@ -27,24 +27,17 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef DATA_GATE_HPP
-#define DATA_GATE_HPP
+#ifndef CHECKSUMS_CRC32_ENGINE_HPP
+#define CHECKSUMS_CRC32_ENGINE_HPP
 #pragma once
 
-#include "../utils/axis_word.hpp"
+#include "../axis_word.hpp"
+#include "CRC32.hpp"
 #include <ap_int.h>
 #include <hls_stream.h>
 
-class DataGate {
-public:
-  DataGate() : working(false) {}
-  void handle(hls::stream<axis_word> &data_buffer,
-              hls::stream<ap_uint<1> > &valid_buffer,
-              hls::stream<axis_word> &data_out);
-
-private:
-  ap_uint<1> working;
-  ap_uint<1> sending;
-};
+// Computes the FCS of every frame on data_in at one word per cycle
+void crc32_engine(hls::stream<axis_word> &data_in,
+                  hls::stream<ap_uint<32> > &fcs_out);
 
 #endif
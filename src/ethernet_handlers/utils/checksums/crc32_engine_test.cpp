@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "../test/Comparison.hpp"
+#include "../test/ETHPacket.hpp"
+#include "../test/ITest.hpp"
+#include "../test/InputStreamFeed.hpp"
+#include "../test/OutputStreamStore.hpp"
+#include "../test/TimedValue.hpp"
+#include "../test/pack_words.hpp"
+#include "crc32_engine.hpp"
+#include <ap_int.h>
+#include <string>
+#include <vector>
+
+class CRC32EngineTest : public ITest {
+public:
+  InputStreamFeed<axis_word> data_in_feed;
+  OutputStreamStore<ap_uint<32> > fcs_out_store;
+  CRC32EngineTest(const std::string &title,
+                  const std::vector<TimedValue<byte_word> > &data_in_tv,
+                  const std::vector<TimedValue<ap_uint<32> > > &fcs_out_tv)
+      : ITest(title), data_in_feed(pack_words(data_in_tv)),
+        fcs_out_store("FCS", fcs_out_tv, 1) {}
+  void feed_inputs(int step_index) override {
+    this->data_in_feed.feed(step_index);
+  }
+  void store_outputs(int step_index) override {
+    this->fcs_out_store.store(step_index);
+  }
+
+private:
+  std::vector<Comparison> get_comparisons() override {
+    return {this->fcs_out_store.get_comparison()};
+  }
+};
+
+// Feeds one word per cycle and expects the FCS in the cycle of the last word
+CRC32EngineTest frame_test(const std::string &title, int num_bytes) {
+  std::vector<ap_uint<8> > bytes;
+  std::vector<TimedValue<byte_word> > data_in;
+  for (int i = 0; i < num_bytes; i++) {
+    bytes.push_back((i * 37 + num_bytes) & 0xFF);
+    data_in.push_back(
+        {i / DATAPATH_BYTES, {bytes[i], i == num_bytes - 1, 0}});
+  }
+  return CRC32EngineTest(
+      title,
+      data_in,
+      {{(num_bytes - 1) / DATAPATH_BYTES, calculate_fcs(bytes)}});
+}
+
+int main() {
+  const int NUM_CYCLES = 1600;
+  std::vector<CRC32EngineTest> tests;
+  int errors = 0;
+
+  tests.push_back(frame_test("Minimum frame", 60));
+  tests.push_back(frame_test("Odd length frame", 61));
+  tests.push_back(frame_test("Frame ending in third lane", 67));
+  tests.push_back(frame_test("Maximum frame", 1514));
+
+  for (int i = 0; i < tests.size(); i++) {
+    for (int j = 0; j < NUM_CYCLES; j++) {
+      tests[i].feed_inputs(j);
+      crc32_engine(tests[i].data_in_feed.stream,
+                   tests[i].fcs_out_store.stream);
+      tests[i].store_outputs(j);
+    }
+    errors += tests[i].get_result();
+  }
+  return errors;
+}
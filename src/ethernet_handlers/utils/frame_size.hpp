@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FRAME_SIZE_HPP
+#define FRAME_SIZE_HPP
+#pragma once
+
+#include "bit_width.hpp"
+
+// Largest Ethernet frame from the destination MAC address to the frame check
+// sequence, 1518 bytes for standard frames and up to 9018 bytes for jumbo
+// frames. The lengths, counters and checksum accumulators over a frame and the
+// frame buffers are all sized from it.
+#ifndef MAX_FRAME_BYTES
+#define MAX_FRAME_BYTES 1518
+#endif
+
+#if MAX_FRAME_BYTES < 1518 || MAX_FRAME_BYTES > 9018
+#error "MAX_FRAME_BYTES has to be between 1518 and 9018"
+#endif
+
+// Largest IP packet and UDP payload such a frame carries
+const int MAX_IP_PACKET_BYTES = MAX_FRAME_BYTES - 18;
+const int MAX_UDP_PAYLOAD_BYTES = MAX_IP_PACKET_BYTES - 28;
+
+const int FRAME_LENGTH_WIDTH = bit_width<MAX_FRAME_BYTES>::value;
+
+#endif
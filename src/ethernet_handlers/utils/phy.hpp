@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PHY_HPP
+#define PHY_HPP
+#pragma once
+
+#include <ap_int.h>
+
+// With PHY_GMII set, eth_in and eth_out are attached to a GMII PHY, which
+// moves a byte per cycle of its 125 MHz clock. Otherwise they are attached to
+// an RMII PHY, which moves a bit pair per cycle of its 50 MHz clock. Either
+// way the least significant bits of a byte come first, rxd and txd carry a
+// symbol of PHY_DATA_WIDTH bits, crsdv stands for RX_DV, rxerr for RX_ER and
+// txen for TX_EN of GMII.
+#ifndef PHY_GMII
+#define PHY_GMII 0
+#endif
+
+#if PHY_GMII
+#define PHY_CLOCK_HZ 125000000
+const int PHY_DATA_WIDTH = 8;
+#else
+#define PHY_CLOCK_HZ 50000000
+const int PHY_DATA_WIDTH = 2;
+#endif
+
+// Cycles a byte takes on the PHY interface
+const int PHY_CYCLES_PER_BYTE = 8 / PHY_DATA_WIDTH;
+
+typedef ap_uint<PHY_DATA_WIDTH> phy_data;
+
+// The preamble is made up of symbols 0x55, a bit pair 01 on RMII, up to the
+// last one, which is the start frame delimiter 0xD5, a bit pair 11 on RMII.
+const phy_data PREAMBLE_SYMBOL = 0x55 & ((1 << PHY_DATA_WIDTH) - 1);
+const phy_data SFD_SYMBOL = 0xD5 >> (8 - PHY_DATA_WIDTH);
+const int PREAMBLE_SYMBOLS = 8 * PHY_CYCLES_PER_BYTE;
+
+// Symbols 0x55 the start frame delimiter has to follow at least. A GMII PHY
+// may pass on a shortened preamble, so a single byte of it will do.
+#if PHY_GMII
+const int MIN_PREAMBLE_SYMBOLS = 1;
+#else
+const int MIN_PREAMBLE_SYMBOLS = PREAMBLE_SYMBOLS - 1;
+#endif
+
+#endif
@@ -37,10 +37,24 @@
 const uint16_t ARP = 0x0806;
 const uint16_t IPv4 = 0x0800;
 const uint16_t IPv6 = 0x86DD;
+const uint16_t VLAN = 0x8100; // 802.1Q tag, followed by TCI and EtherType
+const uint64_t BROADCAST_MAC_ADDR = 0xFFFFFFFFFFFF;
+
+// ARP for IPv4 over Ethernet
+const uint64_t ARP_IPV4_OVER_ETHERNET = 0x000108000604; // HTYPE to PLEN
+const uint16_t ARP_REQUEST = 0x1;
+const uint16_t ARP_REPLY = 0x2;
+const int ARP_PKT_BYTE_SIZE = 28;
 
 // IPv4
 const uint8_t ICMP = 0x1;
 const uint8_t TCP = 0x6;
 const uint8_t UDP = 0x11;
+const uint16_t IP_MORE_FRAGMENTS = 0x2000;
+const uint16_t IP_FRAGMENT_OFFSET = 0x1FFF; // In units of 8 bytes
+
+// ICMP
+const uint8_t ICMP_ECHO_REPLY = 0x0;
+const uint8_t ICMP_ECHO_REQUEST = 0x8;
 
 #endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TEST_ARP_FRAME_HPP
+#define TEST_ARP_FRAME_HPP
+#pragma once
+
+#include "../Addresses.hpp"
+#include "../VLANTag.hpp"
+#include "../protocols.hpp"
+#include "ARPPacket.hpp"
+#include "ETHFrame.hpp"
+#include <ap_int.h>
+
+// Requests are broadcast and leave the MAC address of the target open
+class ARPFrame : public ETHFrame {
+public:
+  ARPFrame(const ap_uint<16> &operation,
+           const Addresses &sender,
+           const Addresses &target,
+           const VLANTag &vlan = VLANTag())
+      : ETHFrame(sender,
+                 eth_dst(operation, target),
+                 ARP,
+                 ARPPacket(operation, sender, arp_target(operation, target)),
+                 vlan) {}
+
+private:
+  static Addresses eth_dst(const ap_uint<16> &operation,
+                           const Addresses &target) {
+    return operation == ARP_REQUEST
+               ? Addresses(BROADCAST_MAC_ADDR, target.ip_addr, 0)
+               : target;
+  }
+  static Addresses arp_target(const ap_uint<16> &operation,
+                              const Addresses &target) {
+    return operation == ARP_REQUEST ? Addresses(0, target.ip_addr, 0) : target;
+  }
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ARPPacket.hpp"
+
+std::vector<ap_uint<8> > ARPPacket::compute_bytes(const ap_uint<16> &operation,
+                                                  const Addresses &sender,
+                                                  const Addresses &target) {
+  return {0x00,
+          0x01,
+          0x08,
+          0x00,
+          0x06,
+          0x04,
+          operation(15, 8),
+          operation(7, 0),
+          sender.mac_addr(47, 40),
+          sender.mac_addr(39, 32),
+          sender.mac_addr(31, 24),
+          sender.mac_addr(23, 16),
+          sender.mac_addr(15, 8),
+          sender.mac_addr(7, 0),
+          sender.ip_addr(31, 24),
+          sender.ip_addr(23, 16),
+          sender.ip_addr(15, 8),
+          sender.ip_addr(7, 0),
+          target.mac_addr(47, 40),
+          target.mac_addr(39, 32),
+          target.mac_addr(31, 24),
+          target.mac_addr(23, 16),
+          target.mac_addr(15, 8),
+          target.mac_addr(7, 0),
+          target.ip_addr(31, 24),
+          target.ip_addr(23, 16),
+          target.ip_addr(15, 8),
+          target.ip_addr(7, 0)};
+}
@@ -32,6 +32,7 @@
 #pragma once
 
 #include "../Addresses.hpp"
+#include "../VLANTag.hpp"
 #include "ETHPacket.hpp"
 #include "Frame.hpp"
 #include <ap_int.h>
@@ -42,8 +43,9 @@ public:
   ETHFrame(const Addresses &src,
            const Addresses &dst,
            const ap_uint<16> &ether_type,
-           const std::vector<ap_uint<8> > &payload)
-      : Frame(ETHPacket(src, dst, ether_type, payload)) {}
+           const std::vector<ap_uint<8> > &payload,
+           const VLANTag &vlan = VLANTag())
+      : Frame(ETHPacket(src, dst, ether_type, payload, vlan)) {}
 };
 
 #endif
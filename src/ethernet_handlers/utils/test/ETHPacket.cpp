@@ -63,7 +63,8 @@ std::vector<ap_uint<8> >
 ETHPacket::compute_bytes(const Addresses src,
                          const Addresses dst,
                          const ap_uint<16> ether_type,
-                         const std::vector<ap_uint<8> > payload) {
+                         const std::vector<ap_uint<8> > payload,
+                         const VLANTag vlan) {
   std::vector<ap_uint<8> > header{dst.mac_addr(47, 40),
                                   dst.mac_addr(39, 32),
                                   dst.mac_addr(31, 24),
@@ -75,13 +76,19 @@ ETHPacket::compute_bytes(const Addresses src,
                                   src.mac_addr(31, 24),
                                   src.mac_addr(23, 16),
                                   src.mac_addr(15, 8),
-                                  src.mac_addr(7, 0),
-                                  ether_type(15, 8),
-                                  ether_type(7, 0)};
+                                  src.mac_addr(7, 0)};
+  // Tagged frames keep the minimum size once the tag is removed
+  int min_size = 60;
+  if (vlan.tagged) {
+    header.insert(header.end(),
+                  {VLAN >> 8, VLAN & 0xFF, vlan.tci(15, 8), vlan.tci(7, 0)});
+    min_size += 4;
+  }
+  header.insert(header.end(), {ether_type(15, 8), ether_type(7, 0)});
 
   std::vector<ap_uint<8> > packet(header);
   packet.insert(packet.end(), payload.begin(), payload.end());
-  while (packet.size() < 60) {
+  while (packet.size() < min_size) {
     packet.push_back(0);
   }
 
@@ -32,24 +32,30 @@
 #pragma once
 
 #include "../Addresses.hpp"
+#include "../VLANTag.hpp"
+#include "../protocols.hpp"
 #include "Packet.hpp"
 #include <ap_int.h>
 #include <vector>
 
+ap_uint<32> calculate_fcs(std::vector<ap_uint<8> > bytes);
+
 class ETHPacket : public Packet {
 public:
   ETHPacket(const Addresses src,
             const Addresses dst,
             const ap_uint<16> ether_type,
-            const std::vector<ap_uint<8> > payload)
-      : Packet(compute_bytes(src, dst, ether_type, payload)) {}
+            const std::vector<ap_uint<8> > payload,
+            const VLANTag vlan = VLANTag())
+      : Packet(compute_bytes(src, dst, ether_type, payload, vlan)) {}
 
 private:
   static std::vector<ap_uint<8> >
   compute_bytes(const Addresses src,
                 const Addresses dst,
                 const ap_uint<16> ether_type,
-                const std::vector<ap_uint<8> > payload);
+                const std::vector<ap_uint<8> > payload,
+                const VLANTag vlan);
 };
 
 #endif
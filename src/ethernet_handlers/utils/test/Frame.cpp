@@ -44,3 +44,15 @@ Frame::operator std::vector<ap_uint<8> >() const {
   out.insert(out.end(), this->bytes.begin(), this->bytes.end());
   return out;
 };
+
+std::vector<phy_data> to_phy_data(const std::vector<ap_uint<2> > &bit_pairs) {
+  std::vector<phy_data> out;
+  for (int i = 0; i < bit_pairs.size(); i += PHY_DATA_WIDTH / 2) {
+    phy_data symbol = 0;
+    for (int j = 0; j < PHY_DATA_WIDTH / 2; j++) {
+      symbol(2 * j + 1, 2 * j) = bit_pairs[i + j];
+    }
+    out.push_back(symbol);
+  }
+  return out;
+}
@@ -31,12 +31,13 @@
 #define TEST_FRAME_HPP
 #pragma once
 
+#include "../phy.hpp"
 #include "Packet.hpp"
 #include <ap_int.h>
 #include <vector>
 
 const std::vector<ap_uint<8> > PREAMBLE_SFD_BYTES{
-    0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAB};
+    0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xD5};
 
 const std::vector<ap_uint<2> > PREAMBLE_SFD_BIT_PAIRS{
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
@@ -49,4 +50,8 @@ public:
   operator std::vector<ap_uint<2> >() const;
 };
 
+// Groups bit pairs into the symbols of the PHY, the least significant bits
+// first. A frame converts to std::vector<phy_data> directly.
+std::vector<phy_data> to_phy_data(const std::vector<ap_uint<2> > &bit_pairs);
+
 #endif
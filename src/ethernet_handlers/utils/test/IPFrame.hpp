@@ -43,9 +43,13 @@ public:
           const Addresses &dst,
           const ap_uint<8> &ip_protocol,
           const std::vector<ap_uint<8> > &payload,
-          ap_uint<16> id = 0)
+          ap_uint<16> id = 0,
+          ap_uint<16> flags_and_offset = 0)
       : ETHFrame(
-            src, dst, 0x0800, IPPacket(src, dst, ip_protocol, payload, id)) {}
+            src,
+            dst,
+            0x0800,
+            IPPacket(src, dst, ip_protocol, payload, id, flags_and_offset)) {}
 };
 
 #endif
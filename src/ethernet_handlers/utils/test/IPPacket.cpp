@@ -34,7 +34,8 @@ IPPacket::compute_bytes(const Addresses &src,
                         const Addresses &dst,
                         const ap_uint<8> &ip_protocol,
                         const std::vector<ap_uint<8> > &payload,
-                        ap_uint<16> id) {
+                        ap_uint<16> id,
+                        ap_uint<16> flags_and_offset) {
   ap_uint<16> packet_length = payload.size() + 20;
   ap_uint<8> version_ihl = 0x45;
 
@@ -44,8 +45,8 @@ IPPacket::compute_bytes(const Addresses &src,
                                               packet_length(7, 0),
                                               id(15, 8),
                                               id(7, 0),
-                                              0,
-                                              0,
+                                              flags_and_offset(15, 8),
+                                              flags_and_offset(7, 0),
                                               0x80,
                                               ip_protocol,
                                               0,
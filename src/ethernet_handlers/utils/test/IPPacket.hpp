@@ -43,8 +43,10 @@ public:
            const Addresses &dst,
            const ap_uint<8> &ip_protocol,
            const std::vector<ap_uint<8> > &payload,
-           ap_uint<16> id = 0)
-      : Packet(compute_bytes(src, dst, ip_protocol, payload, id)) {}
+           ap_uint<16> id = 0,
+           ap_uint<16> flags_and_offset = 0)
+      : Packet(compute_bytes(
+            src, dst, ip_protocol, payload, id, flags_and_offset)) {}
 
 private:
   static std::vector<ap_uint<8> >
@@ -52,7 +54,8 @@ private:
                 const Addresses &dst,
                 const ap_uint<8> &ip_protocol,
                 const std::vector<ap_uint<8> > &payload,
-                ap_uint<16> id);
+                ap_uint<16> id,
+                ap_uint<16> flags_and_offset);
 };
 
 #endif
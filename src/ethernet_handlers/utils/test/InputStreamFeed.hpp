@@ -48,7 +48,7 @@ public:
   void feed(int index) override {
     for (int i = 0; i < this->values.size(); i++) {
       if (this->values[i].index == index) {
-        this->stream.write(this->values[index].value);
+        this->stream.write(this->values[i].value);
         break;
       }
     }
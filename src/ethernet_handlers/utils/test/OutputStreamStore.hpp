@@ -43,18 +43,32 @@ class OutputStreamStore : public OutputStore<TimedValue<T> >,
 public:
   OutputStreamStore(std::string name,
                     std::vector<TimedValue<T> > refs,
-                    int print_group_size)
-      : OutputStore<TimedValue<T> >(name, refs, print_group_size),
-        StreamContainer<T>() {}
+                    int print_group_size,
+                    bool timed = true)
+      : OutputStore<TimedValue<T> >(
+            name, timed ? refs : untimed(refs), print_group_size),
+        StreamContainer<T>(), timed(timed) {}
   OutputStreamStore(OutputStreamStore<T> &&other)
-      : OutputStore<TimedValue<T> >(std::move(other)), StreamContainer<T>(
-                                                           std::move(other)) {}
+      : OutputStore<TimedValue<T> >(std::move(other)),
+        StreamContainer<T>(std::move(other)), timed(other.timed) {}
   void store(int index) override {
     if (!this->stream.empty()) {
       T value = this->stream.read();
-      this->values.push_back({index, value});
+      this->values.push_back({this->timed ? index : 0, value});
     }
   }
+
+private:
+  // Untimed stores only check the order of the values
+  bool timed;
+  static std::vector<TimedValue<T> >
+  untimed(const std::vector<TimedValue<T> > &refs) {
+    std::vector<TimedValue<T> > ret(refs);
+    for (int i = 0; i < ret.size(); i++) {
+      ret[i].index = 0;
+    }
+    return ret;
+  }
 };
 
 #endif
@@ -42,8 +42,13 @@ public:
   UDPFrame(const Addresses &src,
            const Addresses &dst,
            const std::vector<ap_uint<8> > &payload,
-           ap_uint<16> id = 0)
-      : IPFrame(src, dst, 0x11, UDPPacket(src, dst, payload), id) {}
+           ap_uint<16> id = 0,
+           bool with_checksum = true)
+      : IPFrame(src,
+                dst,
+                0x11,
+                UDPPacket(src, dst, payload, with_checksum),
+                id) {}
 };
 
 #endif
@@ -32,7 +32,8 @@
 std::vector<ap_uint<8> >
 UDPPacket::compute_bytes(const Addresses &src,
                          const Addresses &dst,
-                         const std::vector<ap_uint<8> > &payload) {
+                         const std::vector<ap_uint<8> > &payload,
+                         bool with_checksum) {
   ap_uint<16> packet_length = payload.size() + 8;
   std::vector<ap_uint<8> > pseudo_header{src.ip_addr(31, 24),
                                          src.ip_addr(23, 16),
@@ -58,6 +59,9 @@ UDPPacket::compute_bytes(const Addresses &src,
 
   std::vector<ap_uint<8> > packet(header_no_checksum);
   packet.insert(packet.end(), payload.begin(), payload.end());
+  if (!with_checksum) {
+    return packet;
+  }
 
   std::vector<ap_uint<8> > checksum_target(pseudo_header);
   checksum_target.insert(checksum_target.end(), packet.begin(), packet.end());
@@ -41,14 +41,16 @@ class UDPPacket : public Packet {
 public:
   UDPPacket(const Addresses &src,
             const Addresses &dst,
-            const std::vector<ap_uint<8> > &payload)
-      : Packet(compute_bytes(src, dst, payload)) {}
+            const std::vector<ap_uint<8> > &payload,
+            bool with_checksum = true)
+      : Packet(compute_bytes(src, dst, payload, with_checksum)) {}
 
 private:
   static std::vector<ap_uint<8> >
   compute_bytes(const Addresses &src,
                 const Addresses &dst,
-                const std::vector<ap_uint<8> > &payload);
+                const std::vector<ap_uint<8> > &payload,
+                bool with_checksum);
 };
 
 #endif
@@ -58,7 +58,10 @@ ap_uint<16> calculate_checksum(std::vector<ap_uint<8> > bytes) {
   extended_to_even_byte_num(bytes);
   std::vector<ap_uint<16> > byte_pairs = group_to_byte_pairs(bytes);
   ap_uint<32> summed = sum(byte_pairs);
-  ap_uint<16> folded = summed(31, 16) + summed(15, 0);
-  ap_uint<16> inverted = folded ^ 0xFFFF;
+  // Folding may carry again, so it is repeated until no carry is left
+  while (summed(31, 16) != 0) {
+    summed = summed(31, 16) + summed(15, 0);
+  }
+  ap_uint<16> inverted = summed(15, 0) ^ 0xFFFF;
   return inverted;
 }
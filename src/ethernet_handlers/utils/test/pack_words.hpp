@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TEST_PACK_WORDS_HPP
+#define TEST_PACK_WORDS_HPP
+#pragma once
+
+#include "../axis_word.hpp"
+#include "TimedValue.hpp"
+#include <vector>
+
+// Packs single bytes into stream words. A word starts a new frame after a
+// byte with last set and takes the index of its first byte and the user
+// field of its last byte.
+inline std::vector<TimedValue<axis_word> >
+pack_words(const std::vector<TimedValue<byte_word> > &bytes) {
+  std::vector<TimedValue<axis_word> > words;
+  int num_bytes = 0;
+  for (int i = 0; i < bytes.size(); i++) {
+    if (num_bytes == 0) {
+      words.push_back({bytes[i].index, axis_word(0, 0, false, 0)});
+    }
+    axis_word &word = words.back().value;
+    word.set_byte(num_bytes, bytes[i].value.data);
+    word.keep[num_bytes] = 1;
+    word.last = bytes[i].value.last;
+    word.user = bytes[i].value.user;
+    num_bytes++;
+    if (num_bytes == DATAPATH_BYTES || word.last) {
+      num_bytes = 0;
+    }
+  }
+  return words;
+}
+
+// Packs single bytes into stream words that are read out back to back. The
+// words of a frame follow each other cycle by cycle from the index of the
+// first byte of the frame on.
+inline std::vector<TimedValue<axis_word> >
+pack_read_out_words(const std::vector<TimedValue<byte_word> > &bytes) {
+  std::vector<TimedValue<axis_word> > words = pack_words(bytes);
+  for (int i = 1; i < words.size(); i++) {
+    if (!words[i - 1].value.last) {
+      words[i].index = words[i - 1].index + 1;
+    }
+  }
+  return words;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020, Peter Lehnhardt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TEST_REPORT_HPP
+#define TEST_REPORT_HPP
+#pragma once
+
+#include "color_codes.hpp"
+#include <ap_int.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Prints the result of a test checked outside of an ITest the way an ITest
+// does, followed by note unless it is empty. Returns the number of errors.
+inline int
+report(const std::string &title, bool passed, const std::string &note = "") {
+  if (passed) {
+    std::cout << FG_GREEN << title << ": PASSED" << FG_WHITE;
+  } else {
+    std::cout << FG_RED << title << ": FAILED" << FG_WHITE;
+  }
+  if (!note.empty()) {
+    std::cout << " (" << note << ")";
+  }
+  std::cout << std::endl;
+  return passed ? 0 : 1;
+}
+
+// Names the first counter that differs from its expected value, empty if all
+// match
+inline std::string
+counter_mismatch(const std::vector<ap_uint<64> > &values,
+                 const std::vector<ap_uint<64> > &expected) {
+  for (size_t i = 0; i < expected.size(); i++) {
+    ap_uint<64> value = i < values.size() ? values[i] : ap_uint<64>(0);
+    if (value != expected[i]) {
+      return "counter " + std::to_string(i) + " is " +
+             std::to_string(value.to_uint64()) + " instead of " +
+             std::to_string(expected[i].to_uint64());
+    }
+  }
+  return "";
+}
+
+#endif